@@ -206,6 +206,10 @@
 #include "filesystem/posix/PosixDirectory.h"
 #endif
 
+#ifdef HAVE_INOTIFY
+#include "linux/LibraryWatcher.h"
+#endif
+
 #if defined(TARGET_ANDROID)
 #include <androidjni/Build.h>
 #include "platform/android/activity/XBMCApp.h"
@@ -1893,10 +1897,10 @@ void CApplication::Render()
 
   g_Windowing.EndRender();
 
-  // reset our info cache - we do this at the end of Render so that it is
-  // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // invalidate the info bools whose sources changed - we do this at the end of
+  // Render so that they are fresh for the next process(), or after a windowclose
+  // animation (where process() isn't called)
+  g_infoManager.InvalidateChangedBools(hasRendered);
 
   if (hasRendered)
   {
@@ -1951,6 +1955,9 @@ bool CApplication::OnAppCommand(const CAction &action)
 
 bool CApplication::OnAction(const CAction &action)
 {
+  // an action may change about anything conditions depend on
+  g_infoManager.PublishChange(INFO::INFO_DEP_ALL);
+
   // special case for switching between GUI & fullscreen mode.
   if (action.GetID() == ACTION_SHOW_GUI)
   { // Switch to fullscreen mode if we can
@@ -2864,6 +2871,9 @@ void CApplication::Stop(int exitCode)
     CJobManager::GetInstance().CancelJobs();
 
     // stop scanning before we kill the network and so on
+#ifdef HAVE_INOTIFY
+    CLibraryWatcher::GetInstance().Stop();
+#endif
     if (m_musicInfoScanner->IsScanning())
       m_musicInfoScanner->Stop(true);
 
@@ -4768,6 +4778,7 @@ void CApplication::VolumeChanged() const
   data["volume"] = GetVolume();
   data["muted"] = m_muted;
   CAnnouncementManager::GetInstance().Announce(Application, "xbmc", "OnVolumeChanged", data);
+  g_infoManager.PublishChange(INFO::INFO_DEP_PLAYER);
 
   // if player has volume control, set it.
   m_pPlayer->SetVolume(m_volumeLevel);
@@ -4994,6 +5005,11 @@ void CApplication::UpdateLibraries()
     CLog::LogF(LOGNOTICE, "Starting music library startup scan");
     StartMusicScan("", !m_ServiceManager->GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_BACKGROUNDUPDATE));
   }
+
+#ifdef HAVE_INOTIFY
+  if (g_advancedSettings.m_libraryWatcherEnabled)
+    CLibraryWatcher::GetInstance().Start();
+#endif
 }
 
 bool CApplication::IsVideoScanning() const
@@ -5048,10 +5064,10 @@ void CApplication::StartMusicCleanup(bool userInitiated /* = true */)
   }
 }
 
-void CApplication::StartMusicScan(const std::string &strDirectory, bool userInitiated /* = true */, int flags /* = 0 */)
+bool CApplication::StartMusicScan(const std::string &strDirectory, bool userInitiated /* = true */, int flags /* = 0 */)
 {
   if (m_musicInfoScanner->IsScanning())
-    return;
+    return false;
 
   if (!flags)
   { // setup default flags
@@ -5070,6 +5086,7 @@ void CApplication::StartMusicScan(const std::string &strDirectory, bool userInit
     m_musicInfoScanner->ShowDialog(true);
 
   m_musicInfoScanner->Start(strDirectory, flags);
+  return true;
 }
 
 void CApplication::StartMusicAlbumScan(const std::string& strDirectory,
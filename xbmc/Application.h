@@ -267,8 +267,9 @@ public:
    \param path The path to scan or "" (empty string) for a global scan.
    \param userInitiated Whether the action was initiated by the user (either via GUI or any other method) or not.  It is meant to hide or show dialogs.
    \param flags Flags for controlling the scanning process.  See xbmc/music/infoscanner/MusicInfoScanner.h for possible values.
+   \return false if a scan is running already and this one was not started.
    */
-  void StartMusicScan(const std::string &path, bool userInitiated = true, int flags = 0);
+  bool StartMusicScan(const std::string &path, bool userInitiated = true, int flags = 0);
   void StartMusicAlbumScan(const std::string& strDirectory, bool refresh = false);
   void StartMusicArtistScan(const std::string& strDirectory, bool refresh = false);
 
@@ -23,6 +23,7 @@
 #include "addons/AddonDatabase.h"
 #include "view/ViewDatabase.h"
 #include "TextureDatabase.h"
+#include "FingerprintDatabase.h"
 #include "music/MusicDatabase.h"
 #include "video/VideoDatabase.h"
 #include "pvr/PVRDatabase.h"
@@ -61,6 +62,7 @@ void CDatabaseManager::Initialize(bool addonsOnly)
   //       before CVideoDatabase.
   { CViewDatabase db; UpdateDatabase(db); }
   { CTextureDatabase db; UpdateDatabase(db); }
+  { CFingerprintDatabase db; UpdateDatabase(db); }
   { CMusicDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseMusic); }
   { CVideoDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseVideo); }
   { CPVRDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseTV); }
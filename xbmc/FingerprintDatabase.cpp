@@ -0,0 +1,167 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FingerprintDatabase.h"
+#include "FileItem.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+SFingerprintStats& SFingerprintStats::operator+=(const SFingerprintStats& right)
+{
+  added += right.added;
+  modified += right.modified;
+  removed += right.removed;
+  unchanged += right.unchanged;
+  return *this;
+}
+
+CFingerprintDatabase::CFingerprintDatabase() = default;
+
+CFingerprintDatabase::~CFingerprintDatabase() = default;
+
+bool CFingerprintDatabase::Open()
+{
+  return CDatabase::Open();
+}
+
+void CFingerprintDatabase::CreateTables()
+{
+  CLog::Log(LOGINFO, "create fingerprint table");
+  m_pDS->exec("CREATE TABLE fingerprint (idFingerprint integer primary key, strScanner text, strPath text, strFile text, "
+              "iSize integer, iModified integer, iInode integer)");
+}
+
+void CFingerprintDatabase::CreateAnalytics()
+{
+  CLog::Log(LOGINFO, "%s creating indices", __FUNCTION__);
+  m_pDS->exec("CREATE INDEX idxFingerprint ON fingerprint(strScanner, strPath)");
+}
+
+bool CFingerprintDatabase::GetFingerprints(const std::string& scanner, const std::string& strPath, FingerprintMap& fingerprints)
+{
+  fingerprints.clear();
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    m_pDS->query("SELECT strFile, iSize, iModified, iInode FROM fingerprint WHERE strScanner=? AND strPath=?", { scanner, strPath });
+    while (!m_pDS->eof())
+    {
+      SFingerprint& fingerprint = fingerprints[m_pDS->fv(0).get_asString()];
+      fingerprint.size = m_pDS->fv(1).get_asInt64();
+      fingerprint.modified = m_pDS->fv(2).get_asInt64();
+      fingerprint.inode = m_pDS->fv(3).get_asInt64();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed for %s", __FUNCTION__, strPath.c_str());
+  }
+  return false;
+}
+
+bool CFingerprintDatabase::SetFingerprints(const std::string& scanner, const std::string& strPath, const FingerprintMap& fingerprints)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    BeginTransaction();
+    m_pDS->exec("DELETE FROM fingerprint WHERE strScanner=? AND strPath=?", { scanner, strPath });
+    for (const auto& it : fingerprints)
+    {
+      m_pDS->exec("INSERT INTO fingerprint (idFingerprint, strScanner, strPath, strFile, iSize, iModified, iInode) VALUES (NULL, ?, ?, ?, ?, ?, ?)",
+                  { scanner, strPath, it.first, it.second.size, it.second.modified, it.second.inode });
+    }
+    CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed for %s", __FUNCTION__, strPath.c_str());
+    RollbackTransaction();
+  }
+  return false;
+}
+
+SFingerprint CFingerprintDatabase::GetFingerprint(const CFileItem& item)
+{
+  SFingerprint fingerprint;
+  fingerprint.size = item.m_dwSize;
+  if (item.m_dateTime.IsValid())
+  {
+    time_t modified;
+    item.m_dateTime.GetAsTime(modified);
+    fingerprint.modified = modified;
+  }
+
+  // a file replaced by one with the same size and date, e.g. by a copy that
+  // preserves timestamps, still gets a new inode
+  if (URIUtils::IsHD(item.GetPath()) && !item.IsStack())
+  {
+    struct __stat64 buffer;
+    if (XFILE::CFile::Stat(item.GetPath(), &buffer) == 0)
+      fingerprint.inode = buffer.st_ino;
+  }
+  return fingerprint;
+}
+
+SFingerprintStats CFingerprintDatabase::Compare(const FingerprintMap& stored, const CFileItemList& items,
+                                                FingerprintMap& current, std::set<std::string>& unchanged)
+{
+  SFingerprintStats stats;
+  current.clear();
+  unchanged.clear();
+
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr& item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    const SFingerprint fingerprint = GetFingerprint(*item);
+    current[item->GetPath()] = fingerprint;
+
+    FingerprintMap::const_iterator it = stored.find(item->GetPath());
+    if (it == stored.end())
+      stats.added++;
+    else if (fingerprint.modified == 0 || fingerprint != it->second)
+      stats.modified++;
+    else
+    {
+      unchanged.insert(item->GetPath());
+      stats.unchanged++;
+    }
+  }
+
+  for (const auto& it : stored)
+  {
+    if (current.find(it.first) == current.end())
+      stats.removed++;
+  }
+  return stats;
+}
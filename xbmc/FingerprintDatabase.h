@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+
+#include "dbwrappers/Database.h"
+
+class CFileItem;
+class CFileItemList;
+
+/*! \brief What the library scanners know about a file from the last scan
+ Only the listing and, for local files, a stat() are needed to get it, so a
+ fingerprint can be compared without opening the file.
+ */
+struct SFingerprint
+{
+  int64_t size = 0;
+  int64_t modified = 0; ///< seconds since the epoch, 0 if the source doesn't report it
+  int64_t inode = 0;    ///< 0 if not available
+
+  bool operator==(const SFingerprint& right) const
+  {
+    return size == right.size && modified == right.modified && inode == right.inode;
+  }
+  bool operator!=(const SFingerprint& right) const { return !(*this == right); }
+};
+
+typedef std::map<std::string, SFingerprint> FingerprintMap;
+
+struct SFingerprintStats
+{
+  unsigned int added = 0;
+  unsigned int modified = 0;
+  unsigned int removed = 0;
+  unsigned int unchanged = 0;
+
+  bool HasChanges() const { return added > 0 || modified > 0 || removed > 0; }
+  SFingerprintStats& operator+=(const SFingerprintStats& right);
+};
+
+/*! \brief Per-file index of what the library scanners processed
+
+ The scanners only look at a folder again when its path hash changed. The
+ index tells them which files of such a folder were added, removed or modified
+ since the last scan, so the others can be left alone. Fingerprints are kept
+ per scanner, as music and video may scan the same folders.
+ */
+class CFingerprintDatabase : public CDatabase
+{
+public:
+  CFingerprintDatabase();
+  virtual ~CFingerprintDatabase();
+  virtual bool Open();
+
+  /*! \brief Get the fingerprints stored for the files of a folder
+   \param scanner name of the scanner the fingerprints belong to
+   \param strPath the folder
+   \param fingerprints [out] fingerprints by file path
+   \return true on success, false if the database couldn't be queried
+   */
+  bool GetFingerprints(const std::string& scanner, const std::string& strPath, FingerprintMap& fingerprints);
+
+  /*! \brief Replace the fingerprints stored for the files of a folder
+   \param scanner name of the scanner the fingerprints belong to
+   \param strPath the folder
+   \param fingerprints fingerprints by file path, empty to forget the folder
+   \return true on success, false otherwise
+   */
+  bool SetFingerprints(const std::string& scanner, const std::string& strPath, const FingerprintMap& fingerprints);
+
+  /*! \brief Get the fingerprint of a listed file
+   Local files are stat()ed for their inode, all other values come from the listing.
+   */
+  static SFingerprint GetFingerprint(const CFileItem& item);
+
+  /*! \brief Compare a folder listing against the fingerprints of the last scan
+   A file only counts as unchanged if the source reported its modification
+   time, files without one are always scanned again.
+   \param stored fingerprints from the last scan
+   \param items the current listing, folders are ignored
+   \param current [out] fingerprints of all files in the listing
+   \param unchanged [out] paths of the files that did not change
+   \return how many files were added, modified, removed and left unchanged
+   */
+  static SFingerprintStats Compare(const FingerprintMap& stored, const CFileItemList& items,
+                                   FingerprintMap& current, std::set<std::string>& unchanged);
+
+protected:
+  virtual void CreateTables();
+  virtual void CreateAnalytics();
+  virtual int GetSchemaVersion() const { return 1; };
+  const char *GetBaseDBName() const { return "Fingerprints"; };
+};
@@ -154,6 +154,11 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_changedSources = INFO_DEP_NONE;
+  m_boolEvaluations = 0;
+  m_lastBoolEvaluations = 0;
+  m_lastTimeChange = 0;
+  m_wasPlaying = false;
   ResetLibraryBools();
 }
 
@@ -6867,6 +6872,84 @@ bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWin
   return result;
 }
 
+unsigned int CGUIInfoManager::GetBoolDependencies(int condition1) const
+{
+  int condition = abs(condition1);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    if (condition - MULTI_INFO_START >= static_cast<int>(m_multiInfo.size()))
+      return INFO_DEP_ALWAYS;
+    condition = m_multiInfo[condition - MULTI_INFO_START].m_info;
+  }
+
+  if (condition >= LISTITEM_START && condition < LISTITEM_END)
+    return INFO_DEP_WINDOW | INFO_DEP_LISTITEM;
+
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_DARWIN:
+  case SYSTEM_PLATFORM_DARWIN_OSX:
+  case SYSTEM_PLATFORM_DARWIN_IOS:
+  case SYSTEM_PLATFORM_ANDROID:
+  case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+    return INFO_DEP_NONE;
+  case SYSTEM_TIME:
+  case SYSTEM_DATE:
+  case SYSTEM_IDLE_TIME:
+  case SYSTEM_ALARM_LESS_OR_EQUAL:
+    return INFO_DEP_TIME;
+  case SYSTEM_CURRENT_WINDOW:
+  case SYSTEM_CURRENT_CONTROL:
+  case SYSTEM_CURRENT_CONTROL_ID:
+  case SYSTEM_HAS_ACTIVE_MODAL_DIALOG:
+  case SYSTEM_HAS_VISIBLE_MODAL_DIALOG:
+  case SYSTEM_ISFULLSCREEN:
+  case WINDOW_IS_TOPMOST:
+  case WINDOW_IS_VISIBLE:
+  case WINDOW_NEXT:
+  case WINDOW_PREVIOUS:
+  case WINDOW_IS_MEDIA:
+  case WINDOW_IS_ACTIVE:
+  case WINDOW_IS:
+  case CONTROL_GET_LABEL:
+  case CONTROL_IS_ENABLED:
+  case CONTROL_IS_VISIBLE:
+  case CONTROL_GROUP_HAS_FOCUS:
+  case CONTROL_HAS_FOCUS:
+    return INFO_DEP_WINDOW;
+  case LIBRARY_IS_SCANNING:
+  case LIBRARY_IS_SCANNING_VIDEO:
+  case LIBRARY_IS_SCANNING_MUSIC:
+    // the scanners don't publish when they start or finish
+    return INFO_DEP_ALWAYS;
+  default:
+    break;
+  }
+
+  if (condition >= PLAYER_HAS_MEDIA && condition <= PLAYER_HAS_GAME)
+    return INFO_DEP_PLAYER;
+  if (condition >= MUSICPLAYER_TITLE && condition <= VIDEOPLAYER_DBID)
+    return INFO_DEP_PLAYER;
+  if (condition >= MUSICPM_ENABLED && condition <= VISUALISATION_HAS_PRESETS)
+    return INFO_DEP_PLAYER;
+  if (condition >= PLAYER_PROCESS && condition <= PLAYER_PROCESS_AUDIOBITSPERSAMPLE)
+    return INFO_DEP_PLAYER;
+  if (condition >= CONTAINER_HAS_PARENT_ITEM && condition <= CONTAINER_NUM_NONFOLDER_ITEMS)
+    return INFO_DEP_WINDOW | INFO_DEP_LISTITEM;
+  if (condition >= SKIN_BOOL && condition <= SKIN_ASPECT_RATIO)
+    return INFO_DEP_SKIN;
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_ROLE)
+    return INFO_DEP_LIBRARY;
+
+  // string comparisons, window properties set by add-ons, pvr, weather,
+  // system info, ... may change at any time
+  return INFO_DEP_ALWAYS;
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -6874,6 +6957,8 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   bool bReturn = false;
   int condition = abs(condition1);
 
+  m_boolEvaluations.fetch_add(1, std::memory_order_relaxed);
+
   if (condition >= LISTITEM_START && condition < LISTITEM_END)
   {
     if (item)
@@ -10764,6 +10849,44 @@ void CGUIInfoManager::ResetCache()
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::PublishChange(unsigned int sources)
+{
+  m_changedSources.fetch_or(sources);
+}
+
+void CGUIInfoManager::InvalidateChangedBools(bool guiChanged)
+{
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  unsigned int sources = m_changedSources.exchange(INFO_DEP_NONE) | INFO_DEP_ALWAYS;
+  if (guiChanged)
+    sources |= INFO_DEP_WINDOW | INFO_DEP_LISTITEM;
+
+  // most player conditions follow the playback position, so publish every
+  // frame while playing and once more after playback ended
+  const bool playing = g_application.m_pPlayer->IsPlaying();
+  if (playing || m_wasPlaying)
+    sources |= INFO_DEP_PLAYER;
+  m_wasPlaying = playing;
+
+  const time_t now = time(nullptr);
+  if (now != m_lastTimeChange)
+  {
+    sources |= INFO_DEP_TIME;
+    m_lastTimeChange = now;
+  }
+
+  m_lastBoolEvaluations = m_boolEvaluations.exchange(0);
+
+  CSingleLock lock(m_critInfo);
+  for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    if ((*i)->GetDependencies() & sources)
+      (*i)->SetDirty();
+  }
+}
+
 std::string CGUIInfoManager::GetPictureLabel(int info)
 {
   if (info == SLIDE_FILE_NAME)
@@ -10931,10 +11054,12 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  PublishChange(INFO_DEP_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
 {
+  PublishChange(INFO_DEP_LIBRARY);
   m_libraryHasMusic = -1;
   m_libraryHasMovies = -1;
   m_libraryHasTVShows = -1;
@@ -206,6 +206,24 @@ public:
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
   void ResetCache();
+
+  /*! \brief Publish a change of state that info bools may depend on
+   Safe to call from any thread, the bools depending on the sources are
+   invalidated by the next call to InvalidateChangedBools().
+   \param sources combination of INFO::InfoDependency flags
+   */
+  void PublishChange(unsigned int sources);
+
+  /*! \brief Invalidate the info bools whose sources changed during the last frame
+   Unlike ResetCache(), bools whose sources didn't change keep their value.
+   \param guiChanged true if the GUI rendered anything, i.e. window state may have changed
+   */
+  void InvalidateChangedBools(bool guiChanged);
+
+  /*! \brief Number of conditions evaluated during the last frame, for profiling
+   */
+  unsigned int GetBoolEvaluations() const { return m_lastBoolEvaluations; }
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -240,6 +258,11 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the state sources a translated condition depends on
+   \return INFO::InfoDependency flags, INFO_DEP_ALWAYS for conditions without known sources
+   */
+  unsigned int GetBoolDependencies(int condition) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -330,6 +353,11 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoPtr> m_bools;
+  std::atomic<unsigned int> m_changedSources;
+  std::atomic<unsigned int> m_boolEvaluations;
+  unsigned int m_lastBoolEvaluations;
+  time_t m_lastTimeChange;
+  bool m_wasPlaying;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
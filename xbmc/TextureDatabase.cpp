@@ -258,8 +258,7 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string sql = PrepareSQL("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url='%s'", url.c_str());
-    m_pDS->query(sql);
+    m_pDS->query("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url=?", { url });
     if (!m_pDS->eof())
     { // have some information
       details.id = m_pDS->fv(0).get_asInt();
@@ -363,7 +362,7 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
 
 bool CTextureDatabase::ClearCachedTexture(const std::string &url, std::string &cacheFile)
 {
-  std::string id = GetSingleValue(PrepareSQL("select id from texture where url='%s'", url.c_str()));
+  std::string id = GetSingleValue("select id from texture where url=?", { url });
   return !id.empty() ? ClearCachedTexture(strtol(id.c_str(), NULL, 10), cacheFile) : false;
 }
 
@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "utils/SortUtils.h"
+#include "video/VideoInfoTag.h"
+
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+const char* const words[] = { "The", "A", "Last", "Night", "Return", "Star", "Dark", "City",
+                              "Dream", "Empire", "Kingdom", "Road", "Shadow", "River", "Lost" };
+
+void FillList(CFileItemList& items, int count)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> word(0, sizeof(words) / sizeof(words[0]) - 1);
+  std::uniform_int_distribution<int> year(1950, 2017);
+  std::uniform_real_distribution<float> rating(1.0f, 10.0f);
+
+  for (int i = 0; i < count; i++)
+  {
+    std::string title = std::string(words[word(rng)]) + " " + words[word(rng)] + " " +
+                        words[word(rng)] + " " + std::to_string(i);
+    CFileItemPtr item(new CFileItem(title));
+    item->SetPath("/media/movies/" + title + ".mkv");
+    CVideoInfoTag* tag = item->GetVideoInfoTag();
+    tag->SetTitle(title);
+    tag->SetYear(year(rng));
+    tag->SetRating(rating(rng));
+    items.Add(item);
+  }
+}
+
+void SortList(benchmark::State& state, SortBy sortBy, SortAttribute attributes)
+{
+  CFileItemList source;
+  FillList(source, static_cast<int>(state.range(0)));
+
+  CFileItemList items;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    items.Assign(source);
+    state.ResumeTiming();
+
+    items.Sort(sortBy, SortOrderAscending, attributes);
+    benchmark::DoNotOptimize(items.Get(0));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}
+
+static void BM_FileItemList_SortByLabel(benchmark::State& state)
+{
+  SortList(state, SortByLabel, SortAttributeIgnoreArticle);
+}
+BENCHMARK(BM_FileItemList_SortByLabel)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_FileItemList_SortByTitle(benchmark::State& state)
+{
+  SortList(state, SortByTitle, SortAttributeNone);
+}
+BENCHMARK(BM_FileItemList_SortByTitle)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_FileItemList_SortByYear(benchmark::State& state)
+{
+  SortList(state, SortByYear, SortAttributeNone);
+}
+BENCHMARK(BM_FileItemList_SortByYear)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_FileItemList_SortByRating(benchmark::State& state)
+{
+  SortList(state, SortByRating, SortAttributeNone);
+}
+BENCHMARK(BM_FileItemList_SortByRating)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
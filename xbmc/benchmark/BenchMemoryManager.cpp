@@ -0,0 +1,139 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BenchMemoryManager.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+// every block is preceded by its size so delete knows what to subtract,
+// the header is 16 bytes to keep the alignment malloc guarantees
+const size_t HEADER_SIZE = 16;
+
+std::atomic<bool> counting(false);
+std::atomic<int64_t> numAllocs(0);
+std::atomic<int64_t> totalBytes(0);
+std::atomic<int64_t> currentBytes(0);
+std::atomic<int64_t> peakBytes(0);
+
+void* Allocate(size_t size)
+{
+  char* block = static_cast<char*>(malloc(size + HEADER_SIZE));
+  if (!block)
+    return nullptr;
+  *reinterpret_cast<size_t*>(block) = size;
+
+  if (counting.load(std::memory_order_relaxed))
+  {
+    numAllocs.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    const int64_t current = currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+      ;
+  }
+  return block + HEADER_SIZE;
+}
+
+void Free(void* ptr)
+{
+  if (!ptr)
+    return;
+
+  char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+  if (counting.load(std::memory_order_relaxed))
+    currentBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+  free(block);
+}
+}
+
+void* operator new(size_t size)
+{
+  void* ptr = Allocate(size);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+  return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+  return Allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  Free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  Free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  Free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  Free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  Free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+  Free(ptr);
+}
+
+void CBenchMemoryManager::Start()
+{
+  numAllocs = 0;
+  totalBytes = 0;
+  currentBytes = 0;
+  peakBytes = 0;
+  counting = true;
+}
+
+void CBenchMemoryManager::Stop(Result& result)
+{
+  counting = false;
+  result.num_allocs = numAllocs;
+  result.max_bytes_used = peakBytes;
+  result.total_allocated_bytes = totalBytes;
+  result.net_heap_growth = currentBytes;
+}
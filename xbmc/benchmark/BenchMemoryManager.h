@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "benchmark/benchmark.h"
+
+/*!
+ * \brief Reports heap usage of each benchmark
+ *
+ * kodi-bench replaces the global operator new and delete to count
+ * allocations. Once registered, every benchmark runs one more time with the
+ * counters enabled and reports allocations and peak heap use alongside its
+ * timings.
+ */
+class CBenchMemoryManager : public benchmark::MemoryManager
+{
+public:
+  void Start();
+  void Stop(Result& result);
+  void Stop(Result* result) { Stop(*result); }
+};
@@ -34,6 +34,7 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
@@ -334,6 +335,7 @@ int AE_parentStates[] = {
 
 void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
 {
+  TRACE_FUNCTION("audio");
   for (int state = m_state; ; state = AE_parentStates[state])
   {
     switch (state)
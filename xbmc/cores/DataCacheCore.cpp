@@ -25,6 +25,7 @@
 CDataCacheCore::CDataCacheCore()
 {
   m_hasAVInfoChanges = false;
+  m_packetPoolInfo = SPacketPoolInfo();
 }
 
 CDataCacheCore& GetInstance()
@@ -235,3 +236,51 @@ bool CDataCacheCore::CDataCacheCore::IsSeeking()
 
   return m_stateInfo.m_stateSeeking;
 }
+
+// demux packet pool
+void CDataCacheCore::SetDemuxPacketPoolInfo(uint64_t hits, uint64_t misses, int packetsHighWater,
+                                            int64_t bytesHighWater, int64_t bytesPooled)
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  m_packetPoolInfo.hits = hits;
+  m_packetPoolInfo.misses = misses;
+  m_packetPoolInfo.packetsHighWater = packetsHighWater;
+  m_packetPoolInfo.bytesHighWater = bytesHighWater;
+  m_packetPoolInfo.bytesPooled = bytesPooled;
+}
+
+uint64_t CDataCacheCore::GetDemuxPacketPoolHits()
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  return m_packetPoolInfo.hits;
+}
+
+uint64_t CDataCacheCore::GetDemuxPacketPoolMisses()
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  return m_packetPoolInfo.misses;
+}
+
+int CDataCacheCore::GetDemuxPacketPoolHighWater()
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  return m_packetPoolInfo.packetsHighWater;
+}
+
+int64_t CDataCacheCore::GetDemuxPacketPoolBytesHighWater()
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  return m_packetPoolInfo.bytesHighWater;
+}
+
+int64_t CDataCacheCore::GetDemuxPacketPoolBytesPooled()
+{
+  CSingleLock lock(m_packetPoolSection);
+
+  return m_packetPoolInfo.bytesPooled;
+}
@@ -21,6 +21,7 @@
 */
 
 #include <atomic>
+#include <stdint.h>
 #include <string>
 #include "threads/CriticalSection.h"
 
@@ -67,6 +68,15 @@ public:
   void SetStateSeeking(bool active);
   bool IsSeeking();
 
+  // demux packet pool
+  void SetDemuxPacketPoolInfo(uint64_t hits, uint64_t misses, int packetsHighWater,
+                              int64_t bytesHighWater, int64_t bytesPooled);
+  uint64_t GetDemuxPacketPoolHits();
+  uint64_t GetDemuxPacketPoolMisses();
+  int GetDemuxPacketPoolHighWater();
+  int64_t GetDemuxPacketPoolBytesHighWater();
+  int64_t GetDemuxPacketPoolBytesPooled();
+
 protected:
   std::atomic_bool m_hasAVInfoChanges;
 
@@ -103,4 +113,14 @@ protected:
   {
     bool m_stateSeeking;
   } m_stateInfo;
+
+  CCriticalSection m_packetPoolSection;
+  struct SPacketPoolInfo
+  {
+    uint64_t hits;
+    uint64_t misses;
+    int packetsHighWater;
+    int64_t bytesHighWater;
+    int64_t bytesPooled;
+  } m_packetPoolInfo;
 };
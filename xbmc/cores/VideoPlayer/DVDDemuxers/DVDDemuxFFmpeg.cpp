@@ -284,6 +284,12 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput, bool streaminfo, bool filein
     if(m_pInput->Seek(0, SEEK_POSSIBLE) == 0)
       m_ioContext->seekable = 0;
 
+    // with the file mapped, packet payloads are copied from the mapped pages
+    // into the packet without a detour through the avio buffer, and short
+    // skips become a seek instead of reading the skipped bytes
+    if (m_pInput->IsMemoryMapped())
+      m_ioContext->direct = 1;
+
     std::string content = m_pInput->GetContent();
     StringUtils::ToLower(content);
     if (StringUtils::StartsWith(content, "audio/l16"))
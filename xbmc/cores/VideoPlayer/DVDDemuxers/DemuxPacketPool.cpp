@@ -0,0 +1,316 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DemuxPacketPool.h"
+#include "DVDDemuxPacket.h"
+#include "DemuxCrypto.h"
+#include "TimingConstants.h"
+#include "threads/SingleLock.h"
+#include "system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#ifdef TARGET_POSIX
+#include "linux/XMemUtils.h"
+#endif
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+// smallest class is 256 bytes, largest 2 MiB (1 << (8 + 14 - 1))
+#define POOL_MIN_CLASS_SHIFT  8
+// upper bound of memory kept in the free list of a single size class
+#define POOL_CLASS_BUDGET     (8 * 1024 * 1024)
+#define POOL_MIN_FREE_BLOCKS  4
+#define POOL_MAX_FREE_BLOCKS  256
+#define POOL_MAX_FREE_PACKETS 1024
+
+namespace
+{
+// Every payload is preceded by this header so Free() finds the size class
+// without changing the layout of DemuxPacket, which add-ons depend on.
+// Its size keeps pData 16 byte aligned like before.
+struct alignas(16) PayloadHeader
+{
+  uint32_t magic;
+  int32_t sizeClass; // -1 for payloads allocated outside of the pool
+  int32_t capacity;
+};
+
+const uint32_t PAYLOAD_MAGIC = 0x444d5850; // "DMXP"
+
+// catches payloads that were not allocated by the pool, e.g. a pData
+// replaced by a demuxer, before the header in front of them is trusted
+PayloadHeader* GetHeader(uint8_t* pData)
+{
+  PayloadHeader* header = reinterpret_cast<PayloadHeader*>(pData - sizeof(PayloadHeader));
+  assert(header->magic == PAYLOAD_MAGIC);
+  return header;
+}
+
+void ResetPacket(DemuxPacket* pPacket)
+{
+  pPacket->pData = nullptr;
+  pPacket->iSize = 0;
+  pPacket->iStreamId = -1;
+  pPacket->demuxerId = 0;
+  pPacket->iGroupId = 0;
+  pPacket->pts = DVD_NOPTS_VALUE;
+  pPacket->dts = DVD_NOPTS_VALUE;
+  pPacket->duration = 0;
+  pPacket->dispTime = 0;
+  pPacket->cryptoInfo.reset();
+}
+}
+
+const int64_t CDemuxPacketPool::MAX_POOLED_BYTES;
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  // intentionally leaked, packets may still be freed by other singletons
+  // during static destruction and must not find a destroyed pool
+  static CDemuxPacketPool* instance = new CDemuxPacketPool;
+  return *instance;
+}
+
+CDemuxPacketPool::CDemuxPacketPool()
+  : m_hits(0)
+  , m_misses(0)
+  , m_packetsInUse(0)
+  , m_packetsHighWater(0)
+  , m_bytesInUse(0)
+  , m_bytesHighWater(0)
+  , m_bytesPooled(0)
+{
+  for (int i = 0; i < NUM_SIZE_CLASSES; ++i)
+  {
+    size_t blocks = POOL_CLASS_BUDGET / GetClassCapacity(i);
+    m_classes[i].maxFree = std::min<size_t>(std::max<size_t>(blocks, POOL_MIN_FREE_BLOCKS), POOL_MAX_FREE_BLOCKS);
+  }
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Trim();
+}
+
+int CDemuxPacketPool::GetSizeClass(int capacity)
+{
+  int sizeClass = 0;
+  while ((1 << (POOL_MIN_CLASS_SHIFT + sizeClass)) < capacity)
+  {
+    if (++sizeClass == NUM_SIZE_CLASSES)
+      return -1;
+  }
+  return sizeClass;
+}
+
+int CDemuxPacketPool::GetClassCapacity(int sizeClass)
+{
+  return 1 << (POOL_MIN_CLASS_SHIFT + sizeClass);
+}
+
+DemuxPacket* CDemuxPacketPool::Allocate(int iDataSize)
+{
+  bool hit = true;
+  DemuxPacket* pPacket = nullptr;
+  {
+    CSingleLock lock(m_packetLock);
+    if (!m_freePackets.empty())
+    {
+      pPacket = m_freePackets.back();
+      m_freePackets.pop_back();
+    }
+  }
+  if (!pPacket)
+  {
+    pPacket = new DemuxPacket;
+    hit = false;
+  }
+  ResetPacket(pPacket);
+
+  int64_t bytes = 0;
+  if (iDataSize > 0)
+  {
+    // From avcodec.h (ffmpeg)
+    /**
+      * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+      * this is mainly needed because some optimized bitstream readers read
+      * 32 or 64 bit at once and could read over the end<br>
+      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+      * MPEG bitstreams could cause overread and segfault
+      */
+    const int capacity = iDataSize + FF_INPUT_BUFFER_PADDING_SIZE;
+    const int sizeClass = GetSizeClass(capacity);
+
+    uint8_t* pData = nullptr;
+    if (sizeClass >= 0)
+    {
+      SizeClass& cls = m_classes[sizeClass];
+      CSingleLock lock(cls.lock);
+      if (!cls.freeBlocks.empty())
+      {
+        pData = cls.freeBlocks.back();
+        cls.freeBlocks.pop_back();
+        m_bytesPooled -= GetClassCapacity(sizeClass);
+      }
+    }
+    if (!pData)
+    {
+      pData = AllocatePayload(sizeClass >= 0 ? GetClassCapacity(sizeClass) : capacity, sizeClass);
+      hit = false;
+    }
+    if (!pData)
+    {
+      Free(pPacket);
+      return nullptr;
+    }
+
+    // reset the padding to 0
+    memset(pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+    pPacket->pData = pData;
+    bytes = GetHeader(pData)->capacity;
+  }
+
+  if (hit)
+    ++m_hits;
+  else
+    ++m_misses;
+  UpdateInUse(1, bytes);
+
+  return pPacket;
+}
+
+void CDemuxPacketPool::Free(DemuxPacket* pPacket)
+{
+  if (!pPacket)
+    return;
+
+  int64_t bytes = 0;
+  if (pPacket->pData)
+  {
+    bytes = GetHeader(pPacket->pData)->capacity;
+    FreePayload(pPacket->pData);
+    pPacket->pData = nullptr;
+  }
+  // drop references held by the packet right away, not when it is reused
+  pPacket->cryptoInfo.reset();
+
+  UpdateInUse(-1, -bytes);
+
+  {
+    CSingleLock lock(m_packetLock);
+    if (m_freePackets.size() < POOL_MAX_FREE_PACKETS)
+    {
+      m_freePackets.push_back(pPacket);
+      return;
+    }
+  }
+  delete pPacket;
+}
+
+uint8_t* CDemuxPacketPool::AllocatePayload(int capacity, int sizeClass)
+{
+  uint8_t* block = static_cast<uint8_t*>(_aligned_malloc(capacity + sizeof(PayloadHeader), 16));
+  if (!block)
+    return nullptr;
+
+  PayloadHeader* header = reinterpret_cast<PayloadHeader*>(block);
+  header->magic = PAYLOAD_MAGIC;
+  header->sizeClass = sizeClass;
+  header->capacity = capacity;
+  return block + sizeof(PayloadHeader);
+}
+
+void CDemuxPacketPool::FreePayload(uint8_t* pData)
+{
+  PayloadHeader* header = GetHeader(pData);
+  const int sizeClass = header->sizeClass;
+
+  if (sizeClass >= 0 && sizeClass < NUM_SIZE_CLASSES)
+  {
+    SizeClass& cls = m_classes[sizeClass];
+    const int capacity = GetClassCapacity(sizeClass);
+    CSingleLock lock(cls.lock);
+    if (cls.freeBlocks.size() < cls.maxFree)
+    {
+      // reserve the room first, the classes don't share a lock
+      if (m_bytesPooled.fetch_add(capacity) + capacity <= MAX_POOLED_BYTES)
+      {
+        cls.freeBlocks.push_back(pData);
+        return;
+      }
+      m_bytesPooled -= capacity;
+    }
+  }
+  _aligned_free(header);
+}
+
+void CDemuxPacketPool::UpdateInUse(int packets, int64_t bytes)
+{
+  const int inUse = (m_packetsInUse += packets);
+  int high = m_packetsHighWater.load(std::memory_order_relaxed);
+  while (inUse > high && !m_packetsHighWater.compare_exchange_weak(high, inUse))
+    ;
+
+  const int64_t bytesInUse = (m_bytesInUse += bytes);
+  int64_t bytesHigh = m_bytesHighWater.load(std::memory_order_relaxed);
+  while (bytesInUse > bytesHigh && !m_bytesHighWater.compare_exchange_weak(bytesHigh, bytesInUse))
+    ;
+}
+
+SDemuxPacketPoolStats CDemuxPacketPool::GetStats() const
+{
+  SDemuxPacketPoolStats stats;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.packetsInUse = m_packetsInUse;
+  stats.packetsHighWater = m_packetsHighWater;
+  stats.bytesInUse = m_bytesInUse;
+  stats.bytesHighWater = m_bytesHighWater;
+  stats.bytesPooled = m_bytesPooled;
+  return stats;
+}
+
+void CDemuxPacketPool::Trim()
+{
+  for (int i = 0; i < NUM_SIZE_CLASSES; ++i)
+  {
+    std::vector<uint8_t*> blocks;
+    {
+      CSingleLock lock(m_classes[i].lock);
+      blocks.swap(m_classes[i].freeBlocks);
+      m_bytesPooled -= static_cast<int64_t>(blocks.size()) * GetClassCapacity(i);
+    }
+    for (uint8_t* pData : blocks)
+      _aligned_free(pData - sizeof(PayloadHeader));
+  }
+
+  std::vector<DemuxPacket*> packets;
+  {
+    CSingleLock lock(m_packetLock);
+    packets.swap(m_freePackets);
+  }
+  for (DemuxPacket* pPacket : packets)
+    delete pPacket;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+struct DemuxPacket;
+
+struct SDemuxPacketPoolStats
+{
+  uint64_t hits = 0;          // allocations served from the pool
+  uint64_t misses = 0;        // allocations that went to the heap
+  int packetsInUse = 0;
+  int packetsHighWater = 0;
+  int64_t bytesInUse = 0;     // payload capacity handed out, padding included
+  int64_t bytesHighWater = 0;
+  int64_t bytesPooled = 0;    // payload capacity kept in the free lists
+};
+
+/*!
+ * \brief Recycles DemuxPacket structs and their payload buffers
+ *
+ * Payloads are grouped into power of two size classes. The class is chosen
+ * by the requested size plus FF_INPUT_BUFFER_PADDING_SIZE, so the padding
+ * ffmpeg needs never pushes a packet into the next class. Each class has its
+ * own lock and a bounded free list, payloads larger than the largest class
+ * are allocated and freed directly. All free lists together never keep more
+ * than MAX_POOLED_BYTES.
+ */
+class CDemuxPacketPool
+{
+public:
+  static const int64_t MAX_POOLED_BYTES = 16 * 1024 * 1024;
+
+  static CDemuxPacketPool& GetInstance();
+
+  DemuxPacket* Allocate(int iDataSize);
+  void Free(DemuxPacket* pPacket);
+
+  SDemuxPacketPoolStats GetStats() const;
+
+  /*!
+   * \brief Release all pooled memory, e.g. when playback stops
+   */
+  void Trim();
+
+private:
+  CDemuxPacketPool();
+  ~CDemuxPacketPool();
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  static int GetSizeClass(int capacity);
+  static int GetClassCapacity(int sizeClass);
+  uint8_t* AllocatePayload(int capacity, int sizeClass);
+  void FreePayload(uint8_t* pData);
+  void UpdateInUse(int packets, int64_t bytes);
+
+  struct SizeClass
+  {
+    CCriticalSection lock;
+    std::vector<uint8_t*> freeBlocks;
+    size_t maxFree = 0;
+  };
+
+  static const int NUM_SIZE_CLASSES = 14;
+  SizeClass m_classes[NUM_SIZE_CLASSES];
+
+  CCriticalSection m_packetLock;
+  std::vector<DemuxPacket*> m_freePackets;
+
+  std::atomic<uint64_t> m_hits;
+  std::atomic<uint64_t> m_misses;
+  std::atomic<int> m_packetsInUse;
+  std::atomic<int> m_packetsHighWater;
+  std::atomic<int64_t> m_bytesInUse;
+  std::atomic<int64_t> m_bytesHighWater;
+  std::atomic<int64_t> m_bytesPooled;
+};
@@ -0,0 +1,86 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDInputStreams/DVDInputStreamFile.h"
+#include "FileItem.h"
+#include "settings/AdvancedSettings.h"
+
+#include <cstdlib>
+
+#include "benchmark/benchmark.h"
+
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
+// Demuxes a whole local video the way VideoPlayer reads an uncached file,
+// with reads going through read() (0) or the mapped file (1). There is no
+// sample large enough to be useful in the tree, so point
+// KODI_BENCH_VIDEO at one, e.g. a multi GB mkv.
+static void BM_DemuxFFmpeg_LocalFile(benchmark::State& state)
+{
+  const char* path = getenv("KODI_BENCH_VIDEO");
+  if (!path)
+  {
+    state.SkipWithError("KODI_BENCH_VIDEO is not set");
+    return;
+  }
+
+  static bool registered = false;
+  if (!registered)
+  {
+    av_register_all();
+    registered = true;
+  }
+
+  const bool mapped = g_advancedSettings.m_cacheMemoryMapped;
+  g_advancedSettings.m_cacheMemoryMapped = state.range(0) != 0;
+
+  CFileItem item(path, false);
+  item.SetMimeType("video/x-matroska");
+  int64_t bytes = 0;
+  int64_t packets = 0;
+
+  for (auto _ : state)
+  {
+    CDVDInputStreamFile input(item);
+    CDVDDemuxFFmpeg demuxer;
+    if (!input.Open() || !demuxer.Open(&input, false))
+    {
+      state.SkipWithError("can't open KODI_BENCH_VIDEO");
+      break;
+    }
+
+    DemuxPacket* pPacket;
+    while ((pPacket = demuxer.Read()) != nullptr)
+    {
+      packets++;
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+    }
+    bytes += input.GetLength();
+  }
+
+  state.SetBytesProcessed(bytes);
+  state.counters["packets"] = benchmark::Counter(static_cast<double>(packets), benchmark::Counter::kIsRate);
+  g_advancedSettings.m_cacheMemoryMapped = mapped;
+}
+BENCHMARK(BM_DemuxFFmpeg_LocalFile)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
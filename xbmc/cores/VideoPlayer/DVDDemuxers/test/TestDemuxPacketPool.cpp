@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxPacket.h"
+#include "cores/VideoPlayer/TimingConstants.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+#include "gtest/gtest.h"
+
+class TestDemuxPacketPool : public testing::Test
+{
+protected:
+  TestDemuxPacketPool() : pool(CDemuxPacketPool::GetInstance())
+  {
+    pool.Trim();
+  }
+  ~TestDemuxPacketPool()
+  {
+    pool.Trim();
+  }
+
+  // payload capacity handed out for a packet of the given size
+  int64_t AllocatedBytes(int size)
+  {
+    const int64_t before = pool.GetStats().bytesInUse;
+    DemuxPacket* packet = pool.Allocate(size);
+    const int64_t bytes = pool.GetStats().bytesInUse - before;
+    pool.Free(packet);
+    return bytes;
+  }
+
+  CDemuxPacketPool& pool;
+};
+
+TEST_F(TestDemuxPacketPool, SizeClasses)
+{
+  // the padding counts towards the size class
+  EXPECT_EQ(256, AllocatedBytes(1));
+  EXPECT_EQ(256, AllocatedBytes(256 - FF_INPUT_BUFFER_PADDING_SIZE));
+  EXPECT_EQ(512, AllocatedBytes(257 - FF_INPUT_BUFFER_PADDING_SIZE));
+  EXPECT_EQ(2 * 1024 * 1024, AllocatedBytes(2 * 1024 * 1024 - FF_INPUT_BUFFER_PADDING_SIZE));
+
+  // larger than the largest class, allocated as requested
+  const int large = 2 * 1024 * 1024;
+  EXPECT_EQ(large + FF_INPUT_BUFFER_PADDING_SIZE, AllocatedBytes(large));
+
+  EXPECT_EQ(0, AllocatedBytes(0));
+}
+
+TEST_F(TestDemuxPacketPool, Reuse)
+{
+  DemuxPacket* packet = pool.Allocate(1500);
+  ASSERT_NE(nullptr, packet);
+  ASSERT_NE(nullptr, packet->pData);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(packet->pData) % 16);
+  uint8_t* pData = packet->pData;
+  memset(pData, 0xAB, 2048);
+  packet->iStreamId = 3;
+  packet->pts = 1000.0;
+  pool.Free(packet);
+
+  const SDemuxPacketPoolStats before = pool.GetStats();
+  packet = pool.Allocate(1200);
+  ASSERT_NE(nullptr, packet);
+  const SDemuxPacketPoolStats after = pool.GetStats();
+
+  // same size class, so the payload comes back, reset and padded with zeros
+  EXPECT_EQ(pData, packet->pData);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  EXPECT_EQ(-1, packet->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->pts);
+  for (int i = 0; i < FF_INPUT_BUFFER_PADDING_SIZE; i++)
+    EXPECT_EQ(0, packet->pData[1200 + i]);
+  pool.Free(packet);
+
+  // a different size class doesn't get it
+  packet = pool.Allocate(100);
+  EXPECT_NE(pData, packet->pData);
+  EXPECT_EQ(after.misses + 1, pool.GetStats().misses);
+  pool.Free(packet);
+}
+
+TEST_F(TestDemuxPacketPool, RetentionCap)
+{
+  const int size = 1024 * 1024 - FF_INPUT_BUFFER_PADDING_SIZE;
+  std::vector<DemuxPacket*> packets;
+  for (int i = 0; i < 64; i++)
+    packets.push_back(pool.Allocate(size));
+  for (DemuxPacket* packet : packets)
+    pool.Free(packet);
+
+  SDemuxPacketPoolStats stats = pool.GetStats();
+  EXPECT_GT(stats.bytesPooled, 0);
+  EXPECT_LE(stats.bytesPooled, CDemuxPacketPool::MAX_POOLED_BYTES);
+
+  // each class stays within its own budget, but together they would keep
+  // well above the limit
+  for (int classSize : { 64 * 1024, 256 * 1024, 512 * 1024 })
+  {
+    packets.clear();
+    for (int i = 0; i < 64; i++)
+      packets.push_back(pool.Allocate(classSize - FF_INPUT_BUFFER_PADDING_SIZE));
+    for (DemuxPacket* packet : packets)
+      pool.Free(packet);
+    EXPECT_LE(pool.GetStats().bytesPooled, CDemuxPacketPool::MAX_POOLED_BYTES);
+  }
+
+  pool.Trim();
+  EXPECT_EQ(0, pool.GetStats().bytesPooled);
+}
+
+TEST_F(TestDemuxPacketPool, Stats)
+{
+  const SDemuxPacketPoolStats before = pool.GetStats();
+
+  DemuxPacket* first = pool.Allocate(100);
+  DemuxPacket* second = pool.Allocate(100);
+  SDemuxPacketPoolStats stats = pool.GetStats();
+  EXPECT_EQ(before.packetsInUse + 2, stats.packetsInUse);
+  EXPECT_LE(before.packetsInUse + 2, stats.packetsHighWater);
+  EXPECT_EQ(before.bytesInUse + 512, stats.bytesInUse);
+  EXPECT_LE(before.bytesInUse + 512, stats.bytesHighWater);
+  EXPECT_EQ(before.misses + 2, stats.misses);
+
+  pool.Free(first);
+  pool.Free(second);
+  stats = pool.GetStats();
+  EXPECT_EQ(before.packetsInUse, stats.packetsInUse);
+  EXPECT_EQ(before.bytesInUse, stats.bytesInUse);
+  EXPECT_EQ(before.bytesPooled + 512, stats.bytesPooled);
+
+  pool.Free(pool.Allocate(100));
+  EXPECT_EQ(stats.hits + 1, pool.GetStats().hits);
+}
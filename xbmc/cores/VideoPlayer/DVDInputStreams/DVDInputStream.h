@@ -167,6 +167,12 @@ public:
    */
   virtual bool GetCacheStatus(XFILE::SCacheStatus *status) { return false; }
 
+  /*! \brief Reads are served from memory mapped pages
+   \return true when Read and Seek are cheap enough for the demuxer to
+   call them directly instead of going through its own buffer
+   */
+  virtual bool IsMemoryMapped() { return false; }
+
   bool IsStreamType(DVDStreamType type) const { return m_streamType == type; }
   virtual bool IsEOF() = 0;
   virtual BitstreamStats GetBitstreamStats() const { return m_stats; }
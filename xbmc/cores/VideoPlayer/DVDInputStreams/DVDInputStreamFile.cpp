@@ -31,6 +31,7 @@ CDVDInputStreamFile::CDVDInputStreamFile(const CFileItem& fileitem) : CDVDInputS
 {
   m_pFile = NULL;
   m_eof = true;
+  m_mapped = false;
 }
 
 CDVDInputStreamFile::~CDVDInputStreamFile()
@@ -100,6 +101,11 @@ bool CDVDInputStreamFile::Open()
   if (m_pFile->GetImplementation() && (content.empty() || content == "application/octet-stream"))
     m_content = m_pFile->GetImplementation()->GetContent();
 
+  // uncached local files are read straight from the page cache, only
+  // filesystems that support it accept the request
+  if (!(flags & READ_CACHED) && (flags & READ_AUDIO_VIDEO) && g_advancedSettings.m_cacheMemoryMapped)
+    m_mapped = m_pFile->IoControl(IOCTRL_MMAP, NULL) == 1;
+
   m_eof = false;
   return true;
 }
@@ -116,6 +122,7 @@ void CDVDInputStreamFile::Close()
   CDVDInputStream::Close();
   m_pFile = NULL;
   m_eof = true;
+  m_mapped = false;
 }
 
 int CDVDInputStreamFile::Read(uint8_t* buf, int buf_size)
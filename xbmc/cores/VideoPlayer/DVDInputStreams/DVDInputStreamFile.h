@@ -38,8 +38,10 @@ public:
   virtual int GetBlockSize();
   virtual void SetReadRate(unsigned rate);
   virtual bool GetCacheStatus(XFILE::SCacheStatus *status);
+  virtual bool IsMemoryMapped() { return m_mapped; }
 
 protected:
   XFILE::CFile* m_pFile;
   bool m_eof;
+  bool m_mapped;
 };
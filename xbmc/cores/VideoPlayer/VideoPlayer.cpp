@@ -35,6 +35,7 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DemuxPacketPool.h"
 
 #include "DVDFileInfo.h"
 
@@ -67,6 +68,7 @@
 #include "settings/Settings.h"
 #include "settings/MediaSettings.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StreamDetails.h"
 #include "pvr/PVRManager.h"
 #include "utils/StreamUtils.h"
@@ -1357,6 +1359,7 @@ void CVideoPlayer::Process()
 
   while (!m_bAbortRequest)
   {
+    TRACE_SCOPE("videoplayer", "CVideoPlayer::Process");
 #ifdef HAS_OMXPLAYER
     if (m_omxplayer_mode && OMXDoProcessing(m_OmxPlayerState, m_playSpeed, m_VideoPlayerVideo, m_VideoPlayerAudio, m_CurrentAudio, m_CurrentVideo, m_HasVideo, m_HasAudio, m_renderManager))
     {
@@ -1666,6 +1669,7 @@ bool CVideoPlayer::CheckIsCurrent(CCurrentStream& current, CDemuxStream* stream,
 
 void CVideoPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  TRACE_FUNCTION("videoplayer");
   // process packet if it belongs to selected stream.
   // for dvd's don't allow automatic opening of streams*/
 
@@ -2460,6 +2464,9 @@ void CVideoPlayer::OnExit()
     SAFE_DELETE(m_pCCDemuxer);
     SAFE_DELETE(m_pInputStream);
 
+    // give back memory the packet pool kept for this stream
+    CDemuxPacketPool::GetInstance().Trim();
+
     // clean up all selection streams
     m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
 
@@ -5025,6 +5032,12 @@ void CVideoPlayer::UpdatePlayState(double timeout)
   else
     state.cache_bytes = 0;
 
+  SDemuxPacketPoolStats poolStats = CDemuxPacketPool::GetInstance().GetStats();
+  CServiceBroker::GetDataCacheCore().SetDemuxPacketPoolInfo(poolStats.hits, poolStats.misses,
+                                                            poolStats.packetsHighWater,
+                                                            poolStats.bytesHighWater,
+                                                            poolStats.bytesPooled);
+
   state.timestamp = m_clock.GetAbsoluteClock();
 
   CSingleLock lock(m_StateSection);
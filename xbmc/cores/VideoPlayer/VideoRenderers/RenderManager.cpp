@@ -25,6 +25,7 @@
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "windowing/WindowingFactory.h"
 
@@ -367,6 +368,7 @@ bool CRenderManager::IsPresenting()
 
 void CRenderManager::FrameMove()
 {
+  TRACE_FUNCTION("render");
   UpdateResolution();
 
   {
@@ -893,6 +895,7 @@ RESOLUTION CRenderManager::GetResolution()
 
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
+  TRACE_FUNCTION("render");
   CSingleExit exitLock(g_graphicsContext);
 
   {
@@ -212,6 +212,26 @@ std::string CDatabase::GetSingleValue(const std::string &query, std::unique_ptr<
   return ret;
 }
 
+std::string CDatabase::GetSingleValue(const std::string &query, const sql_params &params)
+{
+  std::string ret;
+  try
+  {
+    if (!m_pDB.get() || !m_pDS.get())
+      return ret;
+
+    if (m_pDS->query(query, params) && m_pDS->num_rows() > 0)
+      ret = m_pDS->fv(0).get_asString();
+
+    m_pDS->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed on query '%s'", __FUNCTION__, query.c_str());
+  }
+  return ret;
+}
+
 std::string CDatabase::GetSingleValue(const std::string &strTable, const std::string &strColumn, const std::string &strWhereClause /* = std::string() */, const std::string &strOrderBy /* = std::string() */)
 {
   std::string query = PrepareSQL("SELECT %s FROM %s", strColumn.c_str(), strTable.c_str());
@@ -284,6 +304,34 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const sql_params &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    // queued queries are plain text, so the values are substituted right away
+    if (m_multipleExecute)
+    {
+      m_multipleQueries.push_back(m_pDS->bind_params(strQuery, params));
+      return true;
+    }
+
+    m_pDS->exec(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -306,6 +354,26 @@ bool CDatabase::ResultQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ResultQuery(const std::string &strQuery, const sql_params &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    bReturn = m_pDS->query(strQuery, params);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::QueueInsertQuery(const std::string &strQuery)
 {
   if (strQuery.empty())
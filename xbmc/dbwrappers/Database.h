@@ -29,6 +29,8 @@ namespace dbiplus {
 #include <string>
 #include <vector>
 
+#include "qry_dat.h"
+
 class DatabaseSettings; // forward
 class CDbUrl;
 struct SortDescription;
@@ -110,6 +112,15 @@ public:
    */
   std::string GetSingleValue(const std::string &query, std::unique_ptr<dbiplus::Dataset> &ds);
 
+  /*! \brief Get a single value from a query with ? placeholders.
+   The statement is compiled once per connection and params are bound to it,
+   so hot lookups neither format nor parse SQL on every call.
+   \param query the query in question, without any PrepareSQL formatting.
+   \param params the values for the placeholders, in order.
+   \return the value from the query, empty on failure.
+   */
+  std::string GetSingleValue(const std::string &query, const dbiplus::sql_params &params);
+
   /*!
    * @brief Delete values from a table.
    * @param strTable The table to delete the values from.
@@ -128,6 +139,15 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query with ? placeholders that does not return any result.
+   * @param strQuery The query to execute, without any PrepareSQL formatting.
+   * @param params The values for the placeholders, in order.
+   * @return True if the query was executed successfully, false otherwise.
+   * @sa ExecuteQuery
+   */
+  bool ExecuteQuery(const std::string &strQuery, const dbiplus::sql_params &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -136,6 +156,15 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query with ? placeholders that returns a result.
+   * @remarks Call m_pDS->close(); to clean up the dataset when done.
+   * @param strQuery The query to execute, without any PrepareSQL formatting.
+   * @param params The values for the placeholders, in order.
+   * @return True if the query was executed successfully, false otherwise.
+   */
+  bool ResultQuery(const std::string &strQuery, const dbiplus::sql_params &params);
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
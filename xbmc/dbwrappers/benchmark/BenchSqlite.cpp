@@ -0,0 +1,210 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+using namespace dbiplus;
+
+namespace
+{
+// a cut down movie table in a private in-memory database
+class CBenchDatabase
+{
+public:
+  explicit CBenchDatabase(int rows)
+  {
+    m_db.setDatabase(":memory:");
+    m_db.connect(true);
+    m_ds.reset(m_db.CreateDataset());
+
+    m_ds->exec("CREATE TABLE movie (idMovie INTEGER PRIMARY KEY, title TEXT, plot TEXT, year INTEGER, rating REAL, file TEXT)");
+    m_ds->exec("CREATE INDEX ix_movie_year ON movie (year)");
+    Insert(0, rows);
+  }
+
+  void Insert(int first, int count)
+  {
+    m_db.start_transaction();
+    for (int i = first; i < first + count; i++)
+    {
+      m_ds->exec(m_db.prepare("INSERT INTO movie (idMovie, title, plot, year, rating, file) VALUES (%i, '%s', '%s', %i, %f, '%s')",
+                              i, ("Some Movie " + std::to_string(i)).c_str(),
+                              "A plot that is long enough to be more than a couple of bytes",
+                              1950 + i % 68, 5.0 + (i % 50) / 10.0,
+                              ("/media/movies/Some Movie " + std::to_string(i) + ".mkv").c_str()));
+    }
+    m_db.commit_transaction();
+  }
+
+  void InsertBound(int first, int count)
+  {
+    m_db.start_transaction();
+    for (int i = first; i < first + count; i++)
+    {
+      m_ds->exec("INSERT INTO movie (idMovie, title, plot, year, rating, file) VALUES (?, ?, ?, ?, ?, ?)",
+                 { i, "Some Movie " + std::to_string(i),
+                   "A plot that is long enough to be more than a couple of bytes",
+                   1950 + i % 68, 5.0 + (i % 50) / 10.0,
+                   "/media/movies/Some Movie " + std::to_string(i) + ".mkv" });
+    }
+    m_db.commit_transaction();
+  }
+
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+}
+
+// the pattern of CVideoDatabase::GetMoviesByWhere: one query, then every
+// row is read field by field
+static void BM_Sqlite_QueryAll(benchmark::State& state)
+{
+  const int rows = static_cast<int>(state.range(0));
+  CBenchDatabase db(rows);
+  for (auto _ : state)
+  {
+    db.m_ds->query("SELECT * FROM movie ORDER BY title");
+    while (!db.m_ds->eof())
+    {
+      benchmark::DoNotOptimize(db.m_ds->fv("idMovie").get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv("title").get_asString());
+      benchmark::DoNotOptimize(db.m_ds->fv("plot").get_asString());
+      benchmark::DoNotOptimize(db.m_ds->fv("year").get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv("rating").get_asFloat());
+      benchmark::DoNotOptimize(db.m_ds->fv("file").get_asString());
+      db.m_ds->next();
+    }
+    db.m_ds->close();
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_Sqlite_QueryAll)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// as above, but the rows are read one by one instead of all up front
+static void BM_Sqlite_QueryCursor(benchmark::State& state)
+{
+  const int rows = static_cast<int>(state.range(0));
+  CBenchDatabase db(rows);
+  for (auto _ : state)
+  {
+    db.m_ds->query_cursor("SELECT * FROM movie ORDER BY title");
+    while (!db.m_ds->eof())
+    {
+      benchmark::DoNotOptimize(db.m_ds->fv("idMovie").get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv("title").get_asString());
+      benchmark::DoNotOptimize(db.m_ds->fv("plot").get_asString());
+      benchmark::DoNotOptimize(db.m_ds->fv("year").get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv("rating").get_asFloat());
+      benchmark::DoNotOptimize(db.m_ds->fv("file").get_asString());
+      db.m_ds->next();
+    }
+    db.m_ds->close();
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_Sqlite_QueryCursor)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// per row cost of reading the numeric columns, which are stored typed and
+// never go through a string
+static void BM_Sqlite_QueryRowsTyped(benchmark::State& state)
+{
+  const int rows = static_cast<int>(state.range(0));
+  CBenchDatabase db(rows);
+  for (auto _ : state)
+  {
+    db.m_ds->query("SELECT idMovie, year, rating FROM movie WHERE year>=?", { 0 });
+    while (!db.m_ds->eof())
+    {
+      benchmark::DoNotOptimize(db.m_ds->fv(0).get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv(1).get_asInt());
+      benchmark::DoNotOptimize(db.m_ds->fv(2).get_asDouble());
+      db.m_ds->next();
+    }
+    db.m_ds->close();
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_Sqlite_QueryRowsTyped)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// the pattern of CDatabase::GetSingleValue: many tiny queries, each one
+// formatted and compiled from scratch
+static void BM_Sqlite_QuerySingle(benchmark::State& state)
+{
+  const int rows = 10000;
+  CBenchDatabase db(rows);
+  int id = 0;
+  for (auto _ : state)
+  {
+    db.m_ds->query(db.m_db.prepare("SELECT title FROM movie WHERE idMovie = %i", id++ % rows));
+    benchmark::DoNotOptimize(db.m_ds->fv(0).get_asString());
+    db.m_ds->close();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sqlite_QuerySingle);
+
+// as above, but the statement is compiled once and the id is bound to it
+static void BM_Sqlite_QuerySingleBound(benchmark::State& state)
+{
+  const int rows = 10000;
+  CBenchDatabase db(rows);
+  int id = 0;
+  for (auto _ : state)
+  {
+    db.m_ds->query("SELECT title FROM movie WHERE idMovie=?", { id++ % rows });
+    benchmark::DoNotOptimize(db.m_ds->fv(0).get_asString());
+    db.m_ds->close();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Sqlite_QuerySingleBound);
+
+static void BM_Sqlite_Insert(benchmark::State& state)
+{
+  const int rows = static_cast<int>(state.range(0));
+  CBenchDatabase db(0);
+  int first = 0;
+  for (auto _ : state)
+  {
+    db.Insert(first, rows);
+    first += rows;
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_Sqlite_Insert)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_Sqlite_InsertBound(benchmark::State& state)
+{
+  const int rows = static_cast<int>(state.range(0));
+  CBenchDatabase db(0);
+  int first = 0;
+  for (auto _ : state)
+  {
+    db.InsertBound(first, rows);
+    first += rows;
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_Sqlite_InsertBound)->Arg(1000)->Unit(benchmark::kMillisecond);
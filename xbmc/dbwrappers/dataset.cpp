@@ -28,6 +28,7 @@
 
 #include "dataset.h"
 #include "utils/log.h"
+#include <cstdio>
 #include <cstring>
 #include <algorithm>
 
@@ -202,6 +203,65 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+bool Dataset::query_cursor(const std::string &sql) {
+  return query(sql);
+}
+
+std::string Dataset::bind_params(const std::string &sql, const sql_params &params) {
+  std::string qry;
+  qry.reserve(sql.size());
+  size_t param = 0;
+  char quote = 0;
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    const char c = sql[i];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '\'' || c == '"')
+      quote = c;
+    else if (c == '?')
+    {
+      if (param >= params.size())
+        throw DbErrors("Missing parameter %u for query: %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+      const field_value &value = params[param++];
+      if (value.get_isNull())
+        qry += "NULL";
+      else if (value.get_fType() == ft_String)
+        qry += db->prepare("'%s'", value.get_asString().c_str());
+      else if (value.get_fType() == ft_Boolean)
+        qry += value.get_asBool() ? "1" : "0";
+      else if (value.get_fType() == ft_Float || value.get_fType() == ft_Double || value.get_fType() == ft_LongDouble)
+      {
+        // get_asString() rounds to 6 decimals, keep what a bound double would store
+        char number[32];
+        snprintf(number, sizeof(number), "%.17g", value.get_asDouble());
+        qry += number;
+      }
+      else
+        qry += value.get_asString();
+      continue;
+    }
+    qry += c;
+  }
+  if (param != params.size())
+    throw DbErrors("Too many parameters for query: %s", sql.c_str());
+
+  return qry;
+}
+
+int Dataset::exec(const std::string &sql, const sql_params &params) {
+  return exec(bind_params(sql, params));
+}
+
+bool Dataset::query(const std::string &sql, const sql_params &params) {
+  return query(bind_params(sql, params));
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
@@ -357,7 +417,7 @@ bool Dataset::get_index_map_entry(const char *f_name) {
 }
 /********* INDEXMAP SECTION END *********/
 
-const field_value Dataset::get_field_value(const char *f_name) {
+const field_value& Dataset::get_field_value(const char *f_name) {
   if (ds_state != dsInactive)
   {
     if (ds_state == dsEdit || ds_state == dsInsert){
@@ -390,7 +450,7 @@ const field_value Dataset::get_field_value(const char *f_name) {
   //return fv;
 }
 
-const field_value Dataset::get_field_value(int index) {
+const field_value& Dataset::get_field_value(int index) {
   if (ds_state != dsInactive) {
     if (ds_state == dsEdit || ds_state == dsInsert){
       if (index < 0 || index >= field_count())
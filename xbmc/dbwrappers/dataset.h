@@ -308,6 +308,19 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as exec and query, but with the ? placeholders in sql bound to params.
+   Drivers may keep the compiled statement around for the next call */
+  virtual int  exec (const std::string &sql, const sql_params &params);
+  virtual bool query(const std::string &sql, const sql_params &params);
+/* as query, but opens sql as a forward only cursor: rows are fetched one
+   at a time by next() instead of all up front, so only the current row is
+   held in memory. While it is open num_rows() is 1 until the last row has
+   been passed and seek(), prev() and last() are not supported. Drivers
+   without cursors fetch the whole result like query() */
+  virtual bool query_cursor(const std::string &sql);
+/* Substitutes the ? placeholders in sql with the escaped params, for
+   drivers which do not bind parameters themselves */
+  std::string bind_params(const std::string &sql, const sql_params &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -386,11 +399,11 @@ public:
 //  virtual char *field_name(int f_index) { return field_by_index(f_index)->get_field_name(); };
 
 /* Getting value of field for current record */
-  virtual const field_value get_field_value(const char *f_name);
-  virtual const field_value get_field_value(int index);
+  virtual const field_value& get_field_value(const char *f_name);
+  virtual const field_value& get_field_value(int index);
 /* Alias to get_field_value */
-  const field_value fv(const char *f) { return get_field_value(f); }
-  const field_value fv(int index) { return get_field_value(index); }
+  const field_value& fv(const char *f) { return get_field_value(f); }
+  const field_value& fv(int index) { return get_field_value(index); }
 
 /* ------------ for transaction ------------------- */
   void set_autocommit(bool v) { autocommit = v; }
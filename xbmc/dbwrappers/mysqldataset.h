@@ -146,6 +146,9 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+/* parameterised exec and query substitute the values into the sql text */
+  using Dataset::exec;
+  using Dataset::query;
   virtual const void* getExecRes();
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &query);
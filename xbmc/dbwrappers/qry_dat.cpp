@@ -35,6 +35,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -57,6 +58,13 @@ field_value::field_value(const char *s):
   is_null = false;
 }
   
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  is_null = false;
+}
+
 field_value::field_value(const bool b) {
   bool_value = b; 
   field_type = ft_Boolean;
@@ -111,52 +119,23 @@ field_value::field_value(const int64_t i) {
   is_null = false;
 }
 
-field_value::field_value (const field_value & fv) {
-  switch (fv.get_fType()) {
-    case ft_String: {
-      set_asString(fv.get_asString());
-      break;
-    }
-    case ft_Boolean:{
-      set_asBool(fv.get_asBool());
-      break;     
-    }
-    case ft_Char: {
-      set_asChar(fv.get_asChar());
-      break;
-    }
-    case ft_Short: {
-      set_asShort(fv.get_asShort());
-      break;
-    }
-    case ft_UShort: {
-      set_asUShort(fv.get_asUShort());
-      break;
-    }
-    case ft_Int: {
-      set_asInt(fv.get_asInt());
-      break;
-    }
-    case ft_UInt: {
-      set_asUInt(fv.get_asUInt());
-      break;
-    }
-    case ft_Float: {
-      set_asFloat(fv.get_asFloat());
-      break;
-    }
-    case ft_Double: {
-      set_asDouble(fv.get_asDouble());
-      break;
-    }
-    case ft_Int64: {
-      set_asInt64(fv.get_asInt64());
-      break;
-    }
-    default:
-      break;
-  }
-  is_null = fv.get_isNull();
+// the union is copied as a whole, only strings need more than that
+field_value::field_value (const field_value & fv) :
+  field_type(fv.field_type),
+  is_null(fv.is_null)
+{
+  if (field_type == ft_String)
+    str_value = fv.str_value;
+  else
+    memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
+}
+
+field_value::field_value (field_value && fv) :
+  field_type(fv.field_type),
+  str_value(std::move(fv.str_value)),
+  is_null(fv.is_null)
+{
+  memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
 }
 
 
@@ -587,63 +566,24 @@ int64_t field_value::get_asInt64() const {
 
 field_value& field_value::operator= (const field_value & fv) {
   if ( this == &fv ) return *this;
-  
-  is_null = fv.get_isNull();
 
-  switch (fv.get_fType()) {
-    case ft_String: {
-      set_asString(fv.get_asString());
-      return *this;
-      break;
-    }
-    case ft_Boolean:{
-      set_asBool(fv.get_asBool());
-      return *this;
-      break;     
-    }
-    case ft_Char: {
-      set_asChar(fv.get_asChar());
-      return *this;
-      break;
-    }
-    case ft_Short: {
-      set_asShort(fv.get_asShort());
-      return *this;
-      break;
-    }
-    case ft_UShort: {
-      set_asUShort(fv.get_asUShort());
-      return *this;
-      break;
-    }
-    case ft_Int: {
-      set_asInt(fv.get_asInt());
-      return *this;
-      break;
-    }
-    case ft_UInt: {
-      set_asUInt(fv.get_asUInt());
-      return *this;
-      break;
-    }
-    case ft_Float: {
-      set_asFloat(fv.get_asFloat());
-      return *this;
-      break;
-    }
-    case ft_Double: {
-      set_asDouble(fv.get_asDouble());
-      return *this;
-      break;
-    }
-    case ft_Int64: {
-      set_asInt64(fv.get_asInt64());
-      return *this;
-      break;
-    }
-    default:
-      return *this;
-    }
+  field_type = fv.field_type;
+  is_null = fv.is_null;
+  if (field_type == ft_String)
+    str_value = fv.str_value;
+  else
+    memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
+  return *this;
+}
+
+field_value& field_value::operator= (field_value && fv) {
+  if ( this == &fv ) return *this;
+
+  field_type = fv.field_type;
+  is_null = fv.is_null;
+  str_value = std::move(fv.str_value);
+  memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
+  return *this;
 }
 
 
@@ -656,6 +596,10 @@ void field_value::set_asString(const char *s) {
 void field_value::set_asString(const std::string & s) {
   str_value = s;
   field_type = ft_String;}
+
+void field_value::set_asString(const char *s, size_t len) {
+  str_value.assign(s, len);
+  field_type = ft_String;}
   
 void field_value::set_asBool(const bool b) {
   bool_value = b; 
@@ -77,6 +77,7 @@ private:
 public:
   field_value();
   field_value(const char *s);
+  field_value(const std::string &s);
   field_value(const bool b);
   field_value(const char c);
   field_value(const short s);
@@ -87,6 +88,7 @@ public:
   field_value(const double d);
   field_value(const int64_t i);
   field_value(const field_value & fv);
+  field_value(field_value && fv);
   ~field_value();
 
   fType get_fType() const {return field_type;}
@@ -123,6 +125,7 @@ public:
   field_value& operator= (const int64_t i)
     {set_asInt64(i); return *this;}
   field_value& operator= (const field_value & fv);
+  field_value& operator= (field_value && fv);
   
   //class ostream;
   friend std::ostream& operator<< (std::ostream& os, const field_value &fv)
@@ -177,6 +180,7 @@ public:
   void set_isNull(){is_null=true;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
+  void set_asString(const char *s, size_t len);
   void set_asBool(const bool b);
   void set_asChar(const char c);
   void set_asShort(const short s);
@@ -209,6 +213,8 @@ struct field {
 
 typedef std::vector<field> Fields;
 typedef std::vector<field_value> sql_record;
+/* values bound to the ? placeholders of a statement, in order */
+typedef std::vector<field_value> sql_params;
 typedef std::vector<field_prop> record_prop;
 typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
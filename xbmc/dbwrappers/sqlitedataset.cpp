@@ -77,6 +77,8 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
   return 0;  
 }
 
+#define MAX_CACHED_STATEMENTS 64
+
 static int busy_callback(void*, int busyCount)
 {
   Sleep(100);
@@ -132,6 +134,10 @@ void SqliteDatabase::setHostName(const char *newHost) {
 void SqliteDatabase::setDatabase(const char *newDb) {
   db = newDb;
 
+  // an in-memory database is opened by its special name, leave it alone
+  if (db == ":memory:")
+    return;
+
   // db is the filename for the database, ensure it's not slash prefixed
   if (newDb[0] == '/' || newDb[0] == '\\')
     db = db.substr(1);
@@ -204,12 +210,14 @@ const char *SqliteDatabase::getErrorMsg() {
 }
 
 int SqliteDatabase::connect(bool create) {
-  if (host.empty() || db.empty())
+  // ":memory:" opens a private in-memory database, there is no host for it
+  const bool inMemory = db == ":memory:";
+  if ((host.empty() && !inMemory) || db.empty())
     return DB_CONNECTION_NONE;
 
   //CLog::Log(LOGDEBUG, "Connecting to sqlite:%s:%s", host.c_str(), db.c_str());
 
-  std::string db_fullpath = URIUtils::AddFileToFolder(host, db);
+  std::string db_fullpath = inMemory ? db : URIUtils::AddFileToFolder(host, db);
 
   try
   {
@@ -257,6 +265,8 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  // sqlite refuses to close a connection with unfinalized statements
+  finalize_statements();
   sqlite3_close(conn);
   active = false;
 }
@@ -444,11 +454,45 @@ std::string SqliteDatabase::vprepare(const char *format, va_list args)
 }
 
 
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql)
+{
+  std::map<std::string, sqlite3_stmt*>::const_iterator it = statements.find(sql);
+  if (it != statements.end())
+    return it->second;
+
+  if (!active)
+    throw DbErrors("No Database Connection");
+
+  // queries built at runtime could grow the cache without bounds
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    finalize_statements();
+
+  sqlite3_stmt *stmt = NULL;
+  const int err = sqlite3_prepare_v2(conn, sql.c_str(), sql.size(), &stmt, NULL);
+  if (err != SQLITE_OK || stmt == NULL)
+  {
+    setErr(err != SQLITE_OK ? err : SQLITE_ERROR, sql.c_str());
+    throw DbErrors(getErrorMsg());
+  }
+
+  statements.insert(std::make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::finalize_statements()
+{
+  for (std::map<std::string, sqlite3_stmt*>::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
+}
+
+
 //************* SqliteDataset implementation ***************
 
 SqliteDataset::SqliteDataset():Dataset() {
   haveError = false;
   db = NULL;
+  cursor = NULL;
   errmsg = NULL;
   autorefresh = false;
 }
@@ -457,11 +501,13 @@ SqliteDataset::SqliteDataset():Dataset() {
 SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   haveError = false;
   db = newDb;
+  cursor = NULL;
   errmsg = NULL;
   autorefresh = false;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (cursor) sqlite3_finalize(cursor);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -627,6 +673,25 @@ int SqliteDataset::exec(const std::string &sql) {
     }
 }
 
+int SqliteDataset::exec(const std::string &sql, const sql_params &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  bind_statement(stmt, params, sql);
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+    ;
+
+  const int err = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (err != SQLITE_OK)
+  {
+    db->setErr(err, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
 int SqliteDataset::exec() {
   return exec(sql);
 }
@@ -636,57 +701,145 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    std::string qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))                                 
-         throw DbErrors("MUST be select SQL!"); 
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors(db->getErrorMsg());
-
-  // column headers
+void SqliteDataset::fetch_header(sqlite3_stmt *stmt) {
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
+}
+
+void SqliteDataset::fetch_row(sqlite3_stmt *stmt, sql_record &rec) {
+  const unsigned int numColumns = rec.size();
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec[i];
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i), sqlite3_column_bytes(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
+  fetch_header(stmt);
 
   // returned rows
+  const unsigned int numColumns = result.record_header.size();
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
+    sql_record *res = new sql_record(numColumns);
+    fetch_row(stmt, *res);
+    result.records.push_back(res);
+  }
+}
+
+bool SqliteDataset::step_cursor() {
+  const int err = sqlite3_step(cursor);
+  if (err == SQLITE_ROW)
+  {
+    // the one record is refilled for every row
+    if (result.records.empty())
+      result.records.push_back(new sql_record(result.record_header.size()));
+    fetch_row(cursor, *result.records[0]);
+    return true;
+  }
+
+  if (err != SQLITE_DONE)
+    db->setErr(err, sqlite3_sql(cursor));
+
+  sqlite3_finalize(cursor);
+  cursor = NULL;
+  for (unsigned int i = 0; i < result.records.size(); i++)
+    delete result.records[i];
+  result.records.clear();
+
+  if (err != SQLITE_DONE)
+    throw DbErrors(db->getErrorMsg());
+  return false;
+}
+
+void SqliteDataset::bind_statement(sqlite3_stmt *stmt, const sql_params &params, const std::string &sql) {
+  // a previous caller may have left it half stepped, e.g. on an exception
+  sqlite3_reset(stmt);
+
+  if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size()))
+    throw DbErrors("Expected %d parameters, got %u for query: %s", sqlite3_bind_parameter_count(stmt),
+                   static_cast<unsigned int>(params.size()), sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    const int idx = i + 1;
+    int err;
+    if (v.get_isNull())
+      err = sqlite3_bind_null(stmt, idx);
+    else
     {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
+      switch (v.get_fType())
       {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+        err = sqlite3_bind_int(stmt, idx, v.get_asInt());
         break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      case ft_UInt:
+      case ft_Int64:
+        err = sqlite3_bind_int64(stmt, idx, v.get_asInt64());
         break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      case ft_Float:
+      case ft_Double:
+        err = sqlite3_bind_double(stmt, idx, v.get_asDouble());
         break;
-      case SQLITE_NULL:
       default:
-        v.set_asString("");
-        v.set_isNull();
+      {
+        const std::string str = v.get_asString();
+        err = sqlite3_bind_text(stmt, idx, str.c_str(), str.size(), SQLITE_TRANSIENT);
         break;
       }
+      }
+    }
+    if (err != SQLITE_OK)
+    {
+      db->setErr(err, sql.c_str());
+      sqlite3_clear_bindings(stmt);
+      throw DbErrors(db->getErrorMsg());
     }
-    result.records.push_back(res);
   }
+}
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    std::string qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    if (!( fs >= 0 || fS >=0))                                 
+         throw DbErrors("MUST be select SQL!"); 
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  fetch_rows(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -700,6 +853,50 @@ bool SqliteDataset::query(const std::string &query) {
   }  
 }
 
+bool SqliteDataset::query(const std::string &query, const sql_params &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(query);
+  bind_statement(stmt, params, query);
+  fetch_rows(stmt);
+
+  // the statement stays cached, so only reset it for the next caller
+  const int err = sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  if (err != SQLITE_OK)
+  {
+    db->setErr(err, query.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_cursor(const std::string &query) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &cursor, NULL), query.c_str()) != SQLITE_OK)
+  {
+    cursor = NULL;
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  fetch_header(cursor);
+  step_cursor();
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -716,6 +913,11 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  if (cursor)
+  {
+    sqlite3_finalize(cursor);
+    cursor = NULL;
+  }
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -766,6 +968,15 @@ void SqliteDataset::prev(void) {
 }
 
 void SqliteDataset::next(void) {
+  if (cursor && ds_state == dsSelect)
+  {
+    fbof = false;
+    if (step_cursor())
+      fill_fields();
+    else
+      feof = true;
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
@@ -29,6 +29,7 @@
  **********************************************************************/
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -44,6 +45,10 @@ protected:
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
+/* compiled statements of parameterised queries, keyed by their sql */
+  std::map<std::string, sqlite3_stmt*> statements;
+
+  void finalize_statements();
 
 public:
 /* default constructor */
@@ -94,6 +99,10 @@ public:
 /* virtual methods for formatting */
   virtual std::string vprepare(const char *format, va_list args);
 
+/* returns the compiled statement for sql, it stays cached (and owned by
+   the database) until the connection is closed */
+  sqlite3_stmt *get_statement(const std::string &sql);
+
   bool in_transaction() {return _in_transaction;}; 	
 
 };
@@ -109,6 +118,8 @@ public:
 class SqliteDataset : public Dataset {
 protected:
   sqlite3* handle();
+/* statement of an open query_cursor(), NULL once all rows are read */
+  sqlite3_stmt *cursor;
 
 /* Makes direct queries to database */
   virtual void make_query(StringList &_sql);
@@ -127,6 +138,18 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Reads the column names of stmt into the result set header */
+  void fetch_header(sqlite3_stmt *stmt);
+/* Reads the current row of stmt into rec */
+  void fetch_row(sqlite3_stmt *stmt, sql_record &rec);
+/* Reads the header and all rows of stmt into the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* Steps the open cursor into the single record of the result set.
+   Returns false and finalizes the cursor when there are no more rows */
+  bool step_cursor();
+/* Binds params to the ? placeholders of the cached statement stmt */
+  void bind_statement(sqlite3_stmt *stmt, const sql_params &params, const std::string &sql);
+
 public:
 /* constructor */
   SqliteDataset();
@@ -145,9 +168,12 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   virtual int  exec ();
   virtual int  exec (const std::string &sql);
+  virtual int  exec (const std::string &sql, const sql_params &params);
   virtual const void* getExecRes();
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &query, const sql_params &params);
+  virtual bool query_cursor(const std::string &query);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
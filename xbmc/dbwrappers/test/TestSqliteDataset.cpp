@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  TestSqliteDataset()
+  {
+    db.setDatabase(":memory:");
+    db.connect(true);
+    ds.reset(db.CreateDataset());
+    ds->exec("CREATE TABLE path (idPath INTEGER PRIMARY KEY, strPath TEXT, rating REAL, flag INTEGER)");
+  }
+
+  SqliteDatabase db;
+  std::unique_ptr<Dataset> ds;
+};
+
+TEST_F(TestSqliteDataset, BoundParameters)
+{
+  // the quote would have to be escaped if it was formatted into the sql
+  const std::string path = "/media/it's here/";
+  for (int i = 0; i < 3; i++)
+    ds->exec("INSERT INTO path (idPath, strPath, rating, flag) VALUES (NULL, ?, ?, ?)", { path + std::to_string(i), 1.5 * i, i == 1 });
+
+  // the cached statement is executed a second time with other values
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(ds->query("SELECT idPath, strPath, rating, flag FROM path WHERE strPath=?", { path + std::to_string(i) }));
+    ASSERT_EQ(1, ds->num_rows());
+    EXPECT_EQ(ft_Int64, ds->fv(0).get_fType());
+    EXPECT_EQ(i + 1, ds->fv("idPath").get_asInt());
+    EXPECT_EQ(ft_String, ds->fv(1).get_fType());
+    EXPECT_EQ(path + std::to_string(i), ds->fv("strPath").get_asString());
+    EXPECT_EQ(ft_Double, ds->fv(2).get_fType());
+    EXPECT_DOUBLE_EQ(1.5 * i, ds->fv("rating").get_asDouble());
+    EXPECT_EQ(i == 1, ds->fv("flag").get_asBool());
+    ds->close();
+  }
+
+  field_value null;
+  null.set_isNull();
+  ds->exec("UPDATE path SET strPath=? WHERE idPath=?", { null, 2 });
+  ASSERT_TRUE(ds->query("SELECT strPath FROM path WHERE idPath=?", { 2 }));
+  EXPECT_TRUE(ds->fv(0).get_isNull());
+  ds->close();
+
+  ASSERT_TRUE(ds->query("SELECT idPath FROM path WHERE strPath=?", { "/not/there/" }));
+  EXPECT_TRUE(ds->eof());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, ParameterMismatch)
+{
+  EXPECT_THROW(ds->query("SELECT idPath FROM path WHERE strPath=?", {}), DbErrors);
+  EXPECT_THROW(ds->query("SELECT idPath FROM path WHERE idPath=?", { 1, 2 }), DbErrors);
+  EXPECT_THROW(ds->query("SELECT idPath FROM nonexisting WHERE idPath=?", { 1 }), DbErrors);
+
+  // the statement is still usable after a failed call
+  ASSERT_TRUE(ds->query("SELECT idPath FROM path WHERE idPath=?", { 1 }));
+  EXPECT_TRUE(ds->eof());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, Cursor)
+{
+  for (int i = 0; i < 5; i++)
+    ds->exec("INSERT INTO path (idPath, strPath) VALUES (?, ?)", { i + 1, "/media/" + std::to_string(i) + "/" });
+
+  ASSERT_TRUE(ds->query_cursor("SELECT idPath, strPath FROM path ORDER BY idPath"));
+  int rows = 0;
+  for (; !ds->eof(); ds->next(), rows++)
+  {
+    // only the current row is held by the dataset
+    EXPECT_EQ(1, ds->num_rows());
+    EXPECT_EQ(rows + 1, ds->fv("idPath").get_asInt());
+    EXPECT_EQ("/media/" + std::to_string(rows) + "/", ds->get_sql_record()->at(1).get_asString());
+  }
+  EXPECT_EQ(5, rows);
+  EXPECT_EQ(0, ds->num_rows());
+  ds->close();
+
+  // closing a cursor before the last row releases it for the next query
+  ASSERT_TRUE(ds->query_cursor("SELECT idPath FROM path ORDER BY idPath"));
+  EXPECT_EQ(1, ds->fv(0).get_asInt());
+  ds->close();
+  ds->exec("DELETE FROM path");
+
+  ASSERT_TRUE(ds->query_cursor("SELECT idPath FROM path"));
+  EXPECT_TRUE(ds->eof());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, TextSubstitution)
+{
+  EXPECT_EQ("SELECT * FROM path WHERE strPath='it''s' AND idPath=3 AND strPath<>'?'",
+            ds->bind_params("SELECT * FROM path WHERE strPath=? AND idPath=? AND strPath<>'?'", { "it's", 3 }));
+  EXPECT_EQ("SELECT * FROM bookmark WHERE timeInSeconds=1234.5678901234569",
+            ds->bind_params("SELECT * FROM bookmark WHERE timeInSeconds=?", { 1234.56789012345678 }));
+  EXPECT_THROW(ds->bind_params("SELECT * FROM path WHERE idPath=?", {}), DbErrors);
+  EXPECT_THROW(ds->bind_params("SELECT * FROM path", { 1 }), DbErrors);
+}
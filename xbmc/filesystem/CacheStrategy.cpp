@@ -18,6 +18,7 @@
  *
  */
 
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "CacheStrategy.h"
 #include "IFile.h"
@@ -283,132 +284,172 @@ CCacheStrategy *CSimpleFileCache::CreateNew()
 }
 
 
-CDoubleCache::CDoubleCache(CCacheStrategy *impl)
+CSegmentedCache::CSegmentedCache(CCacheStrategy *impl, unsigned int maxSegments /* = 2 */)
+  : m_maxSegments(std::max(maxSegments, 1U))
 {
   assert(NULL != impl);
-  m_pCache = impl;
-  m_pCacheOld = NULL;
+  // never reallocated, a segment pointer read while another is added stays valid
+  m_segments.reserve(m_maxSegments);
+  m_segments.push_back(impl);
 }
 
-CDoubleCache::~CDoubleCache()
+CSegmentedCache::~CSegmentedCache()
 {
-  delete m_pCache;
-  delete m_pCacheOld;
+  for (CCacheStrategy* segment : m_segments)
+    delete segment;
 }
 
-int CDoubleCache::Open()
+unsigned int CSegmentedCache::GetSegmentCount() const
 {
-  return m_pCache->Open();
+  CSingleLock lock(m_section);
+  return m_segments.size();
 }
 
-void CDoubleCache::Close()
+CCacheStrategy *CSegmentedCache::Active()
 {
-  m_pCache->Close();
-  if (m_pCacheOld)
-  {
-    delete m_pCacheOld;
-    m_pCacheOld = NULL;
-  }
+  // segments are only deleted by Close(), so the pointer can be used without the lock
+  CSingleLock lock(m_section);
+  return m_segments.front();
+}
+
+int CSegmentedCache::Open()
+{
+  return Active()->Open();
 }
 
-size_t CDoubleCache::GetMaxWriteSize(const size_t& iRequestSize)
+void CSegmentedCache::Close()
 {
-  return m_pCache->GetMaxWriteSize(iRequestSize); // NOTE: Check the active cache only
+  CSingleLock lock(m_section);
+  m_segments.front()->Close();
+  for (size_t i = 1; i < m_segments.size(); i++)
+    delete m_segments[i];
+  m_segments.resize(1);
 }
 
-int CDoubleCache::WriteToCache(const char *pBuffer, size_t iSize)
+size_t CSegmentedCache::GetMaxWriteSize(const size_t& iRequestSize)
 {
-  return m_pCache->WriteToCache(pBuffer, iSize);
+  return Active()->GetMaxWriteSize(iRequestSize); // NOTE: Check the active cache only
 }
 
-int CDoubleCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+int CSegmentedCache::WriteToCache(const char *pBuffer, size_t iSize)
 {
-  return m_pCache->ReadFromCache(pBuffer, iMaxSize);
+  return Active()->WriteToCache(pBuffer, iSize);
 }
 
-int64_t CDoubleCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+int CSegmentedCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
 {
-  return m_pCache->WaitForData(iMinAvail, iMillis);
+  return Active()->ReadFromCache(pBuffer, iMaxSize);
 }
 
-int64_t CDoubleCache::Seek(int64_t iFilePosition)
+int64_t CSegmentedCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
 {
-  /* Check whether position is NOT in our current cache but IS in our old cache.
-   * This is faster/more efficient than having to possibly wait for data in the
-   * Seek() call below
+  return Active()->WaitForData(iMinAvail, iMillis);
+}
+
+int64_t CSegmentedCache::Seek(int64_t iFilePosition)
+{
+  /* Check whether position is NOT in our current cache but IS in another
+   * segment. This is faster/more efficient than having to possibly wait for
+   * data in the Seek() call below
    */
-  if (!m_pCache->IsCachedPosition(iFilePosition) &&
-       m_pCacheOld && m_pCacheOld->IsCachedPosition(iFilePosition))
+  CSingleLock lock(m_section);
+  if (!m_segments.front()->IsCachedPosition(iFilePosition))
   {
-    return CACHE_RC_ERROR; // Request seek event, so caches are swapped
+    for (size_t i = 1; i < m_segments.size(); i++)
+    {
+      if (m_segments[i]->IsCachedPosition(iFilePosition))
+        return CACHE_RC_ERROR; // Request seek event, so segments are swapped
+    }
   }
 
-  return m_pCache->Seek(iFilePosition); // Normal seek
+  CCacheStrategy *active = m_segments.front();
+  lock.Leave();
+  return active->Seek(iFilePosition); // Normal seek, may wait for data
+}
+
+void CSegmentedCache::Activate(size_t segment)
+{
+  std::rotate(m_segments.begin(), m_segments.begin() + segment, m_segments.begin() + segment + 1);
 }
 
-bool CDoubleCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+bool CSegmentedCache::Reset(int64_t iSourcePosition, bool clearAnyway)
 {
-  if (!clearAnyway && m_pCache->IsCachedPosition(iSourcePosition)
-      && (!m_pCacheOld || !m_pCacheOld->IsCachedPosition(iSourcePosition)
-          || m_pCache->CachedDataEndPos() >= m_pCacheOld->CachedDataEndPos()))
+  CSingleLock lock(m_section);
+  if (!clearAnyway)
   {
-    return m_pCache->Reset(iSourcePosition, clearAnyway);
+    // continue with the segment that has the most data from that position on,
+    // CachedDataEndPosIfSeekTo() promised its end to the caller
+    size_t best = m_segments.size();
+    for (size_t i = 0; i < m_segments.size(); i++)
+    {
+      if (m_segments[i]->IsCachedPosition(iSourcePosition) &&
+          (best == m_segments.size() || m_segments[i]->CachedDataEndPos() > m_segments[best]->CachedDataEndPos()))
+        best = i;
+    }
+    if (best < m_segments.size())
+    {
+      Activate(best);
+      return m_segments.front()->Reset(iSourcePosition, clearAnyway);
+    }
   }
-  if (!m_pCacheOld)
+
+  if (m_segments.size() < m_maxSegments)
   {
-    CCacheStrategy *pCacheNew = m_pCache->CreateNew();
-    if (pCacheNew->Open() != CACHE_RC_OK)
+    CCacheStrategy *pCacheNew = m_segments.front()->CreateNew();
+    if (pCacheNew->Open() == CACHE_RC_OK)
     {
-      delete pCacheNew;
-      return m_pCache->Reset(iSourcePosition, clearAnyway);
+      m_segments.insert(m_segments.begin(), pCacheNew);
+      return pCacheNew->Reset(iSourcePosition, clearAnyway);
     }
-    bool bRes = pCacheNew->Reset(iSourcePosition, clearAnyway);
-    m_pCacheOld = m_pCache;
-    m_pCache = pCacheNew;
-    return bRes;
+    delete pCacheNew;
   }
-  bool bRes = m_pCacheOld->Reset(iSourcePosition, clearAnyway);
-  CCacheStrategy *tmp = m_pCacheOld;
-  m_pCacheOld = m_pCache;
-  m_pCache = tmp;
-  return bRes;
+
+  // recycle the least recently used segment, or the only one
+  Activate(m_segments.size() - 1);
+  return m_segments.front()->Reset(iSourcePosition, clearAnyway);
 }
 
-void CDoubleCache::EndOfInput()
+void CSegmentedCache::EndOfInput()
 {
-  m_pCache->EndOfInput();
+  Active()->EndOfInput();
 }
 
-bool CDoubleCache::IsEndOfInput()
+bool CSegmentedCache::IsEndOfInput()
 {
-  return m_pCache->IsEndOfInput();
+  return Active()->IsEndOfInput();
 }
 
-void CDoubleCache::ClearEndOfInput()
+void CSegmentedCache::ClearEndOfInput()
 {
-  m_pCache->ClearEndOfInput();
+  Active()->ClearEndOfInput();
 }
 
-int64_t CDoubleCache::CachedDataEndPos()
+int64_t CSegmentedCache::CachedDataEndPos()
 {
-  return m_pCache->CachedDataEndPos();
+  return Active()->CachedDataEndPos();
 }
 
-int64_t CDoubleCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+int64_t CSegmentedCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
 {
-  int64_t ret = m_pCache->CachedDataEndPosIfSeekTo(iFilePosition);
-  if (m_pCacheOld)
-    return std::max(ret, m_pCacheOld->CachedDataEndPosIfSeekTo(iFilePosition));
+  CSingleLock lock(m_section);
+  int64_t ret = iFilePosition;
+  for (CCacheStrategy* segment : m_segments)
+    ret = std::max(ret, segment->CachedDataEndPosIfSeekTo(iFilePosition));
   return ret;
 }
 
-bool CDoubleCache::IsCachedPosition(int64_t iFilePosition)
+bool CSegmentedCache::IsCachedPosition(int64_t iFilePosition)
 {
-  return m_pCache->IsCachedPosition(iFilePosition) || (m_pCacheOld && m_pCacheOld->IsCachedPosition(iFilePosition));
+  CSingleLock lock(m_section);
+  for (CCacheStrategy* segment : m_segments)
+  {
+    if (segment->IsCachedPosition(iFilePosition))
+      return true;
+  }
+  return false;
 }
 
-CCacheStrategy *CDoubleCache::CreateNew()
+CCacheStrategy *CSegmentedCache::CreateNew()
 {
-  return new CDoubleCache(m_pCache->CreateNew());
+  return new CSegmentedCache(Active()->CreateNew(), m_maxSegments);
 }
-
@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
 namespace XFILE {
@@ -111,10 +113,20 @@ protected:
   volatile int64_t m_nReadPosition;
 };
 
-class CDoubleCache : public CCacheStrategy{
+/*!
+ \brief Keeps several disjoint ranges of a file cached
+
+ Every segment is a cache strategy of its own, only the active one is read
+ from and written to. A seek to a range that another segment still holds
+ makes that segment the active one, a seek to an uncached position gets a
+ new segment until there are maxSegments, after that the least recently
+ used one is recycled. That way e.g. the index of a file and the current
+ playback position stay cached side by side.
+ */
+class CSegmentedCache : public CCacheStrategy{
 public:
-  CDoubleCache(CCacheStrategy *impl);
-  virtual ~CDoubleCache();
+  CSegmentedCache(CCacheStrategy *impl, unsigned int maxSegments = 2);
+  virtual ~CSegmentedCache();
 
   virtual int Open() ;
   virtual void Close() ;
@@ -136,9 +148,20 @@ public:
 
   virtual CCacheStrategy *CreateNew();
 
+  unsigned int GetSegmentCount() const;
+
 protected:
-  CCacheStrategy *m_pCache;
-  CCacheStrategy *m_pCacheOld;
+  void Activate(size_t segment);
+  CCacheStrategy *Active();
+
+  /*!
+   \brief Guards the order of m_segments
+   The cache thread reorders the segments on seeks, while the reader asks
+   the active one for its status, see IOCTRL_CACHE_STATUS.
+   */
+  mutable CCriticalSection m_section;
+  std::vector<CCacheStrategy*> m_segments; ///< the active segment first, then the others by last use
+  unsigned int m_maxSegments;
 };
 
 }
@@ -25,6 +25,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "PersistentDirectoryCache.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -165,7 +166,22 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
 
       pDirectory->SetFlags(hints.flags);
 
+      // listings of network shares are kept on disk as long as the directory
+      // reports the same modification time, so scans and browsing of an
+      // unchanged folder cost a stat instead of a listing
+      int64_t modified = 0;
+      bool persistent = !(hints.flags & DIR_FLAG_BYPASS_CACHE) &&
+                        CPersistentDirectoryCache::GetInstance().GetModificationTime(realURL, modified);
+
       bool result = false, cancel = false;
+      if (persistent &&
+          CPersistentDirectoryCache::GetInstance().GetDirectory(realURL, modified, hints.flags, items))
+      {
+        items.SetURL(url);
+        result = true;
+        persistent = false;
+      }
+
       while (!result && !cancel)
       {
         const std::string pathToUrl(url.Get());
@@ -201,6 +217,8 @@ bool CDirectory::GetDirectory(const CURL& url, CFileItemList &items, const CHint
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+      if (persistent)
+        CPersistentDirectoryCache::GetInstance().SetDirectory(realURL, modified, hints.flags, items);
     }
 
     // now filter for allowed files
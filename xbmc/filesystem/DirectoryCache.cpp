@@ -20,24 +20,29 @@
 
 #include "DirectoryCache.h"
 #include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #include "URL.h"
-#include "climits"
+#include "video/VideoInfoTag.h"
 
-#include <algorithm>
+#include <iterator>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Default budget for the cached listings, see advancedsettings <directorycache>
+#define DEFAULT_MEMORY_LIMIT (16 * 1024 * 1024)
+// shared_ptr control block plus the node of the fast lookup map per item
+#define ITEM_OVERHEAD 96
 
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
+  m_size = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
@@ -48,22 +53,18 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
-{
-  m_lastAccess = accessCounter++;
-}
-
 CDirectoryCache::CDirectoryCache(void)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
+  m_memoryUsed = 0;
+  m_memoryLimit = DEFAULT_MEMORY_LIMIT;
   m_cacheHits = 0;
   m_cacheMisses = 0;
-#endif
+  m_evictions = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void)
 {
+  Clear();
 }
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
@@ -74,21 +75,20 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  iCache i = Find(storedPath);
+  if (i != m_lru.end())
   {
     CDir* dir = i->second;
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      Touch(i);
+      m_cacheHits++;
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -116,12 +116,22 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
+  size_t size = GetItemListSize(items) + storedPath.capacity();
+  if (size > m_memoryLimit)
+  {
+    CLog::Log(LOGDEBUG, "%s - not caching %s, %zu bytes exceed the limit of %zu bytes", __FUNCTION__,
+              CURL::GetRedacted(storedPath).c_str(), size, m_memoryLimit);
+    return;
+  }
 
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  dir->m_size = size;
+  m_lru.push_front(std::make_pair(storedPath, dir));
+  m_cache[storedPath] = m_lru.begin();
+  m_memoryUsed += size;
+
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -140,8 +150,8 @@ void CDirectoryCache::ClearDirectory(const std::string& strPath)
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  iCache i = Find(storedPath);
+  if (i != m_lru.end())
     Delete(i);
 }
 
@@ -152,11 +162,11 @@ void CDirectoryCache::ClearSubPaths(const std::string& strPath)
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  iCache i = m_lru.begin();
+  while (i != m_lru.end())
   {
     if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
+      i = Delete(i);
     else
       i++;
   }
@@ -170,13 +180,17 @@ void CDirectoryCache::AddFile(const std::string& strFile)
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  iCache i = Find(strPath);
+  if (i != m_lru.end())
   {
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    size_t size = sizeof(CFileItem) + ITEM_OVERHEAD + 2 * item->GetPath().capacity() + item->GetLabel().capacity();
+    dir->m_size += size;
+    m_memoryUsed += size;
+    Touch(i);
+    CheckIfFull();
   }
 }
 
@@ -191,20 +205,16 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  iCache i = Find(storedPath);
+  if (i != m_lru.end())
   {
     bInCache = true;
     CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
+    Touch(i);
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
@@ -213,9 +223,55 @@ void CDirectoryCache::Clear()
   // this routine clears everything
   CSingleLock lock (m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+  iCache i = m_lru.begin();
+  while (i != m_lru.end() )
+    i = Delete(i);
+}
+
+void CDirectoryCache::SetMemoryLimit(size_t memoryLimit)
+{
+  CSingleLock lock (m_cs);
+  m_memoryLimit = memoryLimit;
+  CheckIfFull();
+}
+
+void CDirectoryCache::OnSettingsLoaded()
+{
+  SetMemoryLimit(g_advancedSettings.m_directoryCacheMemSize);
+}
+
+SDirectoryCacheStats CDirectoryCache::GetStats() const
+{
+  CSingleLock lock (m_cs);
+  SDirectoryCacheStats stats;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.evictions = m_evictions;
+  stats.directories = m_cache.size();
+  stats.memoryUsed = m_memoryUsed;
+  stats.memoryLimit = m_memoryLimit;
+  return stats;
+}
+
+size_t CDirectoryCache::GetItemListSize(const CFileItemList &items)
+{
+  // only a rough estimate: the strings every item has plus the tags, which
+  // are the bulk of a listing coming from a library or an add-on
+  size_t size = sizeof(CDir) + sizeof(CFileItemList) + items.GetPath().capacity();
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    // the fast lookup map holds a second copy of the path
+    size += sizeof(CFileItem) + ITEM_OVERHEAD + 2 * item->GetPath().capacity() +
+            item->GetLabel().capacity() + item->GetLabel2().capacity();
+    if (item->HasVideoInfoTag())
+      size += sizeof(CVideoInfoTag);
+    if (item->HasMusicInfoTag())
+      size += sizeof(MUSIC_INFO::CMusicInfoTag);
+    if (item->HasPictureInfoTag())
+      size += sizeof(CPictureInfoTag);
+  }
+  return size;
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -232,11 +288,11 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  iCache i = m_lru.begin();
+  while (i != m_lru.end())
   {
     if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
+      i = Delete(i);
     else
       i++;
   }
@@ -246,46 +302,57 @@ void CDirectoryCache::CheckIfFull()
 {
   CSingleLock lock (m_cs);
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // evict from the least recently used end. Listings that are always cached
+  // are expensive to recreate (archives) and only go in the second pass.
+  for (int pass = 0; pass < 2 && m_memoryUsed > m_memoryLimit; pass++)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    iCache i = m_lru.end();
+    while (i != m_lru.begin() && m_memoryUsed > m_memoryLimit)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      iCache victim = std::prev(i);
+      if (pass == 0 && victim->second->m_cacheType == DIR_CACHE_ALWAYS)
+      {
+        i = victim;
+        continue;
+      }
+      Delete(victim);
+      m_evictions++;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+CDirectoryCache::iCache CDirectoryCache::Find(const std::string& storedPath)
+{
+  std::unordered_map<std::string, iCache>::const_iterator it = m_cache.find(storedPath);
+  if (it == m_cache.end())
+    return m_lru.end();
+  return it->second;
+}
+
+void CDirectoryCache::Touch(iCache i)
+{
+  m_lru.splice(m_lru.begin(), m_lru, i);
+}
+
+CDirectoryCache::iCache CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  m_memoryUsed -= dir->m_size;
+  m_cache.erase(it->first);
   delete dir;
-  m_cache.erase(it);
+  return m_lru.erase(it);
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
   CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  CLog::Log(LOGDEBUG, "%s - total of %" PRIu64 " cache hits, %" PRIu64 " cache misses and %" PRIu64 " evictions",
+            __FUNCTION__, m_cacheHits, m_cacheMisses, m_evictions);
   unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
-  {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
-  }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  for (ciCache i = m_lru.begin(); i != m_lru.end(); i++)
+    numItems += i->second->m_Items->Size();
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using %zu of %zu bytes", __FUNCTION__,
+            static_cast<unsigned int>(m_cache.size()), numItems, m_memoryUsed, m_memoryLimit);
 }
 #endif
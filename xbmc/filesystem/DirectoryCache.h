@@ -21,16 +21,38 @@
 
 #include "IDirectory.h"
 #include "Directory.h"
+#include "settings/lib/ISettingsHandler.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <list>
 #include <set>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
 
 class CFileItem;
 
 namespace XFILE
 {
-  class CDirectoryCache
+  struct SDirectoryCacheStats
+  {
+    uint64_t hits = 0;          // lookups answered from the cache
+    uint64_t misses = 0;        // lookups of directories not in the cache
+    uint64_t evictions = 0;     // directories dropped to stay within the budget
+    unsigned int directories = 0;
+    uint64_t memoryUsed = 0;    // estimated size of the cached item lists
+    uint64_t memoryLimit = 0;
+  };
+
+  /*!
+   * \brief Caches directory listings, bounded by their estimated memory size
+   *
+   * Listings are kept in least recently used order and evicted from the tail
+   * once the total size exceeds the budget. Listings cached with
+   * DIR_CACHE_ALWAYS (archives) are only evicted when dropping every other
+   * listing wasn't enough.
+   */
+  class CDirectoryCache : public ISettingsHandler
   {
     class CDir
     {
@@ -38,13 +60,9 @@ namespace XFILE
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
-
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
-    private:
-      unsigned int m_lastAccess;
+      size_t m_size;
     };
   public:
     CDirectoryCache(void);
@@ -57,6 +75,25 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*!
+     * \brief Set the number of bytes the cached listings may occupy
+     *
+     * Lowering the limit evicts listings right away. A single listing larger
+     * than the limit is not cached at all.
+     */
+    void SetMemoryLimit(size_t memoryLimit);
+    SDirectoryCacheStats GetStats() const;
+
+    /*!
+     * \brief Applies the memory size of <directorycache> in advancedsettings.xml
+     */
+    void OnSettingsLoaded() override;
+
+    /*!
+     * \brief Estimate the memory used by a list of items
+     */
+    static size_t GetItemListSize(const CFileItemList &items);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -65,19 +102,25 @@ namespace XFILE
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    // most recently used first
+    typedef std::list<std::pair<std::string, CDir*> > CacheList;
+    typedef CacheList::iterator iCache;
+    typedef CacheList::const_iterator ciCache;
+    CacheList m_lru;
+    std::unordered_map<std::string, iCache> m_cache;
+
+    iCache Find(const std::string& storedPath);
+    void Touch(iCache i);
+    iCache Delete(iCache i);
 
     CCriticalSection m_cs;
 
-    unsigned int m_accessCounter;
+    size_t m_memoryUsed;
+    size_t m_memoryLimit;
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    uint64_t m_cacheHits;
+    uint64_t m_cacheMisses;
+    uint64_t m_evictions;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -0,0 +1,296 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DirectoryWalker.h"
+#include "Directory.h"
+#include "FileItem.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "URL.h"
+
+#include <algorithm>
+
+#define DEFAULT_THREADS   8
+#define DEFAULT_PER_HOST  4
+#define DEFAULT_LOOKAHEAD 64
+
+using namespace XFILE;
+
+class CDirectoryWalker::CWorker : public CThread
+{
+public:
+  explicit CWorker(CDirectoryWalker& walker)
+    : CThread("DirectoryWalker")
+    , m_walker(walker)
+  {
+  }
+
+  void Start()
+  {
+    Create();
+  }
+
+protected:
+  void Process() override
+  {
+    m_walker.Work();
+  }
+
+private:
+  CDirectoryWalker& m_walker;
+};
+
+CDirectoryWalker::CDirectoryWalker(const std::string& mask /* = "" */, int flags /* = DIR_FLAG_DEFAULTS */)
+  : m_mask(mask)
+  , m_flags(flags)
+  , m_threads(DEFAULT_THREADS)
+  , m_perHost(DEFAULT_PER_HOST)
+  , m_lookahead(DEFAULT_LOOKAHEAD)
+  , m_cancelled(false)
+  , m_ahead(0)
+{
+  m_list = [this](const std::string& path, CFileItemList& items)
+  {
+    return CDirectory::GetDirectory(path, items, m_mask, m_flags);
+  };
+}
+
+CDirectoryWalker::~CDirectoryWalker()
+{
+  Cancel();
+  for (auto& worker : m_workers)
+    worker->StopThread(true);
+}
+
+void CDirectoryWalker::SetConnections(unsigned int threads, unsigned int perHost)
+{
+  m_threads = std::max(threads, 1U);
+  m_perHost = std::max(perHost, 1U);
+}
+
+void CDirectoryWalker::Start(const std::string& path)
+{
+  CSingleLock lock(m_cs);
+  if (m_root)
+    return;
+
+  m_root = CreateNode(path);
+  m_pending.push_back(m_root);
+
+  for (unsigned int i = 0; i < m_threads; i++)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_workers.back()->Start();
+  }
+}
+
+bool CDirectoryWalker::Next(std::string& path, CFileItemList& items)
+{
+  CSingleLock lock(m_cs);
+  if (!m_root || m_cancelled)
+    return false;
+
+  NodePtr node;
+  if (m_root->state != NodeDelivered)
+    node = m_root;
+  else
+  {
+    if (m_current)
+      m_stack.push_back(std::make_pair(m_current, 0));
+
+    // continue with the next sibling of the deepest unfinished directory
+    while (!node && !m_stack.empty())
+    {
+      std::pair<NodePtr, size_t>& top = m_stack.back();
+      if (top.second < top.first->children.size())
+        node = top.first->children[top.second++];
+      else
+        m_stack.pop_back();
+    }
+  }
+  m_current.reset();
+
+  if (!node)
+    return false;
+
+  if (node->state == NodePending)
+  {
+    // list it before anything that is further ahead
+    m_pending.erase(std::find(m_pending.begin(), m_pending.end(), node));
+    m_pending.push_front(node);
+  }
+  m_wanted = node;
+  m_workCond.notifyAll();
+
+  while (!m_cancelled && node->state != NodeListed)
+    m_listedCond.wait(lock);
+  m_wanted.reset();
+  if (m_cancelled)
+    return false;
+
+  node->state = NodeDelivered;
+  m_ahead--;
+  m_current = node;
+  m_workCond.notifyAll();
+
+  path = node->path;
+  items.Assign(*node->items);
+  node->items.reset();
+  return true;
+}
+
+void CDirectoryWalker::AddChildren(const std::vector<std::string>& paths)
+{
+  CSingleLock lock(m_cs);
+  if (!m_current || paths.empty())
+    return;
+
+  std::vector<NodePtr> children;
+  for (const auto& path : paths)
+    children.push_back(CreateNode(path));
+  m_current->children.insert(m_current->children.end(), children.begin(), children.end());
+  QueueChildren(children);
+}
+
+void CDirectoryWalker::SkipChildren()
+{
+  CSingleLock lock(m_cs);
+  if (!m_current)
+    return;
+
+  SkipNode(m_current);
+  m_current->children.clear();
+  m_workCond.notifyAll();
+}
+
+void CDirectoryWalker::Cancel()
+{
+  CSingleLock lock(m_cs);
+  m_cancelled = true;
+  m_pending.clear();
+  m_workCond.notifyAll();
+  m_listedCond.notifyAll();
+}
+
+CDirectoryWalker::NodePtr CDirectoryWalker::CreateNode(const std::string& path) const
+{
+  NodePtr node(new CNode);
+  node->path = path;
+  node->host = CURL(path).GetHostName();
+  return node;
+}
+
+void CDirectoryWalker::QueueChildren(const std::vector<NodePtr>& children)
+{
+  // children go first, that keeps the workers close to the consumer's
+  // position in the pre-order instead of spreading out breadth first
+  m_pending.insert(m_pending.begin(), children.begin(), children.end());
+  m_workCond.notifyAll();
+}
+
+CDirectoryWalker::NodePtr CDirectoryWalker::TakeNode()
+{
+  for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+  {
+    const NodePtr node = *it;
+    if (node != m_wanted && m_ahead >= m_lookahead)
+      continue;
+    if (m_hostConnections[node->host] >= m_perHost)
+      continue;
+
+    m_pending.erase(it);
+    return node;
+  }
+  return NodePtr();
+}
+
+void CDirectoryWalker::SkipNode(const NodePtr& node)
+{
+  for (const auto& child : node->children)
+  {
+    switch (child->state)
+    {
+    case NodePending:
+      m_pending.erase(std::find(m_pending.begin(), m_pending.end(), child));
+      break;
+    case NodeListing:
+    case NodeListed:
+      m_ahead--;
+      break;
+    default:
+      break;
+    }
+    child->state = NodeSkipped;
+    child->items.reset();
+    SkipNode(child);
+  }
+}
+
+void CDirectoryWalker::Work()
+{
+  CSingleLock lock(m_cs);
+  while (!m_cancelled)
+  {
+    NodePtr node = TakeNode();
+    if (!node)
+    {
+      m_workCond.wait(lock);
+      continue;
+    }
+
+    node->state = NodeListing;
+    m_ahead++;
+    m_hostConnections[node->host]++;
+    lock.Leave();
+
+    std::unique_ptr<CFileItemList> items(new CFileItemList);
+    if (m_list(node->path, *items))
+    {
+      if (m_prepare)
+        m_prepare(*items);
+    }
+    else
+      items->Clear();
+
+    std::vector<NodePtr> children;
+    if (m_descend)
+    {
+      for (int i = 0; i < items->Size(); i++)
+      {
+        const CFileItemPtr item = items->Get(i);
+        if (m_descend(*item))
+          children.push_back(CreateNode(item->GetPath()));
+      }
+    }
+
+    lock.Enter();
+    m_hostConnections[node->host]--;
+    if (node->state == NodeListing)
+    {
+      node->state = NodeListed;
+      node->items = std::move(items);
+      node->children = children;
+      if (!m_cancelled)
+        QueueChildren(children);
+      m_listedCond.notifyAll();
+    }
+    m_workCond.notifyAll();
+  }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IDirectory.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+class CFileItem;
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   * \brief Lists a directory tree with several connections at once
+   *
+   * Directories are listed by a small pool of worker threads, ahead of the
+   * consumer, while Next() hands them out one by one in depth first pre-order,
+   * the order a recursive walk would visit them in. Subdirectories are either
+   * discovered from each listing with a descend function or added by the
+   * consumer with AddChildren() after it looked at their parent.
+   *
+   * The number of listings running against a single host and the number of
+   * listings buffered ahead of the consumer are bounded.
+   *
+   * \code
+   * CDirectoryWalker walker(mask);
+   * walker.SetDescendFunction([](const CFileItem& item) { return item.m_bIsFolder; });
+   * walker.Start(path);
+   * while (walker.Next(directory, items))
+   * {
+   *   if (!Wanted(directory))
+   *     walker.SkipChildren();
+   * }
+   * \endcode
+   */
+  class CDirectoryWalker
+  {
+  public:
+    typedef std::function<bool(const std::string& path, CFileItemList& items)> ListFunction;
+    typedef std::function<void(CFileItemList& items)> PrepareFunction;
+    typedef std::function<bool(const CFileItem& item)> DescendFunction;
+
+    /*!
+     * \brief Walk with CDirectory::GetDirectory(path, items, mask, flags)
+     */
+    explicit CDirectoryWalker(const std::string& mask = "", int flags = DIR_FLAG_DEFAULTS);
+    ~CDirectoryWalker();
+
+    /*!
+     * \brief Replace the function used to list a directory, e.g. to wrap it
+     */
+    void SetListFunction(const ListFunction& list) { m_list = list; }
+
+    /*!
+     * \brief Run on the worker thread after a directory was listed, e.g. to sort it
+     */
+    void SetPrepareFunction(const PrepareFunction& prepare) { m_prepare = prepare; }
+
+    /*!
+     * \brief Decide which items of a listing are walked into, on the worker thread
+     *
+     * Without one only the directories passed to AddChildren() are walked.
+     */
+    void SetDescendFunction(const DescendFunction& descend) { m_descend = descend; }
+
+    /*!
+     * \brief Set the number of worker threads and how many of them may list a single host
+     */
+    void SetConnections(unsigned int threads, unsigned int perHost);
+
+    /*!
+     * \brief Set how many listings may be kept ahead of the consumer
+     */
+    void SetLookahead(unsigned int lookahead) { m_lookahead = lookahead; }
+
+    /*!
+     * \brief Start walking the tree below path. A walker can only be started once.
+     */
+    void Start(const std::string& path);
+
+    /*!
+     * \brief Get the next directory in pre-order, waiting for its listing if necessary
+     * \param path the directory
+     * \param items its listing, empty if it couldn't be listed
+     * \return false when the walk is complete or was cancelled
+     */
+    bool Next(std::string& path, CFileItemList& items);
+
+    /*!
+     * \brief Walk into the given directories after the one returned last by Next()
+     */
+    void AddChildren(const std::vector<std::string>& paths);
+
+    /*!
+     * \brief Don't walk into the directory returned last by Next()
+     */
+    void SkipChildren();
+
+    /*!
+     * \brief Stop walking. Listings already running are finished but dropped.
+     */
+    void Cancel();
+
+  private:
+    CDirectoryWalker(const CDirectoryWalker&) = delete;
+    CDirectoryWalker& operator=(const CDirectoryWalker&) = delete;
+
+    class CWorker;
+    friend class CWorker;
+
+    enum NodeState
+    {
+      NodePending,
+      NodeListing,
+      NodeListed,
+      NodeDelivered,
+      NodeSkipped
+    };
+
+    struct CNode
+    {
+      std::string path;
+      std::string host;
+      NodeState state = NodePending;
+      std::unique_ptr<CFileItemList> items;
+      std::vector<std::shared_ptr<CNode> > children;
+    };
+    typedef std::shared_ptr<CNode> NodePtr;
+
+    NodePtr CreateNode(const std::string& path) const;
+    void QueueChildren(const std::vector<NodePtr>& children);
+    NodePtr TakeNode();
+    void SkipNode(const NodePtr& node);
+    void Work();
+
+    std::string m_mask;
+    int m_flags;
+    ListFunction m_list;
+    PrepareFunction m_prepare;
+    DescendFunction m_descend;
+    unsigned int m_threads;
+    unsigned int m_perHost;
+    unsigned int m_lookahead;
+
+    CCriticalSection m_cs;
+    XbmcThreads::ConditionVariable m_workCond;
+    XbmcThreads::ConditionVariable m_listedCond;
+    std::vector<std::unique_ptr<CWorker> > m_workers;
+    bool m_cancelled;
+
+    NodePtr m_root;
+    NodePtr m_current;            // returned last by Next()
+    NodePtr m_wanted;             // Next() is waiting for it
+    std::vector<std::pair<NodePtr, size_t> > m_stack;
+    std::deque<NodePtr> m_pending;
+    std::map<std::string, unsigned int> m_hostConnections;
+    unsigned int m_ahead;         // listings running or waiting for Next()
+  };
+}
@@ -44,6 +44,11 @@
 using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (64*1024)
+// upper bound of a single read from the source when the read size adapts to its throughput
+#define READ_CACHE_MAX_READ_SIZE (4*1024*1024)
+// reads that complete faster than this grow, ones that take longer shrink to what the
+// source delivers in this time
+#define READ_CACHE_TARGET_READ_TIME 100
 
 class CWriteRate
 {
@@ -179,6 +184,12 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
+    // READ_MULTI_STREAM requires double buffering, audio/video can keep more
+    // ranges cached to serve seeks back to recently played parts from memory
+    unsigned int segments = (m_flags & READ_AUDIO_VIDEO) ? g_advancedSettings.m_cacheSegments : 1;
+    if (m_flags & READ_MULTI_STREAM)
+      segments = std::max(segments, 2U);
+
     if (g_advancedSettings.m_cacheMemSize == 0)
     {
       // Use cache on disk
@@ -198,24 +209,17 @@ bool CFileCache::Open(const CURL& url)
         cacheSize = g_advancedSettings.m_cacheMemSize;
       }
 
+      // the memory is shared by all segments
+      cacheSize /= segments;
       size_t back = cacheSize / 4;
       size_t front = cacheSize - back;
-      
-      if (m_flags & READ_MULTI_STREAM)
-      {
-        // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
-        front /= 2;
-        back /= 2;
-      }
+
       m_pCache = new CCircularCache(front, back);
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
-    {
-      // If READ_MULTI_STREAM flag is set: Double buffering is required
-      m_pCache = new CDoubleCache(m_pCache);
-    }
+    if (segments > 1)
+      m_pCache = new CSegmentedCache(m_pCache, segments);
   }
 
   // open cache strategy
@@ -246,8 +250,13 @@ void CFileCache::Process()
     return;
   }
 
+  // reads grow with the throughput of the source, fast sources need fewer
+  // round trips while a slow one keeps delivering in small steps
+  const unsigned maxReadSize = std::max(m_chunkSize, READ_CACHE_MAX_READ_SIZE / m_chunkSize * m_chunkSize);
+  unsigned readSize = m_chunkSize;
+
   // create our read buffer
-  std::unique_ptr<char[]> buffer(new char[m_chunkSize]);
+  std::unique_ptr<char[]> buffer(new char[maxReadSize]);
   if (buffer.get() == NULL)
   {
     CLog::Log(LOGERROR, "%s - failed to allocate read buffer", __FUNCTION__);
@@ -289,6 +298,8 @@ void CFileCache::Process()
         average.Reset(m_writePos, bCompleteReset); // Can only recalculate new average from scratch after a full reset (empty cache)
         limiter.Reset(m_writePos);
         m_nSeekResult = m_seekPos;
+        // the reader waits for the first data after a seek
+        readSize = m_chunkSize;
       }
 
       m_seekEnded.Set();
@@ -313,7 +324,7 @@ void CFileCache::Process()
       }
     }
 
-    size_t maxWrite = m_pCache->GetMaxWriteSize(m_chunkSize);
+    size_t maxWrite = m_pCache->GetMaxWriteSize(readSize);
 
     /* Only read from source if there's enough write space in the cache
      * else we may keep disposing data and seeking back on (slow) source
@@ -326,7 +337,21 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
+    {
+      const unsigned int start = XbmcThreads::SystemClockMillis();
       iRead = m_source.Read(buffer.get(), maxWrite);
+      const unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+      if (iRead > 0 && static_cast<size_t>(iRead) == readSize && elapsed < READ_CACHE_TARGET_READ_TIME)
+        readSize = std::min(readSize * 2, maxReadSize);
+      else if (elapsed > READ_CACHE_TARGET_READ_TIME && readSize > m_chunkSize)
+      {
+        // a source that slowed down must not hold up seeks and the fill level
+        // for seconds with one large read
+        const uint64_t fitting = static_cast<uint64_t>(std::max<ssize_t>(iRead, 0)) * READ_CACHE_TARGET_READ_TIME / elapsed;
+        readSize = std::max(static_cast<unsigned>(std::min<uint64_t>(fitting, readSize)) / m_chunkSize * m_chunkSize, m_chunkSize);
+      }
+    }
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -73,6 +73,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_MMAP          = 32, /**< Serve reads from memory mapped pages, returns 1 if the file could be mapped */
 } EIoControl;
 
 enum CURLOPTIONTYPE
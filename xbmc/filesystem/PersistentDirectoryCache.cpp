@@ -0,0 +1,203 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PersistentDirectoryCache.h"
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IDirectory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "URL.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <memory>
+#include <stdexcept>
+#include <time.h>
+#include <vector>
+
+#define CACHE_FOLDER "special://temp/directory_cache/"
+// bump when the layout of CFileItemList::Archive changes
+#define CACHE_VERSION 2
+// seconds a directory has to be unchanged before its listing is stored
+#define MIN_UNMODIFIED_TIME 60
+
+using namespace XFILE;
+
+CPersistentDirectoryCache& CPersistentDirectoryCache::GetInstance()
+{
+  static CPersistentDirectoryCache instance;
+  return instance;
+}
+
+CPersistentDirectoryCache::CPersistentDirectoryCache()
+  : m_enabled(false)
+{
+}
+
+void CPersistentDirectoryCache::SetEnabled(bool enabled)
+{
+  CSingleLock lock(m_cs);
+  if (enabled && !m_enabled)
+    CDirectory::Create(CACHE_FOLDER);
+  m_enabled = enabled;
+}
+
+void CPersistentDirectoryCache::OnSettingsLoaded()
+{
+  SetEnabled(g_advancedSettings.m_directoryCachePersistent);
+}
+
+bool CPersistentDirectoryCache::GetModificationTime(const CURL& url, int64_t& modified) const
+{
+  if (!m_enabled)
+    return false;
+
+  // only these report a modification time for directories that changes
+  // whenever an entry is added, removed or renamed
+  if (!url.IsProtocol("smb") && !url.IsProtocol("nfs"))
+    return false;
+
+  struct __stat64 buffer;
+  if (CFile::Stat(url, &buffer) != 0 || buffer.st_mtime <= 0)
+    return false;
+
+  modified = buffer.st_mtime;
+  return true;
+}
+
+bool CPersistentDirectoryCache::GetDirectory(const CURL& url, int64_t modified, int flags, CFileItemList& items)
+{
+  // a full listing serves any request, one without file info only its own kind
+  if (LoadDirectory(GetStoredPath(url), modified, items))
+    return true;
+  if (flags & DIR_FLAG_NO_FILE_INFO)
+    return LoadDirectory(GetStoredPath(url, false), modified, items);
+  return false;
+}
+
+bool CPersistentDirectoryCache::LoadDirectory(const std::string& storedPath, int64_t modified, CFileItemList& items)
+{
+  const std::string cacheFile = GetCacheFile(storedPath);
+
+  CSingleLock lock(GetSection(storedPath));
+  CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    std::string path;
+    int64_t stored = 0;
+    ar >> version;
+    if (version != CACHE_VERSION)
+      return false;
+    ar >> path;
+    ar >> stored;
+    // the crc of another path may collide with ours
+    if (path != storedPath || stored != modified)
+      return false;
+    ar >> items;
+    return true;
+  }
+  catch (std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "%s - corrupt listing for %s", __FUNCTION__, CURL::GetRedacted(storedPath).c_str());
+  }
+  file.Close();
+  CFile::Delete(cacheFile);
+  items.Clear();
+  return false;
+}
+
+void CPersistentDirectoryCache::SetDirectory(const CURL& url, int64_t modified, int flags, const CFileItemList& items)
+{
+  if (time(nullptr) - modified < MIN_UNMODIFIED_TIME)
+    return;
+
+  std::string storedPath = GetStoredPath(url, !(flags & DIR_FLAG_NO_FILE_INFO));
+  int64_t stored = modified;
+  int version = CACHE_VERSION;
+
+  CSingleLock lock(GetSection(storedPath));
+  CFile file;
+  if (!file.OpenForWrite(GetCacheFile(storedPath), true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  ar << version;
+  ar << storedPath;
+  ar << stored;
+  // Archive() isn't const but doesn't modify the list while storing
+  ar << const_cast<CFileItemList&>(items);
+  ar.Close();
+}
+
+void CPersistentDirectoryCache::ClearDirectory(const CURL& url)
+{
+  for (bool fileInfo : { true, false })
+  {
+    const std::string storedPath = GetStoredPath(url, fileInfo);
+    const std::string cacheFile = GetCacheFile(storedPath);
+    CSingleLock lock(GetSection(storedPath));
+    if (CFile::Exists(cacheFile))
+      CFile::Delete(cacheFile);
+  }
+}
+
+void CPersistentDirectoryCache::Clear()
+{
+  CSingleLock lock(m_cs);
+  std::vector<std::unique_ptr<CSingleLock>> locks;
+  for (CCriticalSection& section : m_sections)
+    locks.emplace_back(new CSingleLock(section));
+  CDirectory::RemoveRecursive(CACHE_FOLDER);
+  if (m_enabled)
+    CDirectory::Create(CACHE_FOLDER);
+}
+
+std::string CPersistentDirectoryCache::GetStoredPath(const CURL& url, bool fileInfo /* = true */)
+{
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = url.GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  // options are gone, so this can't clash with a real path
+  if (!fileInfo)
+    storedPath += "|nofileinfo";
+  return storedPath;
+}
+
+std::string CPersistentDirectoryCache::GetCacheFile(const std::string& storedPath)
+{
+  return StringUtils::Format(CACHE_FOLDER "%08x.fi", Crc32::Compute(storedPath));
+}
+
+CCriticalSection& CPersistentDirectoryCache::GetSection(const std::string& storedPath)
+{
+  // listings of different directories are read and written in parallel,
+  // only the same cache file is serialised
+  return m_sections[Crc32::Compute(storedPath) % SECTIONS];
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+#include "settings/lib/ISettingsHandler.h"
+#include "threads/CriticalSection.h"
+
+class CFileItemList;
+class CURL;
+
+namespace XFILE
+{
+  /*!
+   * \brief Keeps directory listings of network shares on disk across restarts
+   *
+   * A listing is stored together with the modification time of its directory
+   * and only handed out while the directory still reports the same time, so
+   * an unchanged folder costs a single stat instead of a full listing. Only
+   * protocols that report a modification time for directories are supported.
+   */
+  class CPersistentDirectoryCache : public ISettingsHandler
+  {
+  public:
+    static CPersistentDirectoryCache& GetInstance();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    /*!
+     * \brief Applies the persistent flag of <directorycache> in advancedsettings.xml
+     */
+    void OnSettingsLoaded() override;
+
+    /*!
+     * \brief Get the modification time listings of the directory are validated with
+     * \return false if the cache is disabled, the protocol isn't supported or stat failed
+     */
+    bool GetModificationTime(const CURL& url, int64_t& modified) const;
+
+    /*!
+     * \brief Load the listing stored for the directory
+     * \param flags the DIR_FLAG_* the listing is requested with, a full listing also
+     *        serves a request with DIR_FLAG_NO_FILE_INFO but not the other way around
+     * \return true if a listing of the directory at the given modification time was found
+     */
+    bool GetDirectory(const CURL& url, int64_t modified, int flags, CFileItemList& items);
+
+    /*!
+     * \brief Store the listing of the directory
+     *
+     * Directories modified within the last minute are skipped, as some servers
+     * report the modification time in seconds only and a later change in the
+     * same second would go unnoticed.
+     * \param flags the DIR_FLAG_* the listing was fetched with
+     */
+    void SetDirectory(const CURL& url, int64_t modified, int flags, const CFileItemList& items);
+
+    void ClearDirectory(const CURL& url);
+    void Clear();
+
+  private:
+    CPersistentDirectoryCache();
+    CPersistentDirectoryCache(const CPersistentDirectoryCache&) = delete;
+    CPersistentDirectoryCache& operator=(const CPersistentDirectoryCache&) = delete;
+
+    bool LoadDirectory(const std::string& storedPath, int64_t modified, CFileItemList& items);
+    static std::string GetStoredPath(const CURL& url, bool fileInfo = true);
+    static std::string GetCacheFile(const std::string& storedPath);
+    CCriticalSection& GetSection(const std::string& storedPath);
+
+    static const unsigned int SECTIONS = 16;
+
+    std::atomic<bool> m_enabled;
+    CCriticalSection m_cs;                 ///< guards enabling and clearing the cache folder
+    CCriticalSection m_sections[SECTIONS]; ///< guard the cache files, by crc of their path
+  };
+}
@@ -0,0 +1,87 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+using namespace XFILE;
+
+namespace
+{
+const size_t frontSize = 16 * 1024 * 1024;
+const size_t backSize = 4 * 1024 * 1024;
+
+// writes and reads one chunk, both may need several calls around the wrap point
+void Transfer(CCircularCache& cache, const std::vector<char>& in, std::vector<char>& out)
+{
+  size_t written = 0;
+  while (written < in.size())
+    written += cache.WriteToCache(in.data() + written, in.size() - written);
+
+  size_t read = 0;
+  while (read < out.size())
+    read += cache.ReadFromCache(out.data() + read, out.size() - read);
+}
+}
+
+static void BM_CircularCache_Stream(benchmark::State& state)
+{
+  CCircularCache cache(frontSize, backSize);
+  cache.Open();
+  std::vector<char> in(static_cast<size_t>(state.range(0)), 'x');
+  std::vector<char> out(in.size());
+
+  for (auto _ : state)
+  {
+    Transfer(cache, in, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * in.size());
+  cache.Close();
+}
+BENCHMARK(BM_CircularCache_Stream)->Arg(4096)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+// a player seeking back a little and reading the same data again, which
+// has to be served from the back buffer
+static void BM_CircularCache_SeekBack(benchmark::State& state)
+{
+  CCircularCache cache(frontSize, backSize);
+  cache.Open();
+  std::vector<char> in(64 * 1024, 'x');
+  std::vector<char> out(in.size());
+  int64_t pos = 0;
+
+  for (auto _ : state)
+  {
+    Transfer(cache, in, out);
+    pos += in.size();
+    cache.Seek(pos - in.size() / 2);
+    size_t read = 0;
+    while (read < in.size() / 2)
+      read += cache.ReadFromCache(out.data() + read, in.size() / 2 - read);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * in.size() * 3 / 2);
+  cache.Close();
+}
+BENCHMARK(BM_CircularCache_SeekBack);
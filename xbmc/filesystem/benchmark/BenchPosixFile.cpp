@@ -0,0 +1,104 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+using namespace XFILE;
+
+#ifdef TARGET_POSIX
+namespace
+{
+const size_t fileSize = 256 * 1024 * 1024;
+
+// a file large enough to span several mapped windows, written once and
+// kept in the page cache, so the benchmark measures the cost of getting
+// the data to the caller rather than the disk
+class CBenchFile
+{
+public:
+  CBenchFile()
+  {
+    char path[] = "/tmp/kodi-bench-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+      return;
+    std::vector<char> chunk(1024 * 1024, 'x');
+    for (size_t written = 0; written < fileSize; written += chunk.size())
+    {
+      if (write(fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size()))
+        break;
+    }
+    close(fd);
+    m_path = path;
+  }
+  ~CBenchFile()
+  {
+    if (!m_path.empty())
+      unlink(m_path.c_str());
+  }
+  const std::string& GetPath() const { return m_path; }
+
+private:
+  std::string m_path;
+};
+
+const CBenchFile& GetBenchFile()
+{
+  static CBenchFile file;
+  return file;
+}
+}
+
+// sequential reads in the sizes the demuxer asks for, through read() (0)
+// or the mapped file (1)
+static void BM_PosixFile_Read(benchmark::State& state)
+{
+  const std::string& path = GetBenchFile().GetPath();
+  CFile file;
+  if (path.empty() || !file.Open(path, READ_NO_CACHE))
+  {
+    state.SkipWithError("can't create the file to read");
+    return;
+  }
+  if (state.range(1) && file.IoControl(IOCTRL_MMAP, NULL) != 1)
+  {
+    state.SkipWithError("mapping the file failed");
+    return;
+  }
+
+  std::vector<char> buf(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+  {
+    if (file.Read(buf.data(), buf.size()) < static_cast<ssize_t>(buf.size()))
+      file.Seek(0, SEEK_SET);
+    benchmark::DoNotOptimize(buf.data());
+  }
+  state.SetBytesProcessed(state.iterations() * buf.size());
+}
+BENCHMARK(BM_PosixFile_Read)->Args({4096, 0})->Args({4096, 1})
+                            ->Args({32768, 0})->Args({32768, 1})
+                            ->Args({1024 * 1024, 0})->Args({1024 * 1024, 1});
+#endif
@@ -32,17 +32,134 @@
 #include <assert.h>
 #include <limits.h>
 #include <algorithm>
+#include <atomic>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <errno.h>
+#include <cstring>
+#include <inttypes.h>
+#include <mutex>
+#include <setjmp.h>
+#include <signal.h>
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <sys/vfs.h>
+#elif defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+#include <sys/mount.h>
+#endif
+
+// windows mapped for IOCTRL_MMAP, a multiple of any page size
+#define MMAP_WINDOW_SIZE      (32 * 1024 * 1024)
+// how far ahead of sequential reads pages are requested with MADV_WILLNEED
+#define MMAP_READAHEAD        (4 * 1024 * 1024)
+// consecutive reads before the access pattern counts as sequential
+#define MMAP_SEQUENTIAL_READS 4
 
 using namespace XFILE;
 
+namespace
+{
+// where a thread copying out of a mapping continues when that raises SIGBUS
+thread_local sigjmp_buf* mappedReadJump = nullptr;
+struct sigaction previousBusAction;
+
+void OnBusError(int sig, siginfo_t* info, void* context)
+{
+  if (mappedReadJump)
+    siglongjmp(*mappedReadJump, 1);
+
+  // not raised by a mapped read, hand it on to whoever was there before
+  if (previousBusAction.sa_flags & SA_SIGINFO)
+    previousBusAction.sa_sigaction(sig, info, context);
+  else if (previousBusAction.sa_handler != SIG_DFL && previousBusAction.sa_handler != SIG_IGN)
+    previousBusAction.sa_handler(sig);
+  else
+  {
+    signal(sig, SIG_DFL);
+    raise(sig);
+  }
+}
+
+void InstallBusErrorHandler()
+{
+  static std::once_flag once;
+  std::call_once(once, []()
+  {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = OnBusError;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGBUS, &action, &previousBusAction);
+  });
+}
+
+/*!
+ * \brief memcpy out of a mapping
+ * \return false if the pages couldn't be read, e.g. because the file was
+ *         truncated by someone else or the device failed
+ */
+bool CopyMapped(void* dst, const void* src, size_t size)
+{
+  sigjmp_buf jump;
+  if (sigsetjmp(jump, 1) != 0)
+  {
+    mappedReadJump = nullptr;
+    return false;
+  }
+  mappedReadJump = &jump;
+  // keep the compiler from moving the copy out of the guarded section
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  memcpy(dst, src, size);
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  mappedReadJump = nullptr;
+  return true;
+}
+
+/*!
+ * \brief Whether the filesystem of the file is safe to map
+ *
+ * Pages of network and FUSE filesystems that the server or daemon can't
+ * deliver raise SIGBUS, which the guard in CopyMapped would have to catch
+ * on every hiccup of the connection.
+ */
+bool IsLocalFilesystem(int fd)
+{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  struct statfs fs;
+  if (fstatfs(fd, &fs) != 0)
+    return false;
+  switch (static_cast<uint32_t>(fs.f_type))
+  {
+    case 0x00006969: // NFS
+    case 0x0000517B: // SMB
+    case 0xFF534D42: // CIFS
+    case 0xFE534D42: // SMB2
+    case 0x65735546: // FUSE
+    case 0x01021997: // 9P
+    case 0x00C36400: // Ceph
+    case 0x5346414F: // AFS
+      return false;
+    default:
+      return true;
+  }
+#elif defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+  struct statfs fs;
+  return fstatfs(fd, &fs) == 0 && (fs.f_flags & MNT_LOCAL);
+#else
+  return false;
+#endif
+}
+}
+
 CPosixFile::CPosixFile() :
-  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false)
+  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false),
+  m_mapped(false), m_map(nullptr), m_mapOffset(0), m_mapSize(0), m_mapLength(0),
+  m_sequentialReads(0), m_adviceSequential(false), m_willNeedPos(0)
 { }
 
 CPosixFile::~CPosixFile()
 {
+  UnmapWindow();
   if (m_fd >= 0)
     close(m_fd);
 }
@@ -96,11 +213,13 @@ void CPosixFile::Close()
 {
   if (m_fd >= 0)
   {
+    UnmapWindow();
     close(m_fd);
     m_fd = -1;
     m_filePos = -1;
     m_lastDropPos = -1;
     m_allowWrite = false;
+    m_mapped = false;
   }
 }
 
@@ -116,6 +235,9 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
 
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
+
+  if (m_mapped)
+    return ReadMapped(lpBuf, uiBufSize);
   
   const ssize_t res = read(m_fd, lpBuf, uiBufSize);
   if (res < 0)
@@ -127,24 +249,190 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
   if (m_filePos >= 0)
   {
     m_filePos += res; // if m_filePos was known - update it
+    DropBehind();
+  }
+
+  return res;
+}
+
+void CPosixFile::DropBehind()
+{
 #if defined(HAVE_POSIX_FADVISE)
-    // Drop the cache between then last drop and 16 MB behind where we
-    // are now, to make sure the file doesn't displace everything else.
-    // However, never throw out the first 16 MB of the file, as it might
-    // be the header etc., and never ask the OS to drop in chunks of
-    // less than 1 MB.
-    const int64_t end_drop = m_filePos - 16 * 1024 * 1024;
-    if (end_drop >= 17 * 1024 * 1024)
+  // Drop the cache between then last drop and 16 MB behind where we
+  // are now, to make sure the file doesn't displace everything else.
+  // However, never throw out the first 16 MB of the file, as it might
+  // be the header etc., and never ask the OS to drop in chunks of
+  // less than 1 MB.
+  const int64_t end_drop = m_filePos - 16 * 1024 * 1024;
+  if (end_drop >= 17 * 1024 * 1024)
+  {
+    const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
+    if (end_drop - start_drop < 1 * 1024 * 1024)
+      return;
+
+    // pages still mapped into our address space aren't dropped by
+    // posix_fadvise, unmap them from the current window first
+    if (m_map && end_drop > m_mapOffset)
     {
-      const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
-      if (end_drop - start_drop >= 1 * 1024 * 1024 &&
-          posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
-        m_lastDropPos = end_drop;
+      const int64_t from = std::max(start_drop, m_mapOffset) - m_mapOffset;
+      const int64_t pageSize = sysconf(_SC_PAGESIZE);
+      const int64_t aligned = from - from % pageSize;
+      madvise(m_map + aligned, static_cast<size_t>(end_drop - m_mapOffset - aligned), MADV_DONTNEED);
     }
+
+    if (posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
+      m_lastDropPos = end_drop;
+  }
 #endif
+}
+
+bool CPosixFile::MapWindow(int64_t pos)
+{
+  UnmapWindow();
+
+  if (pos >= m_mapLength)
+  {
+    // the file may have grown since the last window was mapped, e.g. a recording
+    struct stat64 st;
+    if (fstat64(m_fd, &st) != 0 || pos >= st.st_size)
+      return false;
+    m_mapLength = st.st_size;
   }
 
-  return res;
+  const int64_t offset = pos - pos % MMAP_WINDOW_SIZE;
+  const size_t size = static_cast<size_t>(std::min<int64_t>(MMAP_WINDOW_SIZE, m_mapLength - offset));
+  const off_t offsetOffT = (off_t) offset;
+  void* map = MAP_FAILED;
+  if (sizeof(int64_t) == sizeof(off_t) || offset == offsetOffT)
+    map = mmap(NULL, size, PROT_READ, MAP_SHARED, m_fd, offsetOffT);
+  if (map == MAP_FAILED)
+  {
+    CLog::LogF(LOGWARNING, "Can't map %zu bytes at %" PRId64 " (errno %d), falling back to read()", size, offset, errno);
+    m_mapped = false;
+    return false;
+  }
+
+  m_map = static_cast<uint8_t*>(map);
+  m_mapOffset = offset;
+  m_mapSize = size;
+  m_willNeedPos = pos;
+  if (m_adviceSequential)
+    madvise(m_map, m_mapSize, MADV_SEQUENTIAL);
+
+  return true;
+}
+
+void CPosixFile::UnmapWindow()
+{
+  if (m_map)
+  {
+    munmap(m_map, m_mapSize);
+    m_map = nullptr;
+    m_mapOffset = 0;
+    m_mapSize = 0;
+  }
+}
+
+ssize_t CPosixFile::ReadMapped(void* lpBuf, size_t uiBufSize)
+{
+  uint8_t* out = static_cast<uint8_t*>(lpBuf);
+  size_t done = 0;
+  while (done < uiBufSize)
+  {
+    const int64_t pos = m_filePos + done;
+    if (!m_map || pos < m_mapOffset || pos >= m_mapOffset + static_cast<int64_t>(m_mapSize))
+    {
+      if (!MapWindow(pos))
+        break;
+    }
+    if (done == 0)
+      AdviseMapped(pos, uiBufSize);
+
+    const size_t offset = static_cast<size_t>(pos - m_mapOffset);
+    const size_t len = std::min(uiBufSize - done, m_mapSize - offset);
+    if (!CopyMapped(out + done, m_map + offset, len))
+    {
+      CLog::LogF(LOGWARNING, "Bus error reading the mapping at %" PRId64 ", falling back to read()", pos);
+      UnmapWindow();
+      m_mapped = false;
+      break;
+    }
+    done += len;
+  }
+  m_filePos += done;
+
+  if (!m_mapped)
+  {
+    // mapping failed, carry on with plain reads from the current position
+    if (lseek(m_fd, (off_t) m_filePos, SEEK_SET) < 0)
+    {
+      m_filePos = -1;
+      return -1;
+    }
+    if (done == 0)
+      return Read(lpBuf, uiBufSize);
+  }
+
+  DropBehind();
+  return done;
+}
+
+void CPosixFile::AdviseMapped(int64_t pos, size_t size)
+{
+  if (m_sequentialReads < MMAP_SEQUENTIAL_READS)
+  {
+    if (++m_sequentialReads < MMAP_SEQUENTIAL_READS)
+      return;
+    madvise(m_map, m_mapSize, MADV_SEQUENTIAL);
+    m_adviceSequential = true;
+  }
+
+  // request pages up to MMAP_READAHEAD ahead of the read, in steps of half
+  // of that so the hint isn't repeated for every read
+  const int64_t end = std::min<int64_t>(pos + size + MMAP_READAHEAD, m_mapOffset + m_mapSize);
+  if (end - m_willNeedPos < MMAP_READAHEAD / 2)
+    return;
+
+  const int64_t from = std::max(m_willNeedPos, pos) - m_mapOffset;
+  const int64_t pageSize = sysconf(_SC_PAGESIZE);
+  const int64_t aligned = from - from % pageSize;
+  madvise(m_map + aligned, static_cast<size_t>(end - m_mapOffset - aligned), MADV_WILLNEED);
+  m_willNeedPos = end;
+}
+
+int64_t CPosixFile::SeekMapped(int64_t iFilePosition, int iWhence)
+{
+  int64_t pos;
+  if (iWhence == SEEK_SET)
+    pos = iFilePosition;
+  else if (iWhence == SEEK_CUR)
+    pos = m_filePos + iFilePosition;
+  else if (iWhence == SEEK_END)
+  {
+    const int64_t length = GetLength();
+    if (length < 0)
+      return -1;
+    pos = length + iFilePosition;
+  }
+  else
+    return -1;
+
+  if (pos < 0)
+    return -1;
+
+  // short skips forward, e.g. over a stream the demuxer doesn't need, don't
+  // break a sequential read pattern
+  if (pos < m_filePos || pos > m_filePos + MMAP_READAHEAD)
+  {
+    if (m_adviceSequential && m_map)
+      madvise(m_map, m_mapSize, MADV_NORMAL);
+    m_adviceSequential = false;
+    m_sequentialReads = 0;
+    m_willNeedPos = pos;
+  }
+
+  m_filePos = pos;
+  return m_filePos;
 }
 
 ssize_t CPosixFile::Write(const void* lpBuf, size_t uiBufSize)
@@ -176,6 +464,10 @@ int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
 {
   if (m_fd < 0)
     return -1;
+
+  // no need to ask the kernel, the position is only used for mapped reads
+  if (m_mapped)
+    return SeekMapped(iFilePosition, iWhence);
   
 #ifdef TARGET_ANDROID
   //! @todo properly support with detection in configure
@@ -278,6 +570,33 @@ int CPosixFile::IoControl(EIoControl request, void* param)
         return 0; // size of file is 1 byte or more and seeking not possible
     }
   }
+  else if (request == IOCTRL_MMAP)
+  {
+    // Reads are copied from the page cache without a syscall each. Files
+    // opened for writing aren't mapped, Write() doesn't keep the window up
+    // to date. A mapped file can still be truncated by another process,
+    // the SIGBUS raised by reading beyond its new end is caught in
+    // ReadMapped() and reading continues with read().
+    if (m_allowWrite)
+      return -1;
+    if (m_mapped)
+      return 1;
+
+    struct stat64 st;
+    if (fstat64(m_fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || GetPosition() < 0)
+      return -1;
+    if (!IsLocalFilesystem(m_fd))
+      return -1;
+
+    InstallBusErrorHandler();
+
+    m_mapLength = st.st_size;
+    m_sequentialReads = 0;
+    m_adviceSequential = false;
+    m_willNeedPos = m_filePos;
+    m_mapped = true;
+    return 1;
+  }
   
   return -1;
 }
@@ -50,10 +50,42 @@ namespace XFILE
     virtual int Stat(struct __stat64* buffer);
 
   protected:
+    void DropBehind();
+
+    /*!
+     * \brief Map the window of the file containing pos
+     *
+     * Windows are aligned to MMAP_WINDOW_SIZE so that sequential reads only
+     * remap every few dozen megabytes and 32 bit builds never map more than
+     * a single window.
+     */
+    bool MapWindow(int64_t pos);
+    void UnmapWindow();
+    ssize_t ReadMapped(void* lpBuf, size_t uiBufSize);
+    int64_t SeekMapped(int64_t iFilePosition, int iWhence);
+
+    /*!
+     * \brief Give the kernel readahead hints based on how the mapped file is read
+     *
+     * Consecutive reads switch the window to MADV_SEQUENTIAL and keep some
+     * pages ahead of the read position requested with MADV_WILLNEED, a seek
+     * goes back to the default behaviour.
+     */
+    void AdviseMapped(int64_t pos, size_t size);
+
     int     m_fd;
     int64_t m_filePos;
     int64_t m_lastDropPos;
     bool    m_allowWrite;
+
+    bool     m_mapped;           // reads are served from m_map
+    uint8_t* m_map;
+    int64_t  m_mapOffset;
+    size_t   m_mapSize;
+    int64_t  m_mapLength;        // file length seen when the last window was mapped
+    int      m_sequentialReads;
+    bool     m_adviceSequential;
+    int64_t  m_willNeedPos;      // end of the range already requested with MADV_WILLNEED
   };
   
 }
@@ -0,0 +1,139 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CacheStrategy.h"
+#include "filesystem/CircularCache.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const size_t FRONT = 4096;
+const size_t BACK = 1024;
+
+// fills the active segment from its current end with bytes derived from the file position
+void Fill(CCacheStrategy& cache, size_t size)
+{
+  std::vector<char> data(size);
+  const int64_t start = cache.CachedDataEndPos();
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((start + i) & 0xff);
+  ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(data.data(), size));
+}
+
+char ReadByte(CCacheStrategy& cache)
+{
+  char c = 0;
+  EXPECT_EQ(1, cache.ReadFromCache(&c, 1));
+  return c;
+}
+}
+
+TEST(TestCacheStrategy, SegmentedCacheKeepsRanges)
+{
+  CSegmentedCache cache(new CCircularCache(FRONT, BACK), 3);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // file head, e.g. the header of a video
+  Fill(cache, 1000);
+  EXPECT_TRUE(cache.IsCachedPosition(500));
+
+  // index at the end of the file
+  EXPECT_TRUE(cache.Reset(100000, false));
+  Fill(cache, 1000);
+  EXPECT_EQ(2U, cache.GetSegmentCount());
+
+  // playback position
+  EXPECT_TRUE(cache.Reset(50000, false));
+  Fill(cache, 1000);
+  EXPECT_EQ(3U, cache.GetSegmentCount());
+
+  EXPECT_TRUE(cache.IsCachedPosition(500));
+  EXPECT_TRUE(cache.IsCachedPosition(100500));
+  EXPECT_TRUE(cache.IsCachedPosition(50500));
+  EXPECT_FALSE(cache.IsCachedPosition(70000));
+
+  // a seek into another segment asks for a reset, which only switches segments
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(500));
+  EXPECT_EQ(1000, cache.CachedDataEndPosIfSeekTo(500));
+  EXPECT_FALSE(cache.Reset(500, false));
+  EXPECT_EQ(1000, cache.CachedDataEndPos());
+  EXPECT_EQ(static_cast<char>(500 & 0xff), ReadByte(cache));
+
+  // back to where playback was
+  EXPECT_FALSE(cache.Reset(50600, false));
+  EXPECT_EQ(51000, cache.CachedDataEndPos());
+  EXPECT_EQ(static_cast<char>(50600 & 0xff), ReadByte(cache));
+  EXPECT_EQ(3U, cache.GetSegmentCount());
+}
+
+TEST(TestCacheStrategy, SegmentedCacheRecyclesLeastRecentlyUsed)
+{
+  CSegmentedCache cache(new CCircularCache(FRONT, BACK), 2);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 1000);
+  cache.Reset(100000, false);
+  Fill(cache, 1000);
+
+  // the head was used longer ago than the end, so it makes room
+  cache.Reset(50000, false);
+  Fill(cache, 1000);
+  EXPECT_EQ(2U, cache.GetSegmentCount());
+  EXPECT_FALSE(cache.IsCachedPosition(500));
+  EXPECT_TRUE(cache.IsCachedPosition(100500));
+  EXPECT_TRUE(cache.IsCachedPosition(50500));
+
+  cache.Close();
+  EXPECT_EQ(1U, cache.GetSegmentCount());
+}
+
+TEST(TestCacheStrategy, SegmentedCacheStatusWhileSeeking)
+{
+  CSegmentedCache cache(new CCircularCache(FRONT, BACK), 8);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  Fill(cache, 1000);
+
+  // the cache thread adds and recycles segments while the player asks for the fill level
+  std::atomic<bool> done(false);
+  std::thread seeker([&cache, &done]()
+  {
+    for (int i = 0; i < 1000; i++)
+    {
+      cache.Reset((i + 1) * 100000, false);
+      Fill(cache, 100);
+    }
+    done = true;
+  });
+
+  while (!done)
+  {
+    EXPECT_GE(cache.WaitForData(0, 0), 0);
+    EXPECT_LE(cache.GetSegmentCount(), 8U);
+  }
+  seeker.join();
+  EXPECT_EQ(8U, cache.GetSegmentCount());
+}
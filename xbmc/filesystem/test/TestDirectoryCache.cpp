@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "FileItem.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void FillItems(CFileItemList& items, int dir)
+{
+  for (int i = 0; i < 10; i++)
+  {
+    std::string path = "/cache/dir" + std::to_string(dir) + "/file" + std::to_string(i) + ".mkv";
+    items.Add(CFileItemPtr(new CFileItem(path, false)));
+  }
+}
+
+std::string DirPath(int dir)
+{
+  return "/cache/dir" + std::to_string(dir) + "/";
+}
+
+size_t EntrySize()
+{
+  CFileItemList items;
+  FillItems(items, 0);
+  // the stored path has no trailing slash
+  std::string storedPath = DirPath(0);
+  storedPath.pop_back();
+  return CDirectoryCache::GetItemListSize(items) + storedPath.capacity();
+}
+}
+
+class TestDirectoryCache : public testing::Test
+{
+protected:
+  void Add(int dir, DIR_CACHE_TYPE cacheType = DIR_CACHE_ONCE)
+  {
+    CFileItemList items;
+    FillItems(items, dir);
+    cache.SetDirectory(DirPath(dir), items, cacheType);
+  }
+
+  bool Has(int dir)
+  {
+    bool inCache = false;
+    cache.FileExists(DirPath(dir) + "file0.mkv", inCache);
+    return inCache;
+  }
+
+  CDirectoryCache cache;
+};
+
+TEST_F(TestDirectoryCache, GetDirectory)
+{
+  Add(0);
+
+  CFileItemList items;
+  // listings cached once are only handed out on request
+  EXPECT_FALSE(cache.GetDirectory(DirPath(0), items));
+  EXPECT_TRUE(cache.GetDirectory(DirPath(0), items, true));
+  EXPECT_EQ(10, items.Size());
+  EXPECT_FALSE(cache.GetDirectory(DirPath(1), items, true));
+
+  bool inCache = false;
+  EXPECT_TRUE(cache.FileExists(DirPath(0) + "file9.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists(DirPath(0) + "missing.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  SDirectoryCacheStats stats = cache.GetStats();
+  EXPECT_EQ(3U, stats.hits);
+  EXPECT_EQ(2U, stats.misses);
+  EXPECT_EQ(1U, stats.directories);
+  EXPECT_EQ(EntrySize(), stats.memoryUsed);
+
+  cache.AddFile(DirPath(0) + "added.mkv");
+  EXPECT_TRUE(cache.FileExists(DirPath(0) + "added.mkv", inCache));
+  EXPECT_LT(EntrySize(), cache.GetStats().memoryUsed);
+
+  cache.ClearDirectory(DirPath(0));
+  stats = cache.GetStats();
+  EXPECT_EQ(0U, stats.directories);
+  EXPECT_EQ(0U, stats.memoryUsed);
+}
+
+TEST_F(TestDirectoryCache, EvictLeastRecentlyUsed)
+{
+  cache.SetMemoryLimit(EntrySize() * 5 / 2);
+  Add(0);
+  Add(1);
+
+  // using dir0 makes dir1 the oldest entry
+  CFileItemList items;
+  EXPECT_TRUE(cache.GetDirectory(DirPath(0), items, true));
+  Add(2);
+
+  EXPECT_TRUE(Has(0));
+  EXPECT_FALSE(Has(1));
+  EXPECT_TRUE(Has(2));
+
+  SDirectoryCacheStats stats = cache.GetStats();
+  EXPECT_EQ(1U, stats.evictions);
+  EXPECT_EQ(2U, stats.directories);
+  EXPECT_GE(stats.memoryLimit, stats.memoryUsed);
+
+  // lowering the limit evicts right away
+  cache.SetMemoryLimit(EntrySize());
+  EXPECT_FALSE(Has(0));
+  EXPECT_TRUE(Has(2));
+  EXPECT_EQ(2U, cache.GetStats().evictions);
+}
+
+TEST_F(TestDirectoryCache, KeepAlwaysCached)
+{
+  cache.SetMemoryLimit(EntrySize() * 5 / 2);
+  Add(0, DIR_CACHE_ALWAYS);
+  Add(1);
+  Add(2);
+
+  // the archive listing is older but outlives the plain one
+  EXPECT_TRUE(Has(0));
+  EXPECT_FALSE(Has(1));
+  EXPECT_TRUE(Has(2));
+
+  // and is dropped once nothing else is left to evict
+  cache.SetMemoryLimit(EntrySize() / 2);
+  EXPECT_EQ(0U, cache.GetStats().directories);
+}
+
+TEST_F(TestDirectoryCache, TooLarge)
+{
+  cache.SetMemoryLimit(EntrySize() - 1);
+  Add(0);
+
+  EXPECT_FALSE(Has(0));
+  SDirectoryCacheStats stats = cache.GetStats();
+  EXPECT_EQ(0U, stats.directories);
+  EXPECT_EQ(0U, stats.evictions);
+}
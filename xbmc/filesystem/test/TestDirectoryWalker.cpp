@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "FileItem.h"
+#include "utils/URIUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+class TestDirectoryWalker : public testing::Test
+{
+protected:
+  TestDirectoryWalker()
+  {
+    m_root = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDirectoryWalker");
+    URIUtils::AddSlashAtEnd(m_root);
+    CreateTree(m_root, 0);
+  }
+
+  ~TestDirectoryWalker()
+  {
+    CDirectory::RemoveRecursive(m_root);
+  }
+
+  void CreateTree(const std::string& path, int level)
+  {
+    CDirectory::Create(path);
+    CFile file;
+    if (file.OpenForWrite(URIUtils::AddFileToFolder(path, "file.txt")))
+      file.Close();
+    if (level == 2)
+      return;
+    for (int i = 0; i < 3; i++)
+      CreateTree(URIUtils::AddFileToFolder(path, "dir" + std::to_string(i) + "/"), level + 1);
+  }
+
+  // walk the tree as a share with 20 ms per round trip would be walked and
+  // return the most listings that were open at the same time
+  int Walk(CDirectoryWalker& walker, std::vector<std::string>& paths)
+  {
+    std::atomic<int> open(0), peak(0);
+    walker.SetListFunction([&open, &peak](const std::string& path, CFileItemList& items)
+    {
+      int current = ++open;
+      int previous = peak;
+      while (current > previous && !peak.compare_exchange_weak(previous, current))
+        ;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      bool result = CDirectory::GetDirectory(path, items);
+      --open;
+      return result;
+    });
+    walker.SetPrepareFunction([](CFileItemList& items)
+    {
+      items.Sort(SortByPath, SortOrderAscending);
+    });
+
+    walker.Start(m_root);
+    std::string path;
+    CFileItemList items;
+    while (walker.Next(path, items))
+      paths.push_back(path);
+    return peak;
+  }
+
+  static bool IsFolder(const CFileItem& item)
+  {
+    return item.m_bIsFolder;
+  }
+
+  std::string m_root;
+};
+
+TEST_F(TestDirectoryWalker, Parallel)
+{
+  std::vector<std::string> sequential;
+  CDirectoryWalker sequentialWalker;
+  sequentialWalker.SetDescendFunction(IsFolder);
+  sequentialWalker.SetConnections(1, 1);
+  const int sequentialPeak = Walk(sequentialWalker, sequential);
+
+  std::vector<std::string> parallel;
+  CDirectoryWalker parallelWalker;
+  parallelWalker.SetDescendFunction(IsFolder);
+  parallelWalker.SetConnections(8, 4);
+  const int parallelPeak = Walk(parallelWalker, parallel);
+
+  ASSERT_EQ(13U, sequential.size());
+  EXPECT_EQ(m_root, sequential[0]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "dir0/"), sequential[1]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "dir0/dir0/"), sequential[2]);
+  EXPECT_EQ(sequential, parallel);
+
+  // round trips one after another against several but at most 4 at once
+  EXPECT_EQ(1, sequentialPeak);
+  EXPECT_GT(parallelPeak, 1);
+  EXPECT_LE(parallelPeak, 4);
+}
+
+TEST_F(TestDirectoryWalker, AddChildren)
+{
+  std::vector<std::string> automatic;
+  CDirectoryWalker automaticWalker;
+  automaticWalker.SetDescendFunction(IsFolder);
+  Walk(automaticWalker, automatic);
+
+  CDirectoryWalker walker;
+  walker.SetListFunction([](const std::string& path, CFileItemList& items)
+  {
+    return CDirectory::GetDirectory(path, items);
+  });
+  walker.SetPrepareFunction([](CFileItemList& items)
+  {
+    items.Sort(SortByPath, SortOrderAscending);
+  });
+  walker.Start(m_root);
+
+  std::vector<std::string> manual;
+  std::string path;
+  CFileItemList items;
+  while (walker.Next(path, items))
+  {
+    manual.push_back(path);
+    std::vector<std::string> children;
+    for (int i = 0; i < items.Size(); i++)
+    {
+      if (items[i]->m_bIsFolder)
+        children.push_back(items[i]->GetPath());
+    }
+    walker.AddChildren(children);
+  }
+  EXPECT_EQ(automatic, manual);
+}
+
+TEST_F(TestDirectoryWalker, SkipAndCancel)
+{
+  CDirectoryWalker walker;
+  walker.SetDescendFunction(IsFolder);
+  walker.SetPrepareFunction([](CFileItemList& items)
+  {
+    items.Sort(SortByPath, SortOrderAscending);
+  });
+  walker.SetLookahead(2);
+  walker.Start(m_root);
+
+  const std::string skipped = URIUtils::AddFileToFolder(m_root, "dir1/");
+  std::string path;
+  CFileItemList items;
+  int count = 0;
+  while (walker.Next(path, items))
+  {
+    EXPECT_FALSE(URIUtils::PathHasParent(path, skipped) && path != skipped);
+    if (path == skipped)
+      walker.SkipChildren();
+    count++;
+  }
+  EXPECT_EQ(10, count);
+
+  CDirectoryWalker cancelled;
+  cancelled.SetDescendFunction(IsFolder);
+  cancelled.Start(m_root);
+  EXPECT_TRUE(cancelled.Next(path, items));
+  EXPECT_EQ(m_root, path);
+  cancelled.Cancel();
+  EXPECT_FALSE(cancelled.Next(path, items));
+}
@@ -19,10 +19,15 @@
  */
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "test/TestUtils.h"
 
 #include <string>
+#include <vector>
 #include <errno.h>
+#ifdef TARGET_POSIX
+#include <unistd.h>
+#endif
 
 #include "gtest/gtest.h"
 
@@ -219,3 +224,74 @@ TEST(TestFile, SetHidden)
   EXPECT_TRUE(XFILE::CFile::Exists(XBMC_TEMPFILEPATH(file)));
   EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
 }
+
+#ifdef TARGET_POSIX
+TEST(TestFile, MemoryMapped)
+{
+  XFILE::CFile *file;
+  // large enough that reads cross from one mapped window into the next
+  std::vector<uint8_t> data(40 * 1024 * 1024);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<uint8_t>(i * 7 + i / 4096);
+
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+  ASSERT_EQ((ssize_t)data.size(), file->Write(data.data(), data.size()));
+  file->Close();
+
+  ASSERT_TRUE(file->Open(XBMC_TEMPFILEPATH(file), XFILE::READ_NO_CACHE));
+  EXPECT_EQ(1, file->IoControl(XFILE::IOCTRL_MMAP, NULL));
+
+  std::vector<uint8_t> buf(1024 * 1024);
+  size_t pos = 0;
+  ssize_t read;
+  while ((read = file->Read(buf.data(), buf.size())) > 0)
+  {
+    ASSERT_EQ(0, memcmp(data.data() + pos, buf.data(), read));
+    pos += read;
+  }
+  EXPECT_EQ(0, read);
+  EXPECT_EQ(data.size(), pos);
+
+  const int64_t window = 32 * 1024 * 1024;
+  EXPECT_EQ(window - 10, file->Seek(window - 10, SEEK_SET));
+  EXPECT_EQ(20, file->Read(buf.data(), 20));
+  EXPECT_EQ(0, memcmp(data.data() + window - 10, buf.data(), 20));
+  EXPECT_EQ(window + 10, file->GetPosition());
+  EXPECT_EQ((int64_t)data.size() - 5, file->Seek(-5, SEEK_END));
+  EXPECT_EQ(5, file->Read(buf.data(), buf.size()));
+  EXPECT_EQ(0, memcmp(data.data() + data.size() - 5, buf.data(), 5));
+  EXPECT_EQ(1, file->IoControl(XFILE::IOCTRL_SEEK_POSSIBLE, NULL));
+  file->Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestFile, MemoryMappedTruncated)
+{
+  XFILE::CFile *file;
+  std::vector<uint8_t> data(1024 * 1024, 'x');
+
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+  ASSERT_EQ((ssize_t)data.size(), file->Write(data.data(), data.size()));
+  file->Close();
+
+  ASSERT_TRUE(file->Open(XBMC_TEMPFILEPATH(file), XFILE::READ_NO_CACHE));
+  EXPECT_EQ(1, file->IoControl(XFILE::IOCTRL_MMAP, NULL));
+  std::vector<uint8_t> buf(4096);
+  EXPECT_EQ(4096, file->Read(buf.data(), buf.size()));
+
+  // someone else truncates the file while it is mapped, reading past its
+  // new end must not raise SIGBUS but end the file
+  ASSERT_EQ(0, truncate(CSpecialProtocol::TranslatePath(XBMC_TEMPFILEPATH(file)).c_str(), 8192));
+  EXPECT_EQ(512 * 1024, file->Seek(512 * 1024, SEEK_SET));
+  EXPECT_EQ(0, file->Read(buf.data(), buf.size()));
+  EXPECT_EQ(4096, file->Seek(4096, SEEK_SET));
+  EXPECT_EQ(4096, file->Read(buf.data(), buf.size()));
+  EXPECT_EQ('x', buf[4095]);
+  file->Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+#endif
@@ -0,0 +1,153 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/IDirectory.h"
+#include "filesystem/PersistentDirectoryCache.h"
+#include "FileItem.h"
+#include "URL.h"
+
+#include <thread>
+#include <time.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+class TestPersistentDirectoryCache : public testing::Test
+{
+protected:
+  TestPersistentDirectoryCache() : url("smb://server/share/movies/")
+  {
+    CPersistentDirectoryCache::GetInstance().SetEnabled(true);
+    for (int i = 0; i < 3; i++)
+    {
+      CFileItemPtr item(new CFileItem("smb://server/share/movies/movie" + std::to_string(i) + ".mkv", false));
+      item->m_dwSize = 1000 + i;
+      items.Add(item);
+    }
+  }
+
+  ~TestPersistentDirectoryCache()
+  {
+    CPersistentDirectoryCache::GetInstance().Clear();
+    CPersistentDirectoryCache::GetInstance().SetEnabled(false);
+  }
+
+  CURL url;
+  CFileItemList items;
+};
+
+TEST_F(TestPersistentDirectoryCache, RoundTrip)
+{
+  CPersistentDirectoryCache& cache = CPersistentDirectoryCache::GetInstance();
+  cache.SetDirectory(url, 1000, DIR_FLAG_DEFAULTS, items);
+
+  CFileItemList loaded;
+  ASSERT_TRUE(cache.GetDirectory(url, 1000, DIR_FLAG_DEFAULTS, loaded));
+  ASSERT_EQ(3, loaded.Size());
+  for (int i = 0; i < 3; i++)
+  {
+    EXPECT_EQ(items[i]->GetPath(), loaded[i]->GetPath());
+    EXPECT_EQ(items[i]->m_dwSize, loaded[i]->m_dwSize);
+  }
+
+  // the same directory with and without options or a trailing slash
+  CFileItemList other;
+  EXPECT_TRUE(cache.GetDirectory(CURL("smb://server/share/movies|option=1"), 1000, DIR_FLAG_DEFAULTS, other));
+}
+
+TEST_F(TestPersistentDirectoryCache, Modified)
+{
+  CPersistentDirectoryCache& cache = CPersistentDirectoryCache::GetInstance();
+  cache.SetDirectory(url, 1000, DIR_FLAG_DEFAULTS, items);
+
+  CFileItemList loaded;
+  EXPECT_FALSE(cache.GetDirectory(url, 1001, DIR_FLAG_DEFAULTS, loaded));
+  EXPECT_FALSE(cache.GetDirectory(CURL("smb://server/share/tvshows/"), 1000, DIR_FLAG_DEFAULTS, loaded));
+
+  cache.ClearDirectory(url);
+  EXPECT_FALSE(cache.GetDirectory(url, 1000, DIR_FLAG_DEFAULTS, loaded));
+
+  // a directory that just changed may change again within its mtime resolution
+  const int64_t now = time(nullptr);
+  cache.SetDirectory(url, now, DIR_FLAG_DEFAULTS, items);
+  EXPECT_FALSE(cache.GetDirectory(url, now, DIR_FLAG_DEFAULTS, loaded));
+}
+
+TEST_F(TestPersistentDirectoryCache, NoFileInfo)
+{
+  CPersistentDirectoryCache& cache = CPersistentDirectoryCache::GetInstance();
+  CFileItemList bare;
+  for (int i = 0; i < 3; i++)
+    bare.Add(CFileItemPtr(new CFileItem(items[i]->GetPath(), false)));
+  cache.SetDirectory(url, 1000, DIR_FLAG_NO_FILE_INFO, bare);
+
+  // a listing without sizes and dates must not answer a full listing
+  CFileItemList loaded;
+  EXPECT_FALSE(cache.GetDirectory(url, 1000, DIR_FLAG_DEFAULTS, loaded));
+  ASSERT_TRUE(cache.GetDirectory(url, 1000, DIR_FLAG_NO_FILE_INFO, loaded));
+  EXPECT_EQ(0, loaded[0]->m_dwSize);
+
+  // once the full listing is stored it serves both
+  cache.SetDirectory(url, 1000, DIR_FLAG_DEFAULTS, items);
+  loaded.Clear();
+  ASSERT_TRUE(cache.GetDirectory(url, 1000, DIR_FLAG_DEFAULTS, loaded));
+  EXPECT_EQ(1000, loaded[0]->m_dwSize);
+  loaded.Clear();
+  ASSERT_TRUE(cache.GetDirectory(url, 1000, DIR_FLAG_NO_FILE_INFO, loaded));
+  EXPECT_EQ(1000, loaded[0]->m_dwSize);
+
+  cache.ClearDirectory(url);
+  EXPECT_FALSE(cache.GetDirectory(url, 1000, DIR_FLAG_NO_FILE_INFO, loaded));
+}
+
+TEST_F(TestPersistentDirectoryCache, Concurrent)
+{
+  // listings of several directories stored and loaded at once each come back intact
+  CPersistentDirectoryCache& cache = CPersistentDirectoryCache::GetInstance();
+  std::vector<int> loadedSizes(8, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++)
+  {
+    threads.emplace_back([&cache, &loadedSizes, t, this]()
+    {
+      const CURL folder("smb://server/share/folder" + std::to_string(t) + "/");
+      for (int i = 0; i < 20; i++)
+      {
+        cache.SetDirectory(folder, 1000 + t, DIR_FLAG_DEFAULTS, items);
+        CFileItemList loaded;
+        if (cache.GetDirectory(folder, 1000 + t, DIR_FLAG_DEFAULTS, loaded))
+          loadedSizes[t] = loaded.Size();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (int t = 0; t < 8; t++)
+    EXPECT_EQ(3, loadedSizes[t]) << "folder " << t;
+}
+
+TEST_F(TestPersistentDirectoryCache, UnsupportedProtocol)
+{
+  int64_t modified = 0;
+  EXPECT_FALSE(CPersistentDirectoryCache::GetInstance().GetModificationTime(CURL("http://server/movies/"), modified));
+}
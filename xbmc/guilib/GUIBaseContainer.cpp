@@ -160,10 +160,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   if (focused)
   {
     if (!item->GetFocusedLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout);
-      item->SetFocusedLayout(layout);
-    }
+      item->SetFocusedLayout(m_focusedLayoutPool.Get(*m_focusedLayout));
     if (item->GetFocusedLayout())
     {
       if (item != m_lastItem || !HasFocus())
@@ -187,10 +184,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
     if (!item->GetLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      item->SetLayout(layout);
-    }
+      item->SetLayout(m_layoutPool.Get(*m_layout));
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     if (item->GetLayout())
@@ -863,6 +857,8 @@ void CGUIBaseContainer::AllocResources()
 void CGUIBaseContainer::FreeResources(bool immediately)
 {
   CGUIControl::FreeResources(immediately);
+  m_layoutPool.Clear();
+  m_focusedLayoutPool.Clear();
   if (m_listProvider)
   {
     if (immediately)
@@ -1181,20 +1177,30 @@ void CGUIBaseContainer::SetRenderOffset(const CPoint &offset)
 
 void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
 {
+  // keep enough layouts around to fill the items scrolling in on a page down
+  m_layoutPool.SetCapacity(std::max(m_itemsPerPage, 0));
+  m_focusedLayoutPool.SetCapacity(std::max(m_itemsPerPage, 0));
+
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
     for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i].get());
     for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i].get());
   }
   else
   { // wrapping
     for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleLayouts(m_items[i].get());
   }
 }
 
+void CGUIBaseContainer::RecycleLayouts(CGUIListItem *item)
+{
+  m_layoutPool.Recycle(item->ReleaseLayout(), m_layout);
+  m_focusedLayoutPool.Recycle(item->ReleaseFocusedLayout(), m_focusedLayout);
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
@@ -136,6 +136,7 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  void RecycleLayouts(CGUIListItem *item);
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -158,6 +159,8 @@ protected:
 
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
+  CGUIListItemLayoutPool m_layoutPool;
+  CGUIListItemLayoutPool m_focusedLayoutPool;
   bool m_layoutCondition = false;
   bool m_focusedLayoutCondition = false;
 
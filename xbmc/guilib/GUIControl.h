@@ -218,7 +218,7 @@ public:
   bool HasVisibleCondition() const { return m_visibleCondition != NULL; };
   void SetEnableCondition(const std::string &expression);
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
-  virtual void SetInitialVisibility();
+  virtual void SetInitialVisibility(const CGUIListItem *item = NULL);
   virtual void SetEnabled(bool bEnable);
   virtual void SetInvalid() { m_bInvalidated = true; };
   virtual void SetPulseOnSelect(bool pulse) { m_pulseOnSelect = pulse; };
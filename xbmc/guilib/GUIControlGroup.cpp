@@ -298,11 +298,11 @@ bool CGUIControlGroup::CanFocus() const
   return false;
 }
 
-void CGUIControlGroup::SetInitialVisibility()
+void CGUIControlGroup::SetInitialVisibility(const CGUIListItem *item)
 {
-  CGUIControl::SetInitialVisibility();
+  CGUIControl::SetInitialVisibility(item);
   for (auto *control : m_children)
-    control->SetInitialVisibility();
+    control->SetInitialVisibility(item);
 }
 
 void CGUIControlGroup::QueueAnimation(ANIMATION_TYPE animType)
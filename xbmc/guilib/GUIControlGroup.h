@@ -57,7 +57,7 @@ public:
   virtual EVENT_RESULT SendMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual void UnfocusFromPoint(const CPoint &point);
 
-  virtual void SetInitialVisibility();
+  virtual void SetInitialVisibility(const CGUIListItem *item = NULL);
 
   virtual bool IsAnimating(ANIMATION_TYPE anim);
   virtual bool HasAnimation(ANIMATION_TYPE anim);
@@ -385,6 +385,20 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
   return m_focusedLayout;
 }
 
+CGUIListItemLayout *CGUIListItem::ReleaseLayout()
+{
+  CGUIListItemLayout *layout = m_layout;
+  m_layout = NULL;
+  return layout;
+}
+
+CGUIListItemLayout *CGUIListItem::ReleaseFocusedLayout()
+{
+  CGUIListItemLayout *layout = m_focusedLayout;
+  m_focusedLayout = NULL;
+  return layout;
+}
+
 void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
@@ -148,6 +148,12 @@ public:
   void SetFocusedLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetFocusedLayout();
 
+  /*! \brief Detach the layouts from the item without deleting them
+   The caller takes ownership, e.g. to reuse them for another item.
+   */
+  CGUIListItemLayout *ReleaseLayout();
+  CGUIListItemLayout *ReleaseFocusedLayout();
+
   void FreeIcons();
   void FreeMemory(bool immediately = false);
   void SetInvalid();
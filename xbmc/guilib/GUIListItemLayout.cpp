@@ -27,6 +27,10 @@
 #include "GUIImage.h"
 #include "utils/XBMCTinyXML.h"
 
+#include <atomic>
+
+static std::atomic<unsigned int> nextTemplateId(0);
+
 CGUIListItemLayout::CGUIListItemLayout()
 : m_group(0, 0, 0, 0, 0, 0)
 {
@@ -34,6 +38,8 @@ CGUIListItemLayout::CGUIListItemLayout()
   m_height = 0;
   m_focused = false;
   m_invalidated = true;
+  m_recycled = false;
+  m_templateId = ++nextTemplateId;
   m_group.SetPushUpdates(true);
 }
 
@@ -45,6 +51,8 @@ CGUIListItemLayout::CGUIListItemLayout(const CGUIListItemLayout &from)
   m_focused = from.m_focused;
   m_condition = from.m_condition;
   m_invalidated = true;
+  m_recycled = false;
+  m_templateId = from.m_templateId;
 }
 
 CGUIListItemLayout::~CGUIListItemLayout()
@@ -77,6 +85,11 @@ void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int
     m_isPlaying.Update(item);
     m_group.SetInvalid();
     m_group.UpdateInfo(fileItem);
+    if (m_recycled)
+    {
+      m_group.SetInitialVisibility(item);
+      m_recycled = false;
+    }
     // delete our temporary fileitem
     if (!item->IsFileItem())
       delete fileItem;
@@ -228,6 +241,78 @@ void CGUIListItemLayout::FreeResources(bool immediately)
   m_group.FreeResources(immediately);
 }
 
+void CGUIListItemLayout::Recycle()
+{
+  // drop the focus first, else the unfocus animation would be queued again
+  m_group.SetFocusedItem(0);
+  m_group.FreeResources();
+  m_group.ResetAnimations();
+  m_invalidated = true;
+  m_recycled = true;
+}
+
+CGUIListItemLayoutPool &CGUIListItemLayoutPool::operator=(const CGUIListItemLayoutPool &from)
+{
+  // pooled layouts belong to the container owning this pool, don't share them
+  Clear();
+  m_capacity = from.m_capacity;
+  return *this;
+}
+
+CGUIListItemLayoutPool::~CGUIListItemLayoutPool()
+{
+  Clear();
+}
+
+CGUIListItemLayout *CGUIListItemLayoutPool::Get(const CGUIListItemLayout &source)
+{
+  if (!m_layouts.empty())
+  {
+    CGUIListItemLayout *layout = m_layouts.back();
+    if (layout->IsCopyOf(source))
+    {
+      m_layouts.pop_back();
+      return layout;
+    }
+    // the container switched layouts, the pooled ones are of no use anymore
+    Clear();
+  }
+  return new CGUIListItemLayout(source);
+}
+
+void CGUIListItemLayoutPool::Recycle(CGUIListItemLayout *layout, const CGUIListItemLayout *source)
+{
+  if (!layout)
+    return;
+  if (source && layout->IsCopyOf(*source) && m_layouts.size() < m_capacity)
+  {
+    layout->Recycle();
+    m_layouts.push_back(layout);
+  }
+  else
+  {
+    layout->FreeResources();
+    delete layout;
+  }
+}
+
+void CGUIListItemLayoutPool::SetCapacity(size_t capacity)
+{
+  m_capacity = capacity;
+  while (m_layouts.size() > m_capacity)
+  {
+    delete m_layouts.back();
+    m_layouts.pop_back();
+  }
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  for (CGUIListItemLayout *layout : m_layouts)
+    delete layout;
+  m_layouts.clear();
+}
+
 #ifdef _DEBUG
 void CGUIListItemLayout::DumpTextureUse()
 {
@@ -24,6 +24,8 @@
 #include "GUITexture.h"
 #include "GUIInfoTypes.h"
 
+#include <vector>
+
 class CGUIListItem;
 class CFileItem;
 class CLabelInfo;
@@ -45,6 +47,15 @@ public:
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
 
+  /*! \brief Prepare the layout to show a different item
+   Frees the resources of the current item. The next Process() sets the
+   visibility and conditional animations straight from the new item, rather
+   than animating from the state of the previous one.
+   */
+  void Recycle();
+  /*! \brief Whether this layout is the given layout or a copy of it */
+  bool IsCopyOf(const CGUIListItemLayout &layout) const { return m_templateId == layout.m_templateId; }
+
 //#ifdef GUILIB_PYTHON_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const std::string &nofocusCondition, const std::string &focusCondition);
 //#endif
@@ -69,8 +80,47 @@ protected:
   float m_height;
   bool m_focused;
   bool m_invalidated;
+  bool m_recycled;
+  unsigned int m_templateId; ///< shared by a layout loaded from the skin and all its copies
 
   INFO::InfoPtr m_condition;
   CGUIInfoBool m_isPlaying;
 };
 
+/*!
+ \brief Keeps the item layouts of a container that scrolled out of view
+
+ Instead of deleting the layout of an item leaving the view and copying the
+ skin's layout again for the next item coming in, the container hands the
+ layout back here and reuses it. The container caps the pool at a page of
+ items, so together with the layouts in use memory stays proportional to
+ the visible and cached items.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool() : m_capacity(0) {}
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &from) : m_capacity(from.m_capacity) {}
+  CGUIListItemLayoutPool &operator=(const CGUIListItemLayoutPool &from);
+  ~CGUIListItemLayoutPool();
+
+  /*! \brief Get a copy of the given layout, reusing a pooled one if available
+   \param source the layout loaded from the skin
+   \return the layout, owned by the caller
+   */
+  CGUIListItemLayout *Get(const CGUIListItemLayout &source);
+  /*! \brief Take back a layout that is no longer used
+   Layouts which aren't copies of source or don't fit into the pool are deleted.
+   \param layout the layout to take ownership of
+   \param source the layout currently in use by the container, may be NULL
+   */
+  void Recycle(CGUIListItemLayout *layout, const CGUIListItemLayout *source);
+  void SetCapacity(size_t capacity);
+  size_t GetSize() const { return m_layouts.size(); }
+  void Clear();
+
+private:
+  std::vector<CGUIListItemLayout*> m_layouts;
+  size_t m_capacity;
+};
+
@@ -840,11 +840,11 @@ bool CGUIWindow::Initialize()
   return m_windowLoaded;
 }
 
-void CGUIWindow::SetInitialVisibility()
+void CGUIWindow::SetInitialVisibility(const CGUIListItem *item)
 {
   // reset our info manager caches
   g_infoManager.ResetCache();
-  CGUIControlGroup::SetInitialVisibility();
+  CGUIControlGroup::SetInitialVisibility(item);
 }
 
 bool CGUIWindow::IsActive() const
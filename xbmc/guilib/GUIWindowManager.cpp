@@ -35,6 +35,7 @@
 #include "utils/Variant.h"
 #include "input/Key.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "utils/SeekHandler.h"
 
@@ -441,6 +442,8 @@ bool CGUIWindowManager::SendMessage(int message, int senderID, int destID, int p
 bool CGUIWindowManager::SendMessage(CGUIMessage& message)
 {
   bool handled = false;
+  // messages are sent for playback, library and window changes alike
+  g_infoManager.PublishChange(INFO::INFO_DEP_ALL);
 //  CLog::Log(LOGDEBUG,"SendMessage: mess=%d send=%d control=%d param1=%d", message.GetMessage(), message.GetSenderId(), message.GetControlId(), message.GetParam1());
   // Send the message to all none window targets
   for (int i = 0; i < (int) m_vecMsgTargets.size(); i++)
@@ -534,6 +537,7 @@ bool CGUIWindowManager::SendMessage(CGUIMessage& message, int window)
   if (window == 0)
     // send to no specified windows.
     return SendMessage(message);
+  g_infoManager.PublishChange(INFO::INFO_DEP_ALL);
   CGUIWindow* pWindow = GetWindow(window);
   if(pWindow)
     return pWindow->OnMessage(message);
@@ -594,6 +598,7 @@ void CGUIWindowManager::RegisterDialog(CGUIWindow* dialog)
       return;
   }
   m_activeDialogs.push_back(dialog);
+  g_infoManager.PublishChange(INFO::INFO_DEP_WINDOW);
 }
 
 void CGUIWindowManager::Remove(int id)
@@ -1017,6 +1022,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  TRACE_FUNCTION("gui");
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyregions;
@@ -1088,6 +1094,7 @@ void CGUIWindowManager::RenderEx() const
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  TRACE_FUNCTION("gui");
   CSingleExit lock(g_graphicsContext);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
@@ -1274,6 +1281,7 @@ void CGUIWindowManager::RemoveDialog(int id)
                                        m_activeDialogs.end(),
                                        [id](CGUIWindow* dialog) { return dialog->GetID() == id; }),
                          m_activeDialogs.end());
+  g_infoManager.PublishChange(INFO::INFO_DEP_WINDOW);
 }
 
 bool CGUIWindowManager::HasModalDialog(const std::vector<DialogModalityType>& types, bool ignoreClosing /* = true */) const
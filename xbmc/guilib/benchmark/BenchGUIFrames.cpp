@@ -0,0 +1,252 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BenchScreens.h"
+#include "FileItem.h"
+#include "guilib/DirtyRegionTracker.h"
+#include "guilib/GUIImage.h"
+#include "guilib/GUILabelControl.h"
+#include "guilib/GUIListContainer.h"
+#include "guilib/GUIMessage.h"
+#include "guilib/GUIWindow.h"
+#include "guilib/GUIWindowManager.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/VisibleEffect.h"
+#include "guilib/WindowIDs.h"
+#include "input/Action.h"
+#include "input/ActionIDs.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+const int HOME_ROWS = 4;
+const int LIST_CONTROL = 50;
+
+// the navigation script, in frames of 16ms
+const int FRAMES_PER_CYCLE = 600;
+const int LIBRARY_OPEN = 120;
+const int INFO_OPEN = 360;
+const int INFO_CLOSE = 400;
+const int INFO_CLOSED = 420;
+const int LIBRARY_CLOSE = 480;
+
+const CRect SCREEN(0, 0, 1920, 1080);
+
+CGUIWindow* CreateBenchWindow(int id)
+{
+  CGUIWindow *window = new CGUIWindow(id, "");
+  window->SetCoordsRes(RESOLUTION_INFO(1920, 1080));
+  return window;
+}
+
+// The video library of the skin in KODI_BENCH_SKIN, showing the whole
+// library in its first view. Without a skin, a plain list laid out like the
+// list view of the video library with an icon and two labels per item.
+CGUIWindow* CreateLibrary(int items, CFileItemList &list, int &listControl)
+{
+  for (int i = 0; i < items; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("Movie %05i", i)));
+    item->SetLabel2(StringUtils::Format("%i", 1950 + i % 70));
+    item->SetIconImage("DefaultVideo.png");
+    list.Add(item);
+  }
+
+  std::vector<CGUIControl*> views;
+  CGUIWindow *window = CBenchScreens::LoadSkinWindow(WINDOW_VIDEO_NAV, "MyVideoNav.xml", views);
+  CGUIControl *container = nullptr;
+  if (window && !views.empty())
+    container = views.front();
+  else
+  {
+    delete window;
+    window = CreateBenchWindow(WINDOW_VIDEO_NAV);
+    window->AddControl(new CGUIImage(WINDOW_VIDEO_NAV, 0, 0, 0, 1920, 1080, CTextureInfo()));
+    container = new CGUIListContainer(WINDOW_VIDEO_NAV, LIST_CONTROL, 420, 80, 1400, 900,
+                                      CLabelInfo(), CLabelInfo(), CTextureInfo(), CTextureInfo(),
+                                      60, 60, 60, 0);
+    window->AddControl(container);
+  }
+
+  listControl = container->GetID();
+  CGUIMessage msg(GUI_MSG_LABEL_BIND, WINDOW_VIDEO_NAV, listControl, 0, 0, &list);
+  container->OnMessage(msg);
+  container->SetFocus(true);
+  return window;
+}
+
+// The video info dialog of the skin in KODI_BENCH_SKIN, or an info dialog
+// with artwork and a handful of labels that fades in and out
+CGUIWindow* CreateInfoDialog()
+{
+  std::vector<CGUIControl*> views;
+  CGUIWindow *skinned = CBenchScreens::LoadSkinWindow(WINDOW_DIALOG_VIDEO_INFO, "DialogVideoInfo.xml", views);
+  if (skinned)
+    return skinned;
+
+  CGUIWindow *dialog = CreateBenchWindow(WINDOW_DIALOG_VIDEO_INFO);
+  dialog->SetAnimations({ CAnimation::CreateFader(0, 100, 0, 300, ANIM_TYPE_WINDOW_OPEN),
+                          CAnimation::CreateFader(100, 0, 0, 200, ANIM_TYPE_WINDOW_CLOSE) });
+  dialog->AddControl(new CGUIImage(WINDOW_DIALOG_VIDEO_INFO, 0, 160, 90, 1600, 900, CTextureInfo()));
+  dialog->AddControl(new CGUIImage(WINDOW_DIALOG_VIDEO_INFO, 0, 200, 130, 540, 800, CTextureInfo()));
+  for (int i = 0; i < 8; i++)
+  {
+    CGUILabelControl *label = new CGUILabelControl(WINDOW_DIALOG_VIDEO_INFO, 0, 780, 130 + i * 60.0f, 940, 50,
+                                                   CLabelInfo(), false, false);
+    label->SetLabel(StringUtils::Format("Detail %i", i));
+    dialog->AddControl(label);
+  }
+  return dialog;
+}
+
+double Percentile(std::vector<double> &samples, double fraction)
+{
+  if (samples.empty())
+    return 0.0;
+  std::vector<double>::iterator nth = samples.begin() + static_cast<size_t>(fraction * (samples.size() - 1));
+  std::nth_element(samples.begin(), nth, samples.end());
+  return *nth;
+}
+}
+
+// Runs the frame loop of the window manager over a scripted session: browse
+// the home screen, open the library and scroll through it, open an info
+// dialog and go back home. The library and the info dialog are loaded from
+// the skin in KODI_BENCH_SKIN if set, otherwise built in code like the home
+// screen. The windows are driven directly rather than activated, so no
+// window history is needed, and with the render
+// system never created the render pass traverses the controls without
+// issuing any draw calls. Each iteration is one frame. Process and render
+// time percentiles are reported in microseconds, next to the number of dirty
+// regions rendered per frame.
+static void BM_GUIFrames_Navigation(benchmark::State& state)
+{
+  std::vector<CGUIControl*> posters;
+  CGUIWindow *home = CreateBenchWindow(WINDOW_HOME);
+  home->AddControl(CBenchScreens::CreateHomeScreen(HOME_ROWS, posters));
+  CFileItemList items;
+  int listControl = LIST_CONTROL;
+  CGUIWindow *library = CreateLibrary(state.range(0), items, listControl);
+  CGUIWindow *dialog = CreateInfoDialog();
+
+  // registered so that info bools like control.hasfocus() find the windows
+  for (CGUIWindow *window : { home, library, dialog })
+  {
+    g_windowManager.Add(window);
+    window->AllocResources();
+  }
+
+  CDirtyRegionTracker tracker;
+  tracker.SelectAlgorithm();
+
+  std::vector<double> processTimes;
+  std::vector<double> renderTimes;
+  unsigned int currentTime = 0;
+  size_t focused = 0;
+  int64_t frames = 0;
+  int64_t regions = 0;
+  posters[focused]->SetFocus(true);
+  for (auto _ : state)
+  {
+    const int frame = frames++ % FRAMES_PER_CYCLE;
+    currentTime += 16;
+
+    CGUIWindow *window = home;
+    if (frame >= LIBRARY_OPEN && frame < LIBRARY_CLOSE)
+      window = library;
+    if (frame == LIBRARY_OPEN || frame == LIBRARY_CLOSE || frame == INFO_CLOSED)
+      tracker.MarkDirtyRegion(SCREEN);
+
+    if (window == home && frame % 8 == 0)
+    {
+      posters[focused]->SetFocus(false);
+      focused = (focused + 1) % posters.size();
+      posters[focused]->SetFocus(true);
+    }
+    else if (window == library && (frame < INFO_OPEN || frame >= INFO_CLOSED))
+    {
+      if (frame % 60 == 0)
+        library->OnAction(CAction(ACTION_PAGE_DOWN));
+      else if (frame % 4 == 0)
+        library->OnAction(CAction(ACTION_MOVE_DOWN));
+    }
+    if (frame == FRAMES_PER_CYCLE - 1)
+    {
+      CGUIMessage msg(GUI_MSG_ITEM_SELECT, WINDOW_VIDEO_NAV, listControl, 0);
+      library->OnMessage(msg);
+    }
+
+    const bool showDialog = frame >= INFO_OPEN && frame < INFO_CLOSED;
+    if (frame == INFO_OPEN)
+      dialog->QueueAnimation(ANIM_TYPE_WINDOW_OPEN);
+    else if (frame == INFO_CLOSE)
+      dialog->QueueAnimation(ANIM_TYPE_WINDOW_CLOSE);
+
+    const auto start = std::chrono::steady_clock::now();
+    CDirtyRegionList dirtyregions;
+    window->DoProcess(currentTime, dirtyregions);
+    if (showDialog)
+      dialog->DoProcess(currentTime, dirtyregions);
+    for (const CDirtyRegion &region : dirtyregions)
+      tracker.MarkDirtyRegion(region);
+    const auto processed = std::chrono::steady_clock::now();
+
+    CDirtyRegionList renderRegions = tracker.GetDirtyRegions();
+    for (const CDirtyRegion &region : renderRegions)
+    {
+      if (region.IsEmpty())
+        continue;
+      g_graphicsContext.SetScissors(region);
+      window->DoRender();
+      if (showDialog)
+        dialog->DoRender();
+      regions++;
+    }
+    g_graphicsContext.ResetScissors();
+    tracker.CleanMarkedRegions();
+    const auto rendered = std::chrono::steady_clock::now();
+
+    processTimes.push_back(std::chrono::duration<double, std::micro>(processed - start).count());
+    renderTimes.push_back(std::chrono::duration<double, std::micro>(rendered - processed).count());
+  }
+
+  state.counters["process_p50"] = Percentile(processTimes, 0.50);
+  state.counters["process_p95"] = Percentile(processTimes, 0.95);
+  state.counters["process_p99"] = Percentile(processTimes, 0.99);
+  state.counters["render_p50"] = Percentile(renderTimes, 0.50);
+  state.counters["render_p95"] = Percentile(renderTimes, 0.95);
+  state.counters["render_p99"] = Percentile(renderTimes, 0.99);
+  state.counters["dirtyregions"] = benchmark::Counter(static_cast<double>(regions) / frames);
+
+  for (CGUIWindow *window : { home, library, dialog })
+  {
+    g_windowManager.Remove(window->GetID());
+    window->FreeResources(true);
+    delete window;
+  }
+  CBenchScreens::UnloadSkin();
+}
+BENCHMARK(BM_GUIFrames_Navigation)->Arg(1000)->Arg(20000);
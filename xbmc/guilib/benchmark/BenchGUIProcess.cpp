@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BenchScreens.h"
+#include "guilib/DirtyRegion.h"
+#include "guilib/GUIControlGroup.h"
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Processes one frame of the home screen per iteration while the focus moves
+// through the widgets every few frames and the artwork of the focused row is
+// refreshed, as happens while browsing. Measures the CPU side of a frame on
+// the render thread, without any rendering.
+static void BM_GUIProcess_HomeScreen(benchmark::State& state)
+{
+  std::vector<CGUIControl*> posters;
+  CGUIControlGroup *root = CBenchScreens::CreateHomeScreen(state.range(0), posters);
+  root->AllocResources();
+
+  unsigned int currentTime = 0;
+  size_t focused = 0;
+  int64_t frames = 0;
+  int64_t regions = 0;
+  posters[focused]->SetFocus(true);
+  for (auto _ : state)
+  {
+    currentTime += 16;
+    if (++frames % 8 == 0)
+    {
+      posters[focused]->SetFocus(false);
+      focused = (focused + 1) % posters.size();
+      posters[focused]->SetFocus(true);
+    }
+    const size_t rowStart = focused - focused % CBenchScreens::WIDGET_ITEMS;
+    for (size_t i = rowStart; i < rowStart + CBenchScreens::WIDGET_ITEMS; i++)
+      posters[i]->SetInvalid();
+
+    CDirtyRegionList dirtyregions;
+    root->UpdateVisibility();
+    root->DoProcess(currentTime, dirtyregions);
+    regions += dirtyregions.size();
+  }
+
+  state.counters["controls"] = CBenchScreens::GetHomeScreenControls(state.range(0));
+  state.counters["dirtyregions"] = benchmark::Counter(static_cast<double>(regions) / frames);
+  root->FreeResources(true);
+  delete root;
+}
+BENCHMARK(BM_GUIProcess_HomeScreen)->Arg(2)->Arg(4)->Arg(8);
@@ -0,0 +1,149 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BenchScreens.h"
+#include "addons/AddonInfo.h"
+#include "addons/Skin.h"
+#include "guilib/GUIControlGroup.h"
+#include "guilib/GUIImage.h"
+#include "guilib/GUIWindow.h"
+#include "guilib/VisibleEffect.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <cstdlib>
+#include <memory>
+
+namespace
+{
+// A plain window that keeps the containers of its <views> tag, the way
+// CGUIMediaWindow hands them to its view control
+class CBenchSkinWindow : public CGUIWindow
+{
+public:
+  CBenchSkinWindow(int id, const std::string &file) : CGUIWindow(id, file) {}
+
+  std::vector<CGUIControl*> m_views;
+
+protected:
+  void LoadAdditionalTags(TiXmlElement *root) override
+  {
+    CGUIWindow::LoadAdditionalTags(root);
+    TiXmlElement *element = root->FirstChildElement("views");
+    if (!element || !element->FirstChild())
+      return;
+    for (const std::string &view : StringUtils::Split(element->FirstChild()->ValueStr(), ","))
+    {
+      CGUIControl *control = GetControl(atoi(view.c_str()));
+      if (control && control->IsContainer())
+        m_views.push_back(control);
+    }
+  }
+};
+
+bool skinLoaded = false;
+
+bool LoadBenchSkin()
+{
+  if (skinLoaded)
+    return true;
+  const char *path = getenv("KODI_BENCH_SKIN");
+  if (!path)
+    return false;
+
+  ADDON::AddonInfoPtr info = std::make_shared<ADDON::CAddonInfo>(path);
+  if (!info->IsUsable() || info->MainType() != ADDON::ADDON_SKIN)
+  {
+    CLog::Log(LOGERROR, "CBenchScreens: %s is not a skin", path);
+    return false;
+  }
+  std::shared_ptr<ADDON::CSkinInfo> skin = std::make_shared<ADDON::CSkinInfo>(info);
+  skin->Start();
+  skin->LoadIncludes();
+  g_SkinInfo = skin;
+  skinLoaded = true;
+  return true;
+}
+}
+
+CGUIControlGroup* CBenchScreens::CreateHomeScreen(int rows, std::vector<CGUIControl*> &posters)
+{
+  CGUIControlGroup *root = new CGUIControlGroup(0, 0, 0, 0, 1920, 1080);
+  root->AddControl(new CGUIImage(0, 0, 0, 0, 1920, 1080, CTextureInfo()));
+
+  CGUIControlGroup *menu = new CGUIControlGroup(0, 0, 0, 0, 400, 1080);
+  for (int i = 0; i < MENU_ITEMS; i++)
+  {
+    menu->AddControl(new CGUIImage(0, 0, 0, i * 90.0f, 400, 90, CTextureInfo()));
+    menu->AddControl(new CGUIImage(0, 0, 20, i * 90.0f + 20, 50, 50, CTextureInfo()));
+  }
+  root->AddControl(menu);
+
+  const std::vector<CAnimation> focus = { CAnimation::CreateFader(100, 60, 0, 200, ANIM_TYPE_FOCUS),
+                                          CAnimation::CreateFader(60, 100, 0, 200, ANIM_TYPE_UNFOCUS) };
+  for (int row = 0; row < rows; row++)
+  {
+    CGUIControlGroup *widget = new CGUIControlGroup(0, 0, 420, row * 340.0f, 1500, 340);
+    for (int i = 0; i < WIDGET_ITEMS; i++)
+    {
+      CGUIControlGroup *poster = new CGUIControlGroup(0, 0, i * 250.0f, 0, 240, 340);
+      CGUIImage *art = new CGUIImage(0, 0, 0, 0, 240, 300, CTextureInfo());
+      art->SetAnimations(focus);
+      poster->AddControl(art);
+      poster->AddControl(new CGUIImage(0, 0, 180, 0, 60, 60, CTextureInfo()));
+      poster->AddControl(new CGUIImage(0, 0, 0, 300, 240, 40, CTextureInfo()));
+      widget->AddControl(poster);
+      posters.push_back(art);
+    }
+    root->AddControl(widget);
+  }
+  return root;
+}
+
+int CBenchScreens::GetHomeScreenControls(int rows)
+{
+  return 3 + 2 * MENU_ITEMS + rows * (1 + 4 * WIDGET_ITEMS);
+}
+
+CGUIWindow* CBenchScreens::LoadSkinWindow(int id, const std::string &file, std::vector<CGUIControl*> &views)
+{
+  if (!LoadBenchSkin())
+    return nullptr;
+
+  CBenchSkinWindow *window = new CBenchSkinWindow(id, file);
+  if (!window->Load(file))
+  {
+    CLog::Log(LOGERROR, "CBenchScreens: unable to load %s", file.c_str());
+    delete window;
+    return nullptr;
+  }
+  views = window->m_views;
+  return window;
+}
+
+void CBenchScreens::UnloadSkin()
+{
+  if (skinLoaded)
+  {
+    g_SkinInfo.reset();
+    skinLoaded = false;
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+class CGUIControl;
+class CGUIControlGroup;
+class CGUIWindow;
+
+/*!
+ * \brief Control trees shared by the GUI benchmarks
+ *
+ * The screens are built in code, as the benchmarks run without texture
+ * manager and by default without skin. Images keep their textures unloaded
+ * and labels have no font, so processing and the render traversal run as
+ * usual while nothing is drawn.
+ *
+ * Windows can also be loaded from the skin in KODI_BENCH_SKIN, see
+ * LoadSkinWindow().
+ */
+class CBenchScreens
+{
+public:
+  static const int MENU_ITEMS = 10;
+  static const int WIDGET_ITEMS = 12;
+
+  /*!
+   * \brief Build a tree shaped like a busy home screen
+   *
+   * A background, the main menu and \p rows rows of widgets, where each
+   * poster has artwork, an overlay and a focus animation.
+   * \param rows number of widget rows
+   * \param posters receives the artwork of every poster, row by row
+   * \return the root group, owned by the caller
+   */
+  static CGUIControlGroup* CreateHomeScreen(int rows, std::vector<CGUIControl*> &posters);
+
+  /*!
+   * \brief Number of controls in a home screen with \p rows widget rows
+   */
+  static int GetHomeScreenControls(int rows);
+
+  /*!
+   * \brief Load a window from the skin in KODI_BENCH_SKIN
+   *
+   * The skin is set up as far as loading its windows needs, with its
+   * resolutions and includes, and the controls are created by
+   * CGUIControlFactory like for any skinned window. Fonts, colors and
+   * textures aren't loaded.
+   * \param id the window id
+   * \param file the XML file of the window, e.g. MyVideoNav.xml
+   * \param views receives the containers listed in the <views> tag of the window
+   * \return the window, owned by the caller, or NULL if KODI_BENCH_SKIN isn't
+   *         set or the window couldn't be loaded
+   */
+  static CGUIWindow* LoadSkinWindow(int id, const std::string &file, std::vector<CGUIControl*> &views);
+
+  /*!
+   * \brief Drop the skin set up by LoadSkinWindow()
+   */
+  static void UnloadSkin();
+};
@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIListGroup.h"
+#include "guilib/GUIListItemLayout.h"
+#include "guilib/VisibleEffect.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// a layout with focus and unfocus animations, like a skin's focused layout
+class CTestLayout : public CGUIListItemLayout
+{
+public:
+  CTestLayout()
+  {
+    std::vector<CAnimation> animations;
+    animations.push_back(CAnimation::CreateFader(0, 100, 0, 200, ANIM_TYPE_FOCUS));
+    animations.push_back(CAnimation::CreateFader(100, 0, 0, 200, ANIM_TYPE_UNFOCUS));
+    m_group.SetAnimations(animations);
+    m_group.AddControl(new CGUIListGroup(0, 0, 0, 0, 100, 100));
+  }
+  CTestLayout(const CTestLayout &from) : CGUIListItemLayout(from) {}
+
+  CGUIListGroup &GetGroup() { return m_group; }
+};
+}
+
+TEST(TestGUIListItemLayoutPool, RoundTrip)
+{
+  CTestLayout source;
+  CGUIListItemLayoutPool pool;
+  pool.SetCapacity(2);
+
+  // nothing pooled yet, a copy of the source is made
+  CGUIListItemLayout *layout = pool.Get(source);
+  ASSERT_NE(nullptr, layout);
+  EXPECT_NE(&source, layout);
+  EXPECT_TRUE(layout->IsCopyOf(source));
+
+  pool.Recycle(layout, &source);
+  EXPECT_EQ(1U, pool.GetSize());
+
+  // and handed out again instead of another copy
+  EXPECT_EQ(layout, pool.Get(source));
+  EXPECT_EQ(0U, pool.GetSize());
+  delete layout;
+}
+
+TEST(TestGUIListItemLayoutPool, Foreign)
+{
+  CTestLayout source, other;
+  CGUIListItemLayoutPool pool;
+  pool.SetCapacity(2);
+
+  // layouts of another template, or without the container's current one, are deleted
+  EXPECT_FALSE(other.IsCopyOf(source));
+  pool.Recycle(new CTestLayout(other), &source);
+  EXPECT_EQ(0U, pool.GetSize());
+  pool.Recycle(new CTestLayout(source), nullptr);
+  EXPECT_EQ(0U, pool.GetSize());
+  pool.Recycle(nullptr, &source);
+  EXPECT_EQ(0U, pool.GetSize());
+}
+
+TEST(TestGUIListItemLayoutPool, LayoutSwitch)
+{
+  CTestLayout source, other;
+  CGUIListItemLayoutPool pool;
+  pool.SetCapacity(2);
+  pool.Recycle(new CTestLayout(source), &source);
+  pool.Recycle(new CTestLayout(source), &source);
+  EXPECT_EQ(2U, pool.GetSize());
+
+  // the container switched to another layout, the pooled ones are dropped
+  CGUIListItemLayout *layout = pool.Get(other);
+  EXPECT_TRUE(layout->IsCopyOf(other));
+  EXPECT_EQ(0U, pool.GetSize());
+  delete layout;
+}
+
+TEST(TestGUIListItemLayoutPool, Capacity)
+{
+  CTestLayout source;
+  CGUIListItemLayoutPool pool;
+  pool.SetCapacity(3);
+  for (int i = 0; i < 5; i++)
+    pool.Recycle(new CTestLayout(source), &source);
+  EXPECT_EQ(3U, pool.GetSize());
+
+  // a smaller page trims the pool
+  pool.SetCapacity(1);
+  EXPECT_EQ(1U, pool.GetSize());
+  pool.Recycle(new CTestLayout(source), &source);
+  EXPECT_EQ(1U, pool.GetSize());
+
+  // copies keep the capacity, not the layouts of the container they came from
+  CGUIListItemLayoutPool copy(pool);
+  EXPECT_EQ(0U, copy.GetSize());
+  copy.Recycle(new CTestLayout(source), &source);
+  EXPECT_EQ(1U, copy.GetSize());
+
+  pool.Clear();
+  EXPECT_EQ(0U, pool.GetSize());
+}
+
+TEST(TestGUIListItemLayoutPool, RecycleResetsState)
+{
+  CTestLayout source;
+  CTestLayout *layout = new CTestLayout(source);
+  layout->SetFocusedItem(1);
+  ASSERT_TRUE(layout->GetGroup().HasFocus());
+  ASSERT_TRUE(layout->IsAnimating(ANIM_TYPE_FOCUS));
+
+  CGUIListItemLayoutPool pool;
+  pool.SetCapacity(1);
+  pool.Recycle(layout, &source);
+
+  // the next item starts unfocused and without animations of the previous one
+  ASSERT_EQ(layout, pool.Get(source));
+  EXPECT_FALSE(layout->GetGroup().HasFocus());
+  EXPECT_FALSE(layout->IsAnimating(ANIM_TYPE_FOCUS));
+  EXPECT_FALSE(layout->IsAnimating(ANIM_TYPE_UNFOCUS));
+  delete layout;
+}
@@ -35,6 +35,7 @@
 #include "utils/FileOperationJob.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -126,6 +127,29 @@ static int SetVolume(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Start recording a performance trace.
+ *  \param params (ignored)
+ */
+static int StartTrace(const std::vector<std::string>& params)
+{
+  CPerformanceTrace::GetInstance().Clear();
+  CPerformanceTrace::GetInstance().Start();
+
+  return 0;
+}
+
+/*! \brief Stop recording and write the performance trace.
+ *  \param params The parameters.
+ *  \details params[0] = The file to write (optional).
+ */
+static int StopTrace(const std::vector<std::string>& params)
+{
+  CPerformanceTrace::GetInstance().Stop();
+  CPerformanceTrace::GetInstance().Dump(params.empty() ? "" : params[0]);
+
+  return 0;
+}
+
 /*! \brief Toggle debug info.
  *  \param params (ignored)
  */
@@ -200,6 +224,20 @@ static int WakeOnLAN(const std::vector<std::string>& params)
 ///     @param[in] showvolumebar         Add "showVolumeBar" to show volume bar (optional).
 ///   }
 ///   \table_row2_l{
+///     <b>`StartTrace`</b>
+///     ,
+///     Starts recording a performance trace of the player\, renderer\, audio
+///     engine\, GUI and job threads.
+///   }
+///   \table_row2_l{
+///     <b>`StopTrace([file])`</b>
+///     ,
+///     Stops recording and writes the trace in Chrome trace event format\, to
+///     be opened in chrome://tracing.
+///     @param[in] file                  File to write (optional).
+///             @note Defaults to special://temp/kodi-trace.json
+///   }
+///   \table_row2_l{
 ///     <b>`Skin.ToggleDebug`</b>
 ///     ,
 ///     Toggles skin debug info on/off
@@ -226,6 +264,8 @@ CBuiltins::CommandMap CApplicationBuiltins::GetOperations() const
            {"mute", {"Mute the player", 0, Mute}},
            {"notifyall", {"Notify all connected clients", 2, NotifyAll}},
            {"setvolume", {"Set the current volume", 1, SetVolume}},
+           {"starttrace", {"Start recording a performance trace", 0, StartTrace}},
+           {"stoptrace", {"Stop recording and write the performance trace", 0, StopTrace}},
            {"toggledebug", {"Enables/disables debug mode", 0, ToggleDebug}},
            {"toggledpms", {"Toggle DPMS mode manually", 0, ToggleDPMS}},
            {"wakeonlan", {"Sends the wake-up packet to the broadcast address for the specified MAC address", 1, WakeOnLAN}}
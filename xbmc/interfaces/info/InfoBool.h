@@ -27,6 +27,26 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of state an info bool can depend on
+
+ An info bool stays cached until one of its sources publishes a change,
+ see CGUIInfoManager::PublishChange().
+ */
+enum InfoDependency
+{
+  INFO_DEP_NONE     = 0,
+  INFO_DEP_PLAYER   = 0x01, ///< playback, volume and playlists
+  INFO_DEP_WINDOW   = 0x02, ///< window stack, focus and control state
+  INFO_DEP_LIBRARY  = 0x04, ///< library contents
+  INFO_DEP_TIME     = 0x08, ///< wall clock, published once a second
+  INFO_DEP_LISTITEM = 0x10, ///< the focused list item
+  INFO_DEP_SKIN     = 0x20, ///< skin settings
+  INFO_DEP_ALWAYS   = 0x80, ///< unknown sources, re-evaluated every frame
+  INFO_DEP_ALL      = 0xff
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -73,11 +93,17 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Get the state sources this info bool depends on
+   \return a combination of InfoDependency flags
+   */
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency flags of the sources that invalidate the value
 
 private:
   std::string  m_expression;   ///< original expression
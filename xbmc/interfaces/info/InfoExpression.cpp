@@ -19,6 +19,7 @@
  */
 
 #include "InfoExpression.h"
+#include <algorithm>
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
@@ -31,6 +32,7 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_dependencies = g_infoManager.GetBoolDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -39,28 +41,63 @@ void InfoSingle::Update(const CGUIListItem *item)
 }
 
 InfoExpression::InfoExpression(const std::string &expression, int context)
+: InfoExpression(expression, context, [context](const std::string &operand) { return g_infoManager.Register(operand, context); })
+{
+}
+
+InfoExpression::InfoExpression(const std::string &expression, int context, const OperandResolver &resolver)
 : InfoBool(expression, context)
 {
-  if (!Parse(expression))
+  // collected from the operands while parsing
+  m_dependencies = INFO_DEP_NONE;
+  if (!Parse(expression, resolver))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    m_program.clear();
+    m_leaves.clear();
+    m_leaves.push_back(resolver("false"));
+    m_program.push_back({ OP_LEAF, 0 });
+    m_dependencies = INFO_DEP_NONE;
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  const Instruction *program = m_program.data();
+  const unsigned int size = m_program.size();
+  bool value = false;
+  unsigned int pc = 0;
+  while (pc < size)
+  {
+    const Instruction &instruction = program[pc++];
+    switch (instruction.op)
+    {
+    case OP_LEAF:
+      value = m_leaves[instruction.arg]->Get(item);
+      break;
+    case OP_LEAF_NOT:
+      value = !m_leaves[instruction.arg]->Get(item);
+      break;
+    case OP_JUMP_IF_TRUE:
+      if (value)
+        pc = instruction.arg;
+      break;
+    case OP_JUMP_IF_FALSE:
+      if (!value)
+        pc = instruction.arg;
+      break;
+    }
+  }
+  m_value = value;
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes. The tree is then compiled into a
+ * flat program where every child of a group except the last is followed by a
+ * jump to the end of the group, taken when the child's value decides the
+ * group (true for OR groups, false for AND groups). The end effect is to
+ * minimise the number of leaf nodes that need to be evaluated in order to
+ * determine the value of the expression.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
@@ -69,54 +106,81 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * Within a group, leaves which are cached between frames are evaluated
+ * before leaves which are re-evaluated every frame, and those before nested
+ * groups.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
-{
-  return m_invert ^ m_info->Get(item);
-}
-
-InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
+InfoExpression::InfoSubexpressionPtr InfoExpression::MakeGroup(
     node_type_t type,
     const InfoSubexpressionPtr &left,
     const InfoSubexpressionPtr &right)
-    : m_type(type)
 {
-  AddChild(right);
-  AddChild(left);
+  InfoSubexpressionPtr group = std::make_shared<InfoSubexpression>();
+  group->type = type;
+  group->slot = 0;
+  group->invert = false;
+  group->children.push_back(left);
+  group->children.push_back(right);
+  return group;
 }
 
-void InfoExpression::InfoAssociativeGroup::AddChild(const InfoSubexpressionPtr &child)
+void InfoExpression::Compile(const InfoSubexpressionPtr &node)
 {
-  m_children.push_front(child); // largely undoes the effect of parsing right-associative
-}
+  if (node->type == NODE_LEAF)
+  {
+    m_program.push_back({ node->invert ? OP_LEAF_NOT : OP_LEAF, node->slot });
+    return;
+  }
 
-void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociativeGroup> other)
-{
-  m_children.splice(m_children.end(), other->m_children);
+  // list::sort is stable, so children of the same cost keep the order they were written in
+  auto cost = [this](const InfoSubexpressionPtr &child) {
+    if (child->type != NODE_LEAF)
+      return 2;
+    const InfoPtr &leaf = m_leaves[child->slot];
+    return (leaf->ListItemDependent() || (leaf->GetDependencies() & INFO_DEP_ALWAYS)) ? 1 : 0;
+  };
+  node->children.sort([&cost](const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right) {
+    return cost(left) < cost(right);
+  });
+
+  const opcode_t jump = node->type == NODE_AND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE;
+  std::vector<unsigned int> exits;
+  std::list<InfoSubexpressionPtr>::const_iterator it = node->children.begin();
+  while (true)
+  {
+    Compile(*it);
+    if (++it == node->children.end())
+      break;
+    exits.push_back(m_program.size());
+    m_program.push_back({ jump, 0 });
+  }
+  for (unsigned int exit : exits)
+    m_program[exit].arg = m_program.size();
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+void InfoExpression::ThreadJumps()
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
+  /* A jump landing on another jump doesn't change the accumulator, so it can
+   * go straight to the target of a jump on the same condition, or past a jump
+   * on the opposite condition. All jumps go forward, so this terminates.
    */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  for (Instruction &instruction : m_program)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    if (instruction.op != OP_JUMP_IF_TRUE && instruction.op != OP_JUMP_IF_FALSE)
+      continue;
+    while (instruction.arg < m_program.size())
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      const Instruction &target = m_program[instruction.arg];
+      if (target.op == instruction.op)
+        instruction.arg = target.arg;
+      else if (target.op == OP_JUMP_IF_TRUE || target.op == OP_JUMP_IF_FALSE)
+        instruction.arg++;
+      else
+        break;
     }
   }
-  return use_and ^ result;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -161,8 +225,8 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
     nodes.pop();
     InfoSubexpressionPtr left = nodes.top();
 
-    node_type_t right_type = right->Type();
-    node_type_t left_type = left->Type();
+    node_type_t right_type = right->type;
+    node_type_t left_type = left->type;
 
     // Combine associative operations into the same node where possible
     if (left_type == new_type && right_type == new_type)
@@ -172,7 +236,7 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
        *               /   \     /   \         leaf leaf leaf leaf
        *             leaf leaf leaf leaf
        */
-      std::static_pointer_cast<InfoAssociativeGroup>(left)->Merge(std::static_pointer_cast<InfoAssociativeGroup>(right));
+      left->children.splice(left->children.end(), right->children);
     else if (left_type == new_type)
       /* For example:        AND                    AND
        *                   /     \                /  |  \
@@ -180,7 +244,7 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
        *               /   \     /   \                  /   \
        *             leaf leaf leaf leaf              leaf leaf
        */
-      std::static_pointer_cast<InfoAssociativeGroup>(left)->AddChild(right);
+      left->children.push_back(right);
     else
     {
       nodes.pop();
@@ -192,7 +256,7 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
          *               /   \     /   \           /   \
          *             leaf leaf leaf leaf       leaf leaf
          */
-        std::static_pointer_cast<InfoAssociativeGroup>(right)->AddChild(left);
+        right->children.push_front(left);
         nodes.push(right);
       }
       else
@@ -202,12 +266,12 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
          *               /   \     /   \        as children
          *             leaf leaf leaf leaf
          */
-        nodes.push(std::make_shared<InfoAssociativeGroup>(new_type, left, right));
+        nodes.push(MakeGroup(new_type, left, right));
     }
   }
 }
 
-bool InfoExpression::Parse(const std::string &expression)
+bool InfoExpression::Parse(const std::string &expression, const OperandResolver &resolver)
 {
   const char *s = expression.c_str();
   std::string operand;
@@ -242,15 +306,8 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = g_infoManager.Register(operand, m_context);
-        if (!info)
-        {
-          CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
+        if (!AddLeaf(operand, invert, resolver, nodes))
           return false;
-        }
-        /* Propagate any listItem dependency from the operand to the expression */
-        m_listItemDependent |= info->ListItemDependent();
-        nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
       }
@@ -291,21 +348,36 @@ bool InfoExpression::Parse(const std::string &expression)
     CLog::Log(LOGERROR, "Missing operand");
     return false;
   }
-  if (!operand.empty())
-  {
-    InfoPtr info = g_infoManager.Register(operand, m_context);
-    if (!info)
-    {
-      CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
-      return false;
-    }
-    /* Propagate any listItem dependency from the operand to the expression */
-    m_listItemDependent |= info->ListItemDependent();
-    nodes.push(std::make_shared<InfoLeaf>(info, invert));
-  }
+  if (!operand.empty() && !AddLeaf(operand, invert, resolver, nodes))
+    return false;
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
+  ThreadJumps();
+  return true;
+}
+
+bool InfoExpression::AddLeaf(const std::string &operand, bool invert, const OperandResolver &resolver, std::stack<InfoSubexpressionPtr> &nodes)
+{
+  InfoPtr info = resolver(operand);
+  if (!info)
+  {
+    CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
+    return false;
+  }
+  /* Propagate any listItem dependency from the operand to the expression */
+  m_listItemDependent |= info->ListItemDependent();
+  m_dependencies |= info->GetDependencies();
+
+  /* Operands used more than once share a slot */
+  std::vector<InfoPtr>::const_iterator it = std::find(m_leaves.begin(), m_leaves.end(), info);
+  InfoSubexpressionPtr leaf = std::make_shared<InfoSubexpression>();
+  leaf->type = NODE_LEAF;
+  leaf->slot = it - m_leaves.begin();
+  leaf->invert = invert;
+  if (it == m_leaves.end())
+    m_leaves.push_back(info);
+  nodes.push(leaf);
   return true;
 }
@@ -20,9 +20,11 @@
 
 #pragma once
 
-#include <vector>
+#include <functional>
 #include <list>
+#include <memory>
 #include <stack>
+#include <vector>
 #include "InfoBool.h"
 
 class CGUIListItem;
@@ -43,14 +45,32 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+
+ The expression is compiled when it is constructed into a flat list of
+ instructions working on a single accumulator. Each distinct operand is
+ stored once in a leaf slot, and AND/OR groups end in conditional jumps past
+ the rest of the group, so evaluation neither recurses nor visits leaves
+ whose value can't change the result.
  */
 class InfoExpression : public InfoBool
 {
 public:
+  /*! \brief Resolves an operand of the expression to an info bool */
+  typedef std::function<InfoPtr(const std::string &operand)> OperandResolver;
+
   InfoExpression(const std::string &expression, int context);
+  /*! \brief Construct an expression resolving its operands with the given function
+   instead of registering them with the info manager, e.g. for tests and benchmarks
+   */
+  InfoExpression(const std::string &expression, int context, const OperandResolver &resolver);
   virtual ~InfoExpression() {};
 
   virtual void Update(const CGUIListItem *item);
+
+  /*! \brief Number of distinct operands of the expression */
+  size_t GetLeafCount() const { return m_leaves.size(); }
+  /*! \brief Number of instructions the expression compiled to */
+  size_t GetProgramSize() const { return m_program.size(); }
 private:
   typedef enum
   {
@@ -69,47 +89,41 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
-  class InfoSubexpression
+  // A node in the expression tree, which only exists while parsing
+  struct InfoSubexpression
   {
-  public:
-    virtual ~InfoSubexpression(void) {}; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
-    virtual node_type_t Type() const=0;
+    node_type_t type;
+    unsigned int slot;  // NODE_LEAF: index into m_leaves
+    bool invert;        // NODE_LEAF: negate the value of the leaf
+    std::list<std::shared_ptr<InfoSubexpression>> children; // NODE_AND and NODE_OR
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
 
-  // A leaf node in the expression tree
-  class InfoLeaf : public InfoSubexpression
+  typedef enum
   {
-  public:
-    InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    virtual bool Evaluate(const CGUIListItem *item);
-    virtual node_type_t Type() const { return NODE_LEAF; };
-  private:
-    InfoPtr m_info;
-    bool m_invert;
-  };
+    OP_LEAF,          // accumulator = value of leaf slot arg
+    OP_LEAF_NOT,      // accumulator = !value of leaf slot arg
+    OP_JUMP_IF_TRUE,  // continue at instruction arg if the accumulator is true
+    OP_JUMP_IF_FALSE, // continue at instruction arg if the accumulator is false
+  } opcode_t;
 
-  // A branch node in the expression tree
-  class InfoAssociativeGroup : public InfoSubexpression
+  struct Instruction
   {
-  public:
-    InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
-    void AddChild(const InfoSubexpressionPtr &child);
-    void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    virtual bool Evaluate(const CGUIListItem *item);
-    virtual node_type_t Type() const { return m_type; };
-  private:
-    node_type_t m_type;
-    std::list<InfoSubexpressionPtr> m_children;
+    opcode_t op;
+    unsigned int arg;
   };
 
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
-  bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  static InfoSubexpressionPtr MakeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
+  bool Parse(const std::string &expression, const OperandResolver &resolver);
+  bool AddLeaf(const std::string &operand, bool invert, const OperandResolver &resolver, std::stack<InfoSubexpressionPtr> &nodes);
+  void Compile(const InfoSubexpressionPtr &node);
+  void ThreadJumps();
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_leaves;
 };
 
 };
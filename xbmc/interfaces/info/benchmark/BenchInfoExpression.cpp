@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/info/InfoExpression.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+using namespace INFO;
+
+namespace
+{
+// Stands in for the conditions of the info manager, which needs running
+// services to evaluate. The value and the cache behaviour of each operand are
+// derived from its name, so runs are reproducible.
+class CBenchInfoBool : public InfoBool
+{
+public:
+  explicit CBenchInfoBool(const std::string &condition)
+    : InfoBool(condition, 0)
+  {
+    const size_t hash = std::hash<std::string>()(condition);
+    m_state = (hash & 1) != 0;
+    m_dependencies = (hash & 2) ? INFO_DEP_ALWAYS : INFO_DEP_WINDOW;
+  }
+
+  virtual void Update(const CGUIListItem *item) override { m_value = m_state; }
+
+private:
+  bool m_state;
+};
+
+struct SkinConditions
+{
+  std::map<std::string, InfoPtr> operands;
+  std::vector<InfoPtr> conditions;
+};
+
+void CollectConditions(const TiXmlElement *element, std::vector<std::string> &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const std::string tag = element->ValueStr();
+    if ((tag == "visible" || tag == "enable" || tag == "selected" || tag == "usealttexture") &&
+        element->FirstChild())
+      conditions.push_back(element->FirstChild()->ValueStr());
+    if (element->Attribute("condition"))
+      conditions.push_back(element->Attribute("condition"));
+    CollectConditions(element->FirstChildElement(), conditions);
+  }
+}
+
+// Loads Includes.xml of the skin and the files it includes, inlines $EXP[]
+// references and compiles every distinct condition, like the skin's windows
+// would register them.
+bool LoadSkinConditions(SkinConditions &skin)
+{
+  const char *env = getenv("KODI_BENCH_SKIN");
+  const std::string path = std::string(env ? env : "addons/skin.estuary") + "/xml/";
+
+  std::vector<std::string> files = { "Includes.xml" };
+  std::map<std::string, std::string> expressions;
+  std::vector<std::string> conditions;
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(path + files[i]))
+      return false;
+    const TiXmlElement *root = doc.RootElement();
+    for (const TiXmlElement *node = root->FirstChildElement("include"); node; node = node->NextSiblingElement("include"))
+    {
+      if (node->Attribute("file"))
+        files.push_back(node->Attribute("file"));
+    }
+    for (const TiXmlElement *node = root->FirstChildElement("expression"); node; node = node->NextSiblingElement("expression"))
+    {
+      if (node->Attribute("name") && node->FirstChild())
+        expressions[node->Attribute("name")] = node->FirstChild()->ValueStr();
+    }
+    CollectConditions(root->FirstChildElement(), conditions);
+  }
+
+  auto resolver = [&skin](std::string operand) {
+    StringUtils::Trim(operand);
+    InfoPtr &info = skin.operands[operand];
+    if (!info)
+      info = std::make_shared<CBenchInfoBool>(operand);
+    return info;
+  };
+
+  std::map<std::string, InfoPtr> registered;
+  for (std::string condition : conditions)
+  {
+    size_t pos;
+    while ((pos = condition.find("$EXP[")) != std::string::npos)
+    {
+      const size_t end = condition.find(']', pos);
+      if (end == std::string::npos)
+        break;
+      const std::string name = condition.substr(pos + 5, end - pos - 5);
+      condition.replace(pos, end - pos + 1, "[" + expressions[name] + "]");
+    }
+    InfoPtr &info = registered[condition];
+    if (!info)
+    {
+      info = std::make_shared<InfoExpression>(condition, 0, resolver);
+      skin.conditions.push_back(info);
+    }
+  }
+  return !skin.conditions.empty();
+}
+}
+
+// Compiles the conditions of the default skin's includes
+static void BM_InfoExpression_Compile(benchmark::State& state)
+{
+  int64_t conditions = 0;
+  for (auto _ : state)
+  {
+    SkinConditions skin;
+    if (!LoadSkinConditions(skin))
+    {
+      state.SkipWithError("can't load the skin's includes, set KODI_BENCH_SKIN");
+      return;
+    }
+    conditions += skin.conditions.size();
+  }
+  state.SetItemsProcessed(conditions);
+}
+BENCHMARK(BM_InfoExpression_Compile)->Unit(benchmark::kMillisecond);
+
+// Evaluates every condition of the default skin's includes once per
+// iteration, with the operands cached (0) or all of them dirty (1) like the
+// first frame after a change
+static void BM_InfoExpression_Evaluate(benchmark::State& state)
+{
+  SkinConditions skin;
+  if (!LoadSkinConditions(skin))
+  {
+    state.SkipWithError("can't load the skin's includes, set KODI_BENCH_SKIN");
+    return;
+  }
+
+  for (auto _ : state)
+  {
+    if (state.range(0))
+    {
+      for (auto &operand : skin.operands)
+        operand.second->SetDirty();
+    }
+    for (auto &condition : skin.conditions)
+    {
+      condition->SetDirty();
+      benchmark::DoNotOptimize(condition->Get());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * skin.conditions.size());
+  state.counters["conditions"] = skin.conditions.size();
+  state.counters["operands"] = skin.operands.size();
+}
+BENCHMARK(BM_InfoExpression_Evaluate)->Arg(0)->Arg(1);
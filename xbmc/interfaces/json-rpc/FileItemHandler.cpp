@@ -23,6 +23,7 @@
 
 #include "FileItemHandler.h"
 #include "AudioLibrary.h"
+#include "ResponseStream.h"
 #include "VideoLibrary.h"
 #include "FileOperations.h"
 #include "utils/SortUtils.h"
@@ -250,6 +251,88 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
   delete thumbLoader;
 }
 
+void CFileItemHandler::StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+{
+  // everything the generator needs has to outlive the method call
+  struct StreamState
+  {
+    bool hasID = false;
+    std::string ID;
+    std::string resultname;
+    CFileItemList items;
+    CVariant parameterObject;
+    std::set<std::string> fields;
+    int next = 0;
+    int end = 0;
+    std::unique_ptr<CThumbLoader> thumbLoader;
+  };
+
+  std::shared_ptr<StreamState> state(new StreamState);
+  int start, end;
+  HandleLimits(parameterObject, result, size, start, end);
+
+  if (sortLimit)
+    Sort(items, parameterObject);
+  else
+  {
+    start = 0;
+    end = items.Size();
+  }
+
+  if (end - start <= 0)
+    return;
+
+  state->hasID = ID != NULL;
+  if (ID != NULL)
+    state->ID = ID;
+  state->resultname = resultname;
+  state->parameterObject = parameterObject;
+  state->next = start;
+  state->end = end;
+  if (parameterObject.isMember("properties") && parameterObject["properties"].isArray())
+  {
+    for (CVariant::const_iterator_array field = parameterObject["properties"].begin_array(); field != parameterObject["properties"].end_array(); field++)
+      state->fields.insert(field->asString());
+  }
+
+  auto generator = [state, allowFile](CVariant &element)
+  {
+    if (state->next >= state->end)
+    {
+      state->items.Clear();
+      state->thumbLoader.reset();
+      return false;
+    }
+
+    CFileItemPtr item = state->items.Get(state->next++);
+    if (!state->thumbLoader)
+    {
+      if (item->HasVideoInfoTag())
+        state->thumbLoader.reset(new CVideoThumbLoader());
+      else if (item->HasMusicInfoTag())
+        state->thumbLoader.reset(new CMusicThumbLoader());
+
+      if (state->thumbLoader)
+        state->thumbLoader->OnLoaderStart();
+    }
+
+    CVariant holder;
+    HandleFileItem(state->hasID ? state->ID.c_str() : NULL, allowFile, state->resultname.c_str(), item, state->parameterObject, state->fields, holder, false, state->thumbLoader.get());
+    element = std::move(holder[state->resultname]);
+    return true;
+  };
+
+  // the caller's list is gone by the time the response is sent
+  state->items.Assign(items);
+
+  if (!CResponseStream::DeferArray(result, resultname, generator))
+  {
+    CVariant element;
+    while (generator(element))
+      result[resultname].append(std::move(element));
+  }
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
   std::set<std::string> fields;
@@ -379,9 +462,9 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].append(std::move(object));
     else
-      result[resultname] = object;
+      result[resultname] = std::move(object);
   }
 }
 
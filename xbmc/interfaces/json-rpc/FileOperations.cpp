@@ -23,6 +23,7 @@
 #include "AudioLibrary.h"
 #include "MediaSource.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
@@ -162,7 +163,7 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
       param["properties"].append("file");
     param["properties"].append("filetype");
 
-    HandleFileItemList("id", true, "files", filteredFiles, param, result);
+    StreamFileItemList("id", true, "files", filteredFiles, param, result, filteredFiles.Size());
 
     return OK;
   }
@@ -259,6 +260,18 @@ JSONRPC_STATUS CFileOperations::SetFileDetails(const std::string &method, ITrans
   return ACK;
 }
 
+JSONRPC_STATUS CFileOperations::GetDirectoryCacheStats(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  SDirectoryCacheStats stats = g_directoryCache.GetStats();
+  result["hits"] = stats.hits;
+  result["misses"] = stats.misses;
+  result["evictions"] = stats.evictions;
+  result["directories"] = stats.directories;
+  result["memoryused"] = stats.memoryUsed;
+  result["memorylimit"] = stats.memoryLimit;
+  return OK;
+}
+
 JSONRPC_STATUS CFileOperations::PrepareDownload(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   std::string protocol;
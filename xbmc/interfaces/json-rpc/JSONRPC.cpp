@@ -234,7 +234,16 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CResponseStream stream(g_advancedSettings.m_jsonOutputCompact);
+  if (!MethodCall(inputString, transport, client, stream))
+    return "";
+
+  return stream.ReadAll();
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CResponseStream &stream)
+{
+  CVariant inputroot;
   bool hasResponse = false;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
@@ -247,45 +256,44 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       if (inputroot.size() <= 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
+        CVariant response;
+        BuildResponse(inputroot, InvalidRequest, CVariant(), response);
+        stream.AddResponse(std::move(response));
         hasResponse = true;
       }
       else
       {
+        stream.SetBatch(true);
         for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
         {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
+          if (HandleMethodCall(*itr, transport, client, stream))
             hasResponse = true;
-          }
         }
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+      hasResponse = HandleMethodCall(inputroot, transport, client, stream);
   }
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
+    CVariant response;
+    BuildResponse(inputroot, ParseError, CVariant(), response);
+    stream.AddResponse(std::move(response));
     hasResponse = true;
   }
 
-  std::string str;
-  if (hasResponse)
-    CJSONVariantWriter::Write(outputroot, str, g_advancedSettings.m_jsonOutputCompact);
-
-  return str;
+  return hasResponse;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, ITransportLayer *transport, IClient *client, CResponseStream &stream)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
   bool isNotification = false;
 
+  stream.BeginCall(result);
+
   if (IsProperJSONRPC(request))
   {
     isNotification = !request.isMember("id");
@@ -310,7 +318,9 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  CVariant response;
+  BuildResponse(request, errorCode, std::move(result), response);
+  stream.EndCall(std::move(response), !isNotification);
 
   return !isNotification;
 }
@@ -320,7 +330,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -328,7 +338,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -26,6 +26,7 @@
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "ResponseStream.h"
 
 class CVariant;
 
@@ -64,6 +65,19 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param stream Stream the JSON-RPC response is read from
+     \return True if there is a response to be sent back to the client
+
+     Like MethodCall() above but the response isn't serialised up front,
+     long lists in results are only produced while reading from the stream.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CResponseStream &stream);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -74,10 +88,10 @@ namespace JSONRPC
   
   private:
     static void setup();
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, ITransportLayer *transport, IClient *client, CResponseStream &stream);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -0,0 +1,250 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ResponseStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace JSONRPC;
+
+thread_local CResponseStream::Call *CResponseStream::m_activeCall = nullptr;
+
+CResponseStream::CResponseStream(bool compact)
+  : m_writer(compact)
+{ }
+
+CResponseStream::~CResponseStream()
+{
+  if (m_currentCall && m_activeCall == m_currentCall.get())
+    m_activeCall = m_previousCall;
+}
+
+bool CResponseStream::DeferArray(CVariant &result, const std::string &key, const ElementGenerator &generator)
+{
+  Call *call = m_activeCall;
+  if (call == nullptr || call->result != &result || result.isMember(key))
+    return false;
+
+  for (const auto& deferred : call->deferred)
+  {
+    if (deferred.key == key)
+      return false;
+  }
+
+  DeferredArray deferred;
+  deferred.key = key;
+  deferred.generator = generator;
+  call->deferred.push_back(std::move(deferred));
+  return true;
+}
+
+void CResponseStream::BeginCall(const CVariant &result)
+{
+  m_currentCall.reset(new Call);
+  m_currentCall->result = &result;
+
+  m_previousCall = m_activeCall;
+  m_activeCall = m_currentCall.get();
+}
+
+void CResponseStream::EndCall(CVariant &&response, bool keep)
+{
+  m_activeCall = m_previousCall;
+  m_previousCall = nullptr;
+
+  std::unique_ptr<Call> call(std::move(m_currentCall));
+  if (!call || !keep)
+    return;
+
+  call->result = nullptr;
+  call->response = std::move(response);
+  // errors and acknowledgements don't carry the result of the method
+  if (!call->response.isMember("result") || !call->response["result"].isObject())
+    call->deferred.clear();
+
+  m_calls.push_back(std::move(call));
+}
+
+void CResponseStream::AddResponse(CVariant &&response)
+{
+  std::unique_ptr<Call> call(new Call);
+  call->response = std::move(response);
+  m_calls.push_back(std::move(call));
+}
+
+void CResponseStream::SetWrapper(const std::string &prefix, const std::string &suffix)
+{
+  m_prefix = prefix;
+  m_suffix = suffix;
+}
+
+size_t CResponseStream::Read(char *buffer, size_t size)
+{
+  if (!m_queued)
+    QueueSteps();
+
+  std::string &output = m_writer.GetOutput();
+  while (output.size() - m_readPosition < size && !m_steps.empty())
+  {
+    if (m_steps.front()())
+      m_steps.pop_front();
+  }
+
+  size_t length = std::min(size, output.size() - m_readPosition);
+  if (length > 0)
+    memcpy(buffer, output.data() + m_readPosition, length);
+  m_readPosition += length;
+
+  // drop what has been read once there's nothing left to return
+  if (m_readPosition == output.size())
+  {
+    output.clear();
+    m_readPosition = 0;
+  }
+
+  return length;
+}
+
+std::string CResponseStream::ReadAll()
+{
+  if (!m_queued)
+    QueueSteps();
+
+  while (!m_steps.empty())
+  {
+    if (m_steps.front()())
+      m_steps.pop_front();
+  }
+
+  std::string output;
+  output.swap(m_writer.GetOutput());
+  output.erase(0, m_readPosition);
+  m_readPosition = 0;
+  return output;
+}
+
+void CResponseStream::QueueSteps()
+{
+  m_queued = true;
+
+  if (!m_prefix.empty())
+    m_steps.push_back([this]() { m_writer.WriteRaw(m_prefix); return true; });
+
+  if (!m_calls.empty())
+  {
+    if (m_batch)
+      m_steps.push_back([this]() { m_writer.StartArray(); return true; });
+
+    for (auto& call : m_calls)
+      QueueCall(*call);
+
+    if (m_batch)
+      m_steps.push_back([this]() { m_writer.EndArray(); return true; });
+  }
+
+  if (!m_suffix.empty())
+    m_steps.push_back([this]() { m_writer.WriteRaw(m_suffix); return true; });
+}
+
+void CResponseStream::QueueCall(Call &call)
+{
+  if (call.deferred.empty())
+  {
+    m_steps.push_back([this, &call]()
+    {
+      m_writer.Write(call.response);
+      call.response.clear();
+      return true;
+    });
+    return;
+  }
+
+  // write the members in the same order as CVariant would
+  m_steps.push_back([this]() { m_writer.StartObject(); return true; });
+  for (CVariant::const_iterator_map member = call.response.begin_map(); member != call.response.end_map(); ++member)
+  {
+    const std::string &key = member->first;
+    if (key == "result")
+    {
+      m_steps.push_back([this]() { m_writer.Key("result"); return true; });
+      QueueResult(call);
+    }
+    else
+    {
+      const CVariant &value = member->second;
+      m_steps.push_back([this, &key, &value]() { m_writer.Key(key); m_writer.Write(value); return true; });
+    }
+  }
+  m_steps.push_back([this]() { m_writer.EndObject(); return true; });
+}
+
+void CResponseStream::QueueResult(Call &call)
+{
+  const CVariant &result = call.response["result"];
+
+  std::sort(call.deferred.begin(), call.deferred.end(),
+            [](const DeferredArray &left, const DeferredArray &right) { return left.key < right.key; });
+
+  m_steps.push_back([this]() { m_writer.StartObject(); return true; });
+
+  std::vector<DeferredArray>::iterator deferred = call.deferred.begin();
+  for (CVariant::const_iterator_map member = result.begin_map(); member != result.end_map(); ++member)
+  {
+    for (; deferred != call.deferred.end() && deferred->key < member->first; ++deferred)
+    {
+      DeferredArray &array = *deferred;
+      m_steps.push_back([this, &array]() { return WriteNextElement(array); });
+    }
+
+    const std::string &key = member->first;
+    const CVariant &value = member->second;
+    m_steps.push_back([this, &key, &value]() { m_writer.Key(key); m_writer.Write(value); return true; });
+  }
+  for (; deferred != call.deferred.end(); ++deferred)
+  {
+    DeferredArray &array = *deferred;
+    m_steps.push_back([this, &array]() { return WriteNextElement(array); });
+  }
+
+  m_steps.push_back([this]() { m_writer.EndObject(); return true; });
+}
+
+bool CResponseStream::WriteNextElement(DeferredArray &deferred)
+{
+  CVariant element;
+  if (!deferred.generator || !deferred.generator(element))
+  {
+    if (deferred.started)
+      m_writer.EndArray();
+    // release whatever the generator holds on to right away
+    deferred.generator = nullptr;
+    return true;
+  }
+
+  if (!deferred.started)
+  {
+    m_writer.Key(deferred.key);
+    m_writer.StartArray();
+    deferred.started = true;
+  }
+  m_writer.Write(element);
+  return false;
+}
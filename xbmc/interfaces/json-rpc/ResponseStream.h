@@ -0,0 +1,151 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+namespace JSONRPC
+{
+  /*!
+   \ingroup jsonrpc
+   \brief Serialises JSON-RPC responses while they are being sent
+
+   A method returning a long list can defer an array member of its result
+   with DeferArray(). The elements of that array are only produced one by
+   one while the response is read, so neither a CVariant holding all of them
+   nor the complete response string has to exist at any time.
+   */
+  class CResponseStream
+  {
+  public:
+    /*!
+     \brief Produces the next element of a deferred array
+     \param element CVariant to fill with the element
+     \return False if there are no more elements
+     */
+    typedef std::function<bool(CVariant &element)> ElementGenerator;
+
+    explicit CResponseStream(bool compact);
+    ~CResponseStream();
+
+    /*!
+     \brief Defers the array member key of the result of the method being called
+     \param result Result object the method was called with
+     \param key Name of the array member
+     \param generator Produces the elements of the array
+     \return False if the array can't be deferred, the caller has to fill
+     result[key] itself in that case
+
+     Deferring is only possible for the top-level result of a call handled
+     through a response stream, and only if the method doesn't look at
+     result[key] afterwards. Like an array that never had an element
+     appended, the member is left out if the generator doesn't produce any.
+     */
+    static bool DeferArray(CVariant &result, const std::string &key, const ElementGenerator &generator);
+
+    /*!
+     \brief Marks the start of a method call whose result will be passed to EndCall()
+     */
+    void BeginCall(const CVariant &result);
+
+    /*!
+     \brief Adds the response of the call started with BeginCall()
+     \param response Complete JSON-RPC response object
+     \param keep False if the call doesn't have a response, e.g. for notifications
+     */
+    void EndCall(CVariant &&response, bool keep);
+
+    /*!
+     \brief Adds a response that wasn't produced by a method call, e.g. an error
+     */
+    void AddResponse(CVariant &&response);
+
+    /*!
+     \brief Writes all responses as an array like for a batch request
+     */
+    void SetBatch(bool batch) { m_batch = batch; }
+
+    /*!
+     \brief Text written verbatim before and after the response, e.g. for JSONP
+     */
+    void SetWrapper(const std::string &prefix, const std::string &suffix);
+
+    /*!
+     \brief Copies the next part of the response into buffer
+     \return Number of bytes copied, 0 once the response is complete
+     */
+    size_t Read(char *buffer, size_t size);
+
+    /*!
+     \brief Returns the complete (remaining) response
+     */
+    std::string ReadAll();
+
+  private:
+    CResponseStream(const CResponseStream&) = delete;
+    CResponseStream& operator=(const CResponseStream&) = delete;
+
+    struct DeferredArray
+    {
+      std::string key;
+      ElementGenerator generator;
+      bool started = false;
+    };
+
+    struct Call
+    {
+      const CVariant *result = nullptr;
+      CVariant response;
+      std::vector<DeferredArray> deferred;
+    };
+
+    // a step writes the next part of the response and returns true once it
+    // is done, steps of deferred arrays write one element per call
+    typedef std::function<bool()> Step;
+
+    void QueueSteps();
+    void QueueCall(Call &call);
+    void QueueResult(Call &call);
+    bool WriteNextElement(DeferredArray &deferred);
+
+    CJSONStreamWriter m_writer;
+    size_t m_readPosition = 0;
+    bool m_batch = false;
+    std::string m_prefix;
+    std::string m_suffix;
+
+    std::unique_ptr<Call> m_currentCall;
+    Call *m_previousCall = nullptr;
+    // the call DeferArray() adds to, per thread as methods run on the
+    // thread of the transport they were called from
+    static thread_local Call *m_activeCall;
+    std::vector<std::unique_ptr<Call>> m_calls;
+
+    bool m_queued = false;
+    std::deque<Step> m_steps;
+  };
+}
@@ -601,7 +601,9 @@ bool CSettingsOperations::SerializeSettingList(const CSettingList* setting, CVar
   SerializeSettingListValues(CSettingUtils::GetList(setting), obj["value"]);
   SerializeSettingListValues(CSettingUtils::ListToValues(setting, setting->GetDefault()), obj["default"]);
 
-  obj["elementtype"] = obj["definition"]["type"];
+  // copy first, adding "elementtype" may move the other members of obj
+  const CVariant elementType = obj["definition"]["type"];
+  obj["elementtype"] = elementType;
   obj["delimiter"] = setting->GetDelimiter();
   obj["minimumItems"] = setting->GetMinimumItems();
   obj["maximumItems"] = setting->GetMaximumItems();
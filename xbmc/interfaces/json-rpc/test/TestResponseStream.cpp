@@ -0,0 +1,208 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/ResponseStream.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace JSONRPC;
+
+namespace
+{
+// What a method with a long list does: defer the array if it can, fill the
+// result itself otherwise
+bool AddItems(CVariant &result, const std::string &key, int count)
+{
+  int next = 0;
+  CResponseStream::ElementGenerator generator = [next, count](CVariant &element) mutable
+  {
+    if (next >= count)
+      return false;
+    element["itemid"] = next;
+    element["label"] = "item " + std::to_string(next);
+    next++;
+    return true;
+  };
+
+  if (CResponseStream::DeferArray(result, key, generator))
+    return true;
+
+  CVariant element;
+  while (generator(element))
+  {
+    result[key].push_back(element);
+    element = CVariant();
+  }
+  return false;
+}
+
+CVariant MakeResponse(const CVariant &result, int id)
+{
+  CVariant response;
+  response["jsonrpc"] = "2.0";
+  response["id"] = id;
+  response["result"] = result;
+  return response;
+}
+
+// the whole result as a method without streaming would have produced it
+CVariant MakeExpected(int id, int items)
+{
+  CVariant result;
+  result["limits"]["start"] = 0;
+  result["limits"]["total"] = items;
+  AddItems(result, "aaa", items);
+  AddItems(result, "movies", items);
+  AddItems(result, "zzz", items);
+  return MakeResponse(result, id);
+}
+
+// runs a call through the stream, deferring all three arrays
+void StreamCall(CResponseStream &stream, int id, int items)
+{
+  CVariant result;
+  stream.BeginCall(result);
+  result["limits"]["start"] = 0;
+  result["limits"]["total"] = items;
+  EXPECT_TRUE(AddItems(result, "aaa", items));
+  EXPECT_TRUE(AddItems(result, "movies", items));
+  EXPECT_TRUE(AddItems(result, "zzz", items));
+  stream.EndCall(MakeResponse(result, id), true);
+}
+
+std::string Write(const CVariant &value, bool compact)
+{
+  std::string output;
+  EXPECT_TRUE(CJSONVariantWriter::Write(value, output, compact));
+  return output;
+}
+}
+
+class TestResponseStream : public testing::TestWithParam<bool>
+{
+};
+
+TEST_P(TestResponseStream, DeferredKeysAreSorted)
+{
+  CResponseStream stream(GetParam());
+  StreamCall(stream, 1, 3);
+  EXPECT_EQ(Write(MakeExpected(1, 3), GetParam()), stream.ReadAll());
+}
+
+TEST_P(TestResponseStream, EmptyGeneratorDropsMember)
+{
+  CResponseStream stream(GetParam());
+  StreamCall(stream, 1, 0);
+
+  const CVariant expected = MakeExpected(1, 0);
+  EXPECT_FALSE(expected["result"].isMember("movies"));
+  EXPECT_EQ(Write(expected, GetParam()), stream.ReadAll());
+}
+
+TEST_P(TestResponseStream, RefusedDeferFillsResult)
+{
+  CResponseStream stream(GetParam());
+
+  // not called through the stream
+  CVariant result;
+  EXPECT_FALSE(AddItems(result, "movies", 3));
+  stream.AddResponse(MakeResponse(result, 1));
+
+  // already filled by the method
+  CVariant other;
+  stream.BeginCall(other);
+  EXPECT_TRUE(AddItems(other, "movies", 2));
+  other["songs"].push_back(CVariant("song"));
+  EXPECT_FALSE(AddItems(other, "songs", 2));
+  stream.EndCall(MakeResponse(other, 2), true);
+
+  CVariant expectedOther;
+  AddItems(expectedOther, "movies", 2);
+  expectedOther["songs"].push_back(CVariant("song"));
+  AddItems(expectedOther, "songs", 2);
+
+  // not the result of the call
+  CVariant nested;
+  stream.BeginCall(nested);
+  EXPECT_FALSE(AddItems(nested["details"], "movies", 1));
+  stream.EndCall(MakeResponse(nested, 3), true);
+
+  CVariant expected(CVariant::VariantTypeArray);
+  expected.push_back(MakeResponse(result, 1));
+  expected.push_back(MakeResponse(expectedOther, 2));
+  expected.push_back(MakeResponse(nested, 3));
+  stream.SetBatch(true);
+  EXPECT_EQ(Write(expected, GetParam()), stream.ReadAll());
+}
+
+TEST_P(TestResponseStream, Batch)
+{
+  CResponseStream stream(GetParam());
+  stream.SetBatch(true);
+  StreamCall(stream, 1, 2);
+
+  // a notification doesn't get a response
+  CVariant notification;
+  stream.BeginCall(notification);
+  EXPECT_TRUE(AddItems(notification, "movies", 2));
+  stream.EndCall(MakeResponse(notification, 0), false);
+
+  StreamCall(stream, 3, 4);
+
+  CVariant error;
+  error["jsonrpc"] = "2.0";
+  error["id"] = 4;
+  error["error"]["code"] = -32601;
+  error["error"]["message"] = "Method not found.";
+  stream.AddResponse(CVariant(error));
+
+  CVariant expected(CVariant::VariantTypeArray);
+  expected.push_back(MakeExpected(1, 2));
+  expected.push_back(MakeExpected(3, 4));
+  expected.push_back(error);
+  EXPECT_EQ(Write(expected, GetParam()), stream.ReadAll());
+}
+
+TEST_P(TestResponseStream, Wrapper)
+{
+  CResponseStream stream(GetParam());
+  stream.SetWrapper("callback(", ")");
+  StreamCall(stream, 1, 3);
+  EXPECT_EQ("callback(" + Write(MakeExpected(1, 3), GetParam()) + ")", stream.ReadAll());
+}
+
+TEST_P(TestResponseStream, ReadInPieces)
+{
+  CResponseStream stream(GetParam());
+  StreamCall(stream, 1, 100);
+
+  std::string output;
+  char buffer[7];
+  size_t read;
+  while ((read = stream.Read(buffer, sizeof(buffer))) > 0)
+    output.append(buffer, read);
+  EXPECT_EQ(Write(MakeExpected(1, 100), GetParam()), output);
+}
+
+INSTANTIATE_TEST_CASE_P(CompactAndPretty, TestResponseStream, testing::Bool());
@@ -0,0 +1,514 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#ifdef HAVE_INOTIFY
+
+#include "LibraryWatcher.h"
+#include "Application.h"
+#include "GUIInfoManager.h"
+#include "MediaSource.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "addons/Scraper.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicDatabase.h"
+#include "music/infoscanner/MusicInfoScanner.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/MediaSourceSettings.h"
+#include "settings/Settings.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoScanner.h"
+#include "video/VideoLibraryQueue.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// files are picked up once they are complete, folders as soon as they exist,
+// see IsFileChange()
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+CLibraryWatcher& CLibraryWatcher::GetInstance()
+{
+  static CLibraryWatcher instance;
+  return instance;
+}
+
+CLibraryWatcher::CLibraryWatcher()
+  : CThread("LibraryWatcher")
+  , m_fd(-1)
+  , m_lastRefresh(0)
+  , m_updateRoots(false)
+{
+}
+
+CLibraryWatcher::~CLibraryWatcher()
+{
+  Stop();
+}
+
+void CLibraryWatcher::Start()
+{
+  m_updateRoots = true;
+  if (!IsRunning())
+    Create();
+}
+
+void CLibraryWatcher::Stop()
+{
+  StopThread(true);
+}
+
+void CLibraryWatcher::Process()
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CLibraryWatcher: unable to initialize inotify: %s", strerror(errno));
+    return;
+  }
+  m_lastRefresh = XbmcThreads::SystemClockMillis();
+
+  while (!m_bStop)
+  {
+    // sources are looked up again now and then to pick up new ones
+    if (XbmcThreads::SystemClockMillis() - m_lastRefresh >= g_advancedSettings.m_libraryWatcherFallbackInterval * 60 * 1000)
+    {
+      m_lastRefresh = XbmcThreads::SystemClockMillis();
+      m_updateRoots = true;
+      ScanUnwatchedRoots();
+    }
+    if (m_updateRoots.exchange(false))
+      UpdateRoots();
+
+    // wait for events until the next change is due, waking up regularly to check m_bStop
+    const unsigned int now = XbmcThreads::SystemClockMillis();
+    int timeout = 1000;
+    for (const auto& change : m_changes)
+      timeout = std::min(timeout, std::max(0, static_cast<int>(change.second.due - now)));
+
+    struct pollfd pfd = { m_fd, POLLIN, 0 };
+    if (poll(&pfd, 1, timeout) > 0 && (pfd.revents & POLLIN))
+      ReadEvents();
+
+    DispatchChanges();
+  }
+
+  // closing the descriptor drops all watches
+  close(m_fd);
+  m_fd = -1;
+  m_watches.clear();
+  m_watchedPaths.clear();
+  m_roots.clear();
+  m_unwatchedRoots.clear();
+  m_changes.clear();
+}
+
+void CLibraryWatcher::UpdateRoots()
+{
+  std::map<std::string, int> roots;
+
+  CVideoDatabase videodb;
+  if (videodb.Open())
+  {
+    std::set<std::string> paths;
+    videodb.GetPaths(paths);
+    for (const auto& path : paths)
+      roots[path] |= LIBRARY_VIDEO;
+    videodb.Close();
+  }
+
+  VECSOURCES* sources = CMediaSourceSettings::GetInstance().GetSources("music");
+  if (sources)
+  {
+    for (const auto& source : *sources)
+    {
+      for (const auto& path : source.vecPaths)
+        roots[path] |= LIBRARY_MUSIC;
+    }
+  }
+
+  // only local folders can be watched
+  for (auto it = roots.begin(); it != roots.end();)
+  {
+    const std::string localPath = CSpecialProtocol::TranslatePath(it->first);
+    if (localPath.empty() || localPath[0] != '/')
+      it = roots.erase(it);
+    else
+      ++it;
+  }
+
+  for (const auto& root : m_roots)
+  {
+    if (roots.find(root.first) == roots.end())
+    {
+      RemoveWatches(root.first);
+      m_unwatchedRoots.erase(root.first);
+    }
+  }
+  m_roots.swap(roots);
+
+  // parents sort before their subfolders, so nested sources are watched already
+  for (const auto& root : m_roots)
+  {
+    if (m_unwatchedRoots.find(root.first) == m_unwatchedRoots.end() && !AddWatches(root.first))
+      OnWatchLimit(root.first);
+  }
+  CLog::Log(LOGDEBUG, "CLibraryWatcher: watching %u folders of %u sources", static_cast<unsigned int>(m_watches.size()), static_cast<unsigned int>(m_roots.size()));
+}
+
+bool CLibraryWatcher::AddWatches(const std::string& path)
+{
+  if (m_watchedPaths.find(path) != m_watchedPaths.end())
+    return true;
+
+  const std::string localPath = CSpecialProtocol::TranslatePath(path);
+  int wd = inotify_add_watch(m_fd, localPath.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    // ENOSPC means the user's watch limit is reached, anything else that the
+    // folder is gone or not a folder and there is nothing to watch
+    if (errno == ENOSPC)
+      return false;
+    CLog::Log(LOGDEBUG, "CLibraryWatcher: unable to watch %s: %s", CURL::GetRedacted(path).c_str(), strerror(errno));
+    return true;
+  }
+  m_watches[wd] = path;
+  m_watchedPaths[path] = wd;
+
+  DIR* dir = opendir(localPath.c_str());
+  if (!dir)
+    return true;
+
+  bool result = true;
+  struct dirent* entry;
+  while (result && (entry = readdir(dir)) != nullptr)
+  {
+    // skips ".", ".." and hidden folders, symlinks are not followed
+    if (entry->d_name[0] == '.')
+      continue;
+    bool isDir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN)
+    {
+      struct stat buffer;
+      isDir = lstat(URIUtils::AddFileToFolder(localPath, entry->d_name).c_str(), &buffer) == 0 && S_ISDIR(buffer.st_mode);
+    }
+    if (isDir)
+    {
+      std::string subPath = URIUtils::AddFileToFolder(path, entry->d_name);
+      URIUtils::AddSlashAtEnd(subPath);
+      result = AddWatches(subPath);
+    }
+  }
+  closedir(dir);
+  return result;
+}
+
+void CLibraryWatcher::RemoveWatches(const std::string& path)
+{
+  for (auto it = m_watchedPaths.begin(); it != m_watchedPaths.end();)
+  {
+    if (URIUtils::PathHasParent(it->first, path))
+    {
+      inotify_rm_watch(m_fd, it->second);
+      m_watches.erase(it->second);
+      it = m_watchedPaths.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CLibraryWatcher::OnWatchLimit(const std::string& path)
+{
+  // give up on the whole source, parents sort first
+  for (const auto& root : m_roots)
+  {
+    if (!URIUtils::PathHasParent(path, root.first))
+      continue;
+
+    CLog::Log(LOGWARNING, "CLibraryWatcher: out of inotify watches, %s will be scanned every %u minutes instead "
+                          "(raise fs.inotify.max_user_watches to watch it)",
+              CURL::GetRedacted(root.first).c_str(), g_advancedSettings.m_libraryWatcherFallbackInterval);
+    RemoveWatches(root.first);
+    for (const auto& nested : m_roots)
+    {
+      if (URIUtils::PathHasParent(nested.first, root.first))
+      {
+        m_unwatchedRoots.insert(nested.first);
+        // changes since the source was listed may have been missed
+        OnChange(nested.first, nested.second, false);
+      }
+    }
+    return;
+  }
+}
+
+int CLibraryWatcher::GetLibraries(const std::string& directory) const
+{
+  int libraries = 0;
+  for (const auto& root : m_roots)
+  {
+    if (URIUtils::PathHasParent(directory, root.first))
+      libraries |= root.second;
+  }
+  return libraries;
+}
+
+void CLibraryWatcher::ReadEvents()
+{
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  ssize_t length;
+  while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+  {
+    const struct inotify_event* event;
+    for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + event->len)
+    {
+      event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        CLog::Log(LOGWARNING, "CLibraryWatcher: inotify event queue overflowed, scanning all sources");
+        for (const auto& root : m_roots)
+          OnChange(root.first, root.second, false);
+        continue;
+      }
+
+      auto watch = m_watches.find(event->wd);
+      if (watch == m_watches.end())
+        continue;
+      if (event->mask & IN_IGNORED)
+      {
+        m_watchedPaths.erase(watch->second);
+        m_watches.erase(watch);
+        continue;
+      }
+      if (event->len == 0 || event->name[0] == '.')
+        continue;
+
+      const std::string directory = watch->second;
+      const int libraries = GetLibraries(directory);
+      const bool removed = (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+      if (event->mask & IN_ISDIR)
+      {
+        std::string path = URIUtils::AddFileToFolder(directory, event->name);
+        URIUtils::AddSlashAtEnd(path);
+        if (removed)
+        {
+          RemoveWatches(path);
+          OnChange(directory, libraries, true, path);
+        }
+        else
+        {
+          if (!AddWatches(path))
+            OnWatchLimit(path);
+          OnChange(path, libraries, false);
+        }
+      }
+      else if (IsFileChange(event->mask))
+        OnChange(directory, libraries, removed);
+    }
+  }
+}
+
+bool CLibraryWatcher::IsFileChange(uint32_t mask)
+{
+  // IN_CREATE is watched for folders only, a file that was just created may
+  // still be written to and is picked up once it is closed or moved in
+  return (mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM)) != 0;
+}
+
+void CLibraryWatcher::OnChange(const std::string& directory, int libraries, bool removed, const std::string& removedFolder /* = "" */)
+{
+  if (libraries == 0)
+    return;
+
+  // every event postpones the scan, so a folder that is being filled is
+  // only scanned once it is done
+  SChange& change = m_changes[directory];
+  change.libraries |= libraries;
+  change.removed |= removed;
+  if (!removedFolder.empty())
+    change.removedFolders.insert(removedFolder);
+  change.due = XbmcThreads::SystemClockMillis() + g_advancedSettings.m_libraryWatcherDelay;
+}
+
+void CLibraryWatcher::ScanUnwatchedRoots()
+{
+  for (const auto& root : m_unwatchedRoots)
+  {
+    auto it = m_roots.find(root);
+    if (it != m_roots.end())
+      OnChange(it->first, it->second, false);
+  }
+}
+
+void CLibraryWatcher::DispatchChanges()
+{
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  CVideoDatabase videodb;
+  bool videodbOpen = false;
+
+  for (auto it = m_changes.begin(); it != m_changes.end();)
+  {
+    SChange& change = it->second;
+    if (static_cast<int>(change.due - now) > 0)
+    {
+      ++it;
+      continue;
+    }
+
+    if (change.libraries & LIBRARY_VIDEO)
+    {
+      if (!videodbOpen)
+        videodbOpen = videodb.Open();
+      if (videodbOpen)
+        DispatchVideoChange(videodb, it->first, change.removed);
+      change.libraries &= ~LIBRARY_VIDEO;
+    }
+
+    if (change.libraries & LIBRARY_MUSIC)
+    {
+      // the music scanner runs one scan at a time, the folder waits for it
+      if (g_application.IsMusicScanning())
+      {
+        change.due = now + g_advancedSettings.m_libraryWatcherDelay;
+        ++it;
+        continue;
+      }
+
+      // the scan takes removed files out of the folders it reads but doesn't
+      // visit folders that are gone
+      if (!change.removedFolders.empty())
+      {
+        CleanMusic(change.removedFolders);
+        change.removedFolders.clear();
+      }
+
+      int flags = MUSIC_INFO::CMusicInfoScanner::SCAN_BACKGROUND;
+      if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_DOWNLOADINFO))
+        flags |= MUSIC_INFO::CMusicInfoScanner::SCAN_ONLINE;
+      CLog::Log(LOGDEBUG, "CLibraryWatcher: scanning music in %s", CURL::GetRedacted(it->first).c_str());
+      if (!g_application.StartMusicScan(it->first, false, flags))
+      {
+        // another scan started in the meantime, keep the folder queued
+        change.due = now + g_advancedSettings.m_libraryWatcherDelay;
+        ++it;
+        continue;
+      }
+    }
+
+    it = m_changes.erase(it);
+  }
+
+  if (videodbOpen)
+    videodb.Close();
+}
+
+void CLibraryWatcher::DispatchVideoChange(CVideoDatabase& videodb, const std::string& directory, bool removed)
+{
+  if (removed)
+  {
+    // the scan only adds, removed files are taken out by cleaning their paths
+    std::set<int> paths;
+    int idPath = videodb.GetPathId(directory);
+    if (idPath >= 0)
+      paths.insert(idPath);
+    std::vector<std::pair<int, std::string>> subpaths;
+    videodb.GetSubPaths(directory, subpaths);
+    for (const auto& subpath : subpaths)
+      paths.insert(subpath.first);
+
+    // an empty set would clean the whole library
+    if (!paths.empty())
+      CVideoLibraryQueue::GetInstance().CleanLibrary(paths);
+  }
+
+  const std::string path = GetVideoScanPath(directory, [&videodb](const std::string& path, bool& foundDirectly, bool& parentNameRoot)
+  {
+    VIDEO::SScanSettings settings;
+    ADDON::ScraperPtr scraper = videodb.GetScraperForPath(path, settings, foundDirectly);
+    parentNameRoot = settings.parent_name_root;
+    return scraper ? scraper->Content() : CONTENT_NONE;
+  });
+  if (!path.empty())
+  {
+    CLog::Log(LOGDEBUG, "CLibraryWatcher: scanning videos in %s", CURL::GetRedacted(path).c_str());
+    CVideoLibraryQueue::GetInstance().ScanLibrary(path, false, false);
+  }
+}
+
+void CLibraryWatcher::CleanMusic(const std::set<std::string>& removedFolders)
+{
+  CMusicDatabase musicdb;
+  if (!musicdb.Open())
+    return;
+
+  MAPSONGS songs;
+  for (const auto& folder : removedFolders)
+  {
+    CLog::Log(LOGDEBUG, "CLibraryWatcher: removing music in %s", CURL::GetRedacted(folder).c_str());
+    musicdb.RemoveSongsFromPath(folder, songs, false);
+  }
+  if (!songs.empty())
+  {
+    musicdb.CleanupOrphanedItems();
+    g_infoManager.ResetLibraryBools();
+  }
+  musicdb.Close();
+}
+
+std::string CLibraryWatcher::GetVideoScanPath(const std::string& directory, const ContentLookup& getContent)
+{
+  // episodes are enumerated from the folder of their show, so changes below a
+  // show are scanned from there
+  std::string path = directory;
+  std::string child;
+  while (true)
+  {
+    bool foundDirectly = false;
+    bool parentNameRoot = false;
+    const CONTENT_TYPE content = getContent(path, foundDirectly, parentNameRoot);
+    if (content == CONTENT_NONE)
+      return "";
+    if (content != CONTENT_TVSHOWS)
+      return directory;
+    if (foundDirectly)
+      return parentNameRoot || child.empty() ? path : child;
+
+    const std::string parent = URIUtils::GetParentPath(path);
+    if (parent.empty() || parent == path)
+      return path;
+    child = path;
+    path = parent;
+  }
+}
+
+#endif
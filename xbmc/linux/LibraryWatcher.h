@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+
+#include "addons/Scraper.h"
+#include "threads/Thread.h"
+
+class CVideoDatabase;
+
+/*!
+ * \brief Keeps the libraries up to date with local sources through inotify
+ *
+ * Every folder below the local video and music sources is watched. Changes
+ * are collected per folder and, once a folder was quiet for a while, handed
+ * to the library scanners for just that folder: the video scan of the
+ * folder (or its tv show) goes to CVideoLibraryQueue, removals additionally
+ * queue a clean of its paths, music folders are scanned by the music
+ * scanner once it is idle after the songs of removed subfolders were taken
+ * out of the music library.
+ *
+ * When the kernel runs out of watches for a source, that source falls back
+ * to being scanned as a whole in a fixed interval. An overflow of the event
+ * queue has all sources scanned once.
+ */
+class CLibraryWatcher : protected CThread
+{
+public:
+  static CLibraryWatcher& GetInstance();
+
+  /*!
+   * \brief Start watching, or pick up changed sources if already running
+   */
+  void Start();
+  void Stop();
+
+protected:
+  void Process() override;
+
+private:
+  friend class TestLibraryWatcher;
+
+  CLibraryWatcher();
+  ~CLibraryWatcher();
+  CLibraryWatcher(const CLibraryWatcher&) = delete;
+  CLibraryWatcher& operator=(const CLibraryWatcher&) = delete;
+
+  enum Library
+  {
+    LIBRARY_VIDEO = 1,
+    LIBRARY_MUSIC = 2
+  };
+
+  struct SChange
+  {
+    int libraries = 0;
+    bool removed = false;
+    std::set<std::string> removedFolders;
+    unsigned int due = 0;
+  };
+
+  /*!
+   * \brief Looks up the content of a path, whether it was set on the path
+   * itself and whether the parent folder name is the root of its items
+   */
+  typedef std::function<CONTENT_TYPE(const std::string& path, bool& foundDirectly, bool& parentNameRoot)> ContentLookup;
+
+  void UpdateRoots();
+  bool AddWatches(const std::string& path);
+  void RemoveWatches(const std::string& path);
+  void OnWatchLimit(const std::string& path);
+  int GetLibraries(const std::string& directory) const;
+  void ReadEvents();
+  /*!
+   * \brief Whether an inotify event of a file, not a folder, changes the library
+   */
+  static bool IsFileChange(uint32_t mask);
+  void OnChange(const std::string& directory, int libraries, bool removed, const std::string& removedFolder = "");
+  void ScanUnwatchedRoots();
+  void DispatchChanges();
+  void DispatchVideoChange(CVideoDatabase& videodb, const std::string& directory, bool removed);
+  void CleanMusic(const std::set<std::string>& removedFolders);
+  static std::string GetVideoScanPath(const std::string& directory, const ContentLookup& getContent);
+
+  int m_fd;
+  std::map<int, std::string> m_watches; ///< watch descriptor to library path
+  std::map<std::string, int> m_watchedPaths;
+  std::map<std::string, int> m_roots; ///< library path of each source to the libraries it belongs to
+  std::set<std::string> m_unwatchedRoots;
+  std::map<std::string, SChange> m_changes;
+  unsigned int m_lastRefresh;
+  std::atomic<bool> m_updateRoots;
+};
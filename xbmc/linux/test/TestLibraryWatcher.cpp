@@ -0,0 +1,180 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "linux/LibraryWatcher.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+
+#include <map>
+#include <string>
+#include <sys/inotify.h>
+
+#include "gtest/gtest.h"
+
+class TestLibraryWatcher : public testing::Test
+{
+protected:
+  TestLibraryWatcher()
+  {
+    m_delay = g_advancedSettings.m_libraryWatcherDelay;
+    g_advancedSettings.m_libraryWatcherDelay = 5000;
+  }
+
+  ~TestLibraryWatcher()
+  {
+    g_advancedSettings.m_libraryWatcherDelay = m_delay;
+  }
+
+  void OnChange(const std::string& directory, int libraries, bool removed, const std::string& removedFolder = "")
+  {
+    m_watcher.OnChange(directory, libraries, removed, removedFolder);
+  }
+
+  static bool IsFileChange(uint32_t mask)
+  {
+    return CLibraryWatcher::IsFileChange(mask);
+  }
+
+  const std::map<std::string, CLibraryWatcher::SChange>& GetChanges() const
+  {
+    return m_watcher.m_changes;
+  }
+
+  void SetDue(const std::string& directory, unsigned int due)
+  {
+    m_watcher.m_changes[directory].due = due;
+  }
+
+  // content of each folder that has one set, and whether it was set with
+  // the parent folder name as the root of its items
+  std::string GetVideoScanPath(const std::string& directory, const std::map<std::string, std::pair<CONTENT_TYPE, bool>>& contents)
+  {
+    return CLibraryWatcher::GetVideoScanPath(directory, [&contents](const std::string& path, bool& foundDirectly, bool& parentNameRoot)
+    {
+      // like the video database, the setting of the closest parent applies
+      std::string current = path;
+      while (!current.empty())
+      {
+        auto it = contents.find(current);
+        if (it != contents.end())
+        {
+          foundDirectly = current == path;
+          parentNameRoot = it->second.second;
+          return it->second.first;
+        }
+        const std::string parent = URIUtils::GetParentPath(current);
+        if (parent == current)
+          break;
+        current = parent;
+      }
+      return CONTENT_NONE;
+    });
+  }
+
+  enum
+  {
+    LIBRARY_VIDEO = CLibraryWatcher::LIBRARY_VIDEO,
+    LIBRARY_MUSIC = CLibraryWatcher::LIBRARY_MUSIC
+  };
+
+  CLibraryWatcher m_watcher;
+  unsigned int m_delay;
+};
+
+TEST_F(TestLibraryWatcher, Coalesce)
+{
+  OnChange("/media/music/album/", LIBRARY_MUSIC, false);
+  OnChange("/media/music/album/", LIBRARY_VIDEO, true, "/media/music/album/cd1/");
+  OnChange("/media/music/album/", LIBRARY_MUSIC, false);
+  OnChange("/media/music/album/", LIBRARY_MUSIC, true, "/media/music/album/cd2/");
+  OnChange("/media/music/other/", LIBRARY_MUSIC, false);
+
+  // events without a library are dropped
+  OnChange("/media/unknown/", 0, true);
+
+  const auto& changes = GetChanges();
+  ASSERT_EQ(2U, changes.size());
+  const auto& change = changes.at("/media/music/album/");
+  EXPECT_EQ(LIBRARY_MUSIC | LIBRARY_VIDEO, change.libraries);
+  EXPECT_TRUE(change.removed);
+  EXPECT_EQ(2U, change.removedFolders.size());
+  EXPECT_EQ(1U, change.removedFolders.count("/media/music/album/cd1/"));
+  EXPECT_EQ(1U, change.removedFolders.count("/media/music/album/cd2/"));
+
+  const auto& other = changes.at("/media/music/other/");
+  EXPECT_EQ(LIBRARY_MUSIC, other.libraries);
+  EXPECT_FALSE(other.removed);
+  EXPECT_TRUE(other.removedFolders.empty());
+}
+
+TEST_F(TestLibraryWatcher, FileEvents)
+{
+  // a file that was just created may still be copied
+  EXPECT_FALSE(IsFileChange(IN_CREATE));
+  EXPECT_TRUE(IsFileChange(IN_CLOSE_WRITE));
+  EXPECT_TRUE(IsFileChange(IN_MOVED_TO));
+  EXPECT_TRUE(IsFileChange(IN_DELETE));
+  EXPECT_TRUE(IsFileChange(IN_MOVED_FROM));
+}
+
+TEST_F(TestLibraryWatcher, Debounce)
+{
+  const unsigned int before = XbmcThreads::SystemClockMillis();
+  OnChange("/media/music/album/", LIBRARY_MUSIC, false);
+  const unsigned int after = XbmcThreads::SystemClockMillis();
+
+  const auto& changes = GetChanges();
+  unsigned int due = changes.at("/media/music/album/").due;
+  EXPECT_GE(static_cast<int>(due - before), 5000);
+  EXPECT_LE(static_cast<int>(due - after), 5000);
+
+  // a folder that is about to be due is postponed by every further event
+  SetDue("/media/music/album/", after);
+  OnChange("/media/music/album/", LIBRARY_MUSIC, false);
+  due = changes.at("/media/music/album/").due;
+  EXPECT_GE(static_cast<int>(due - after), 5000);
+  EXPECT_EQ(1U, changes.size());
+}
+
+TEST_F(TestLibraryWatcher, VideoScanPath)
+{
+  const std::map<std::string, std::pair<CONTENT_TYPE, bool>> contents = {
+    { "/media/movies/", { CONTENT_MOVIES, false } },
+    { "/media/tvshows/", { CONTENT_TVSHOWS, false } },
+    { "/media/single/", { CONTENT_TVSHOWS, true } },
+    { "/media/excluded/", { CONTENT_NONE, false } }
+  };
+
+  // movies are scanned in the folder that changed
+  EXPECT_EQ("/media/movies/collection/movie/", GetVideoScanPath("/media/movies/collection/movie/", contents));
+
+  // episodes are scanned from the folder of their show
+  EXPECT_EQ("/media/tvshows/show/", GetVideoScanPath("/media/tvshows/show/season 1/", contents));
+  EXPECT_EQ("/media/tvshows/show/", GetVideoScanPath("/media/tvshows/show/", contents));
+  EXPECT_EQ("/media/tvshows/", GetVideoScanPath("/media/tvshows/", contents));
+
+  // a source that is a single show is scanned as a whole
+  EXPECT_EQ("/media/single/", GetVideoScanPath("/media/single/season 1/", contents));
+
+  // folders without content aren't scanned
+  EXPECT_EQ("", GetVideoScanPath("/media/excluded/folder/", contents));
+  EXPECT_EQ("", GetVideoScanPath("/media/other/", contents));
+}
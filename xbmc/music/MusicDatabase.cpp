@@ -4295,13 +4295,22 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     else
       strSQL = "SELECT songview.* FROM songview " + strSQLExtra;
 
+    // Avoid sorting with limits when have join with songartistview 
+    // Limit when SortByNone already applied in SQL, 
+    // apply sort later to fileitems list rather than dataset
+    sorting = sortDescription;
+    if (artistData && sortDescription.sortBy != SortByNone)
+      sorting.sortBy = SortByNone;
+    // Without sorting of the dataset every row is turned into an item as it
+    // is read, rather than holding the whole result set in memory first
+    const bool useCursor = sorting.sortBy == SortByNone;
+
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!(useCursor ? m_pDS->query_cursor(strSQL) : m_pDS->query(strSQL)))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    if (m_pDS->eof())
     {
       m_pDS->close();
       return true;
@@ -4310,62 +4319,67 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     // Store the total number of songs as a property
     items.SetProperty("total", total);
 
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    // Avoid sorting with limits when have join with songartistview 
-    // Limit when SortByNone already applied in SQL, 
-    // apply sort later to fileitems list rather than dataset
-    sorting = sortDescription;
-    if (artistData && sortDescription.sortBy != SortByNone)
-      sorting.sortBy = SortByNone;
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
-      return false;
-
     // Get songs from returned rows. If join songartistview then there is a row for every artist
     items.Reserve(total);
     int songArtistOffset = song_enumCount;
     int songId = -1;
     VECARTISTCREDITS artistCredits;
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
     int count = 0;
-    for (const auto &i : results)
+    auto addRow = [&](const dbiplus::sql_record* const record)
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-      
-      try
-      {
-        if (songId != record->at(song_idSong).get_asInt())
-        { //New song
-          if (songId > 0 && !artistCredits.empty())
-          {
-            //Store artist credits for previous song
-            GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
-            artistCredits.clear();
-          }
-          songId = record->at(song_idSong).get_asInt();
-          CFileItemPtr item(new CFileItem);
-          GetFileItemFromDataset(record, item.get(), musicUrl);
-          // HACK for sorting by database returned order
-          item->m_iprogramCount = ++count;
-          items.Add(item);
-        }
-        // Get song artist credits and contributors
-        if (artistData)
+      if (songId != record->at(song_idSong).get_asInt())
+      { //New song
+        if (songId > 0 && !artistCredits.empty())
         {
-          int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
-          if (idSongArtistRole == ROLE_ARTIST)
-            artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
-          else
-            items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));           
+          //Store artist credits for previous song
+          GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
+          artistCredits.clear();
         }
+        songId = record->at(song_idSong).get_asInt();
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(record, item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
       }
-      catch (...)
+      // Get song artist credits and contributors
+      if (artistData)
       {
-        m_pDS->close();
-        CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
-        return (items.Size() > 0);
+        int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
+        if (idSongArtistRole == ROLE_ARTIST)
+          artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
+        else
+          items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));           
+      }
+    };
+
+    try
+    {
+      if (useCursor)
+      {
+        for (; !m_pDS->eof(); m_pDS->next())
+          addRow(m_pDS->get_sql_record());
       }
+      else
+      {
+        DatabaseResults results;
+        results.reserve(m_pDS->num_rows());
+        if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
+          return false;
+
+        const dbiplus::query_data &data = m_pDS->get_result_set().records;
+        for (const auto &i : results)
+        {
+          unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
+          addRow(data.at(targetRow));
+        }
+      }
+    }
+    catch (...)
+    {
+      m_pDS->close();
+      CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
+      return (items.Size() > 0);
     }
     if (!artistCredits.empty())
     {
@@ -34,6 +34,7 @@
 #include "events/MediaLibraryEvent.h"
 #include "FileItem.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
@@ -124,6 +125,8 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_fingerprintDatabase.Open();
+      m_fingerprintStats = SFingerprintStats();
 
       // Create the thread to count all files to be scanned
       SetPriority( GetMinPriority() );
@@ -182,9 +185,12 @@ void CMusicInfoScanner::Process()
       m_fileCountReader.StopThread();
 
       m_musicDatabase.EmptyCache();
+      m_fingerprintDatabase.Close();
       
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Files in changed folders: %u added, %u modified, %u removed, %u unchanged and skipped",
+                m_fingerprintStats.added, m_fingerprintStats.modified, m_fingerprintStats.removed, m_fingerprintStats.unchanged);
     }
     if (m_scanType == 1) // load album info
     {
@@ -447,13 +453,40 @@ static std::string Prettify(const std::string& strDirectory)
 }
 
 bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
+{
+  // list the tree with several connections while the folders are scanned
+  // one by one in the order a recursive walk would visit them
+  CDirectoryWalker walker(g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
+  walker.SetPrepareFunction([](CFileItemList& items)
+  {
+    items.Sort(SortByLabel, SortOrderAscending);
+  });
+  walker.SetDescendFunction([](const CFileItem& item)
+  {
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    return item.m_bIsFolder && !item.IsParentFolder() && !item.IsPlayList();
+  });
+  walker.Start(strDirectory);
+
+  std::string strPath;
+  CFileItemList items;
+  while (!m_bStop && walker.Next(strPath, items))
+  {
+    if (!ScanDirectory(strPath, items))
+      walker.SkipChildren();
+  }
+
+  return !m_bStop;
+}
+
+bool CMusicInfoScanner::ScanDirectory(const std::string& strDirectory, CFileItemList& items)
 {
   if (m_handle)
     m_handle->SetText(Prettify(strDirectory));
 
   std::set<std::string>::const_iterator it = m_seenPaths.find(strDirectory);
   if (it != m_seenPaths.end())
-    return true;
+    return false;
 
   m_seenPaths.insert(strDirectory);
 
@@ -461,16 +494,11 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   const std::vector<std::string> &regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
   if (IsExcluded(strDirectory, regexps))
-    return true;
-
-  // load subfolder
-  CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
+    return false;
 
-  // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
-  // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
-  // if we have a changed hash.
-  items.Sort(SortByLabel, SortOrderAscending);
+  // get the path hash of the sorted subfolder.  Note that we don't filter .cue sheet
+  // items here as we want to detect changes in the .cue sheet as well.  The .cue sheet
+  // items only need filtering if we have a changed hash.
   std::string hash;
   GetPathHash(items, hash);
 
@@ -483,16 +511,42 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     else
       CLog::Log(LOGDEBUG, "%s Rescanning dir '%s' due to change", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
 
-    // filter items in the sub dir (for .cue sheet support)
-    items.FilterCueItems();
-    items.Sort(SortByLabel, SortOrderAscending);
+    // albums are rebuilt from all songs of a folder, so its files are either
+    // all read again or, if only its subfolders changed, none of them
+    FingerprintMap stored, current;
+    if (!dbHash.empty() && !(m_flags & SCAN_RESCAN))
+      m_fingerprintDatabase.GetFingerprints("music", strDirectory, stored);
+    std::set<std::string> unchanged;
+    SFingerprintStats stats = CFingerprintDatabase::Compare(stored, items, current, unchanged);
 
-    // and then scan in the new information
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
+    if (!stored.empty() && !stats.HasChanges())
     {
+      CLog::Log(LOGDEBUG, "%s Skipping %u unchanged files in dir '%s'", __FUNCTION__, stats.unchanged, CURL::GetRedacted(strDirectory).c_str());
+      m_fingerprintStats += stats;
+      m_currentItem += CountFiles(items, false);
       if (m_handle)
         OnDirectoryScanned(strDirectory);
     }
+    else
+    {
+      // unchanged files are read again along with the others
+      stats.unchanged = 0;
+      m_fingerprintStats += stats;
+
+      // filter items in the sub dir (for .cue sheet support)
+      items.FilterCueItems();
+      items.Sort(SortByLabel, SortOrderAscending);
+
+      // and then scan in the new information
+      if (RetrieveMusicInfo(strDirectory, items) > 0)
+      {
+        if (m_handle)
+          OnDirectoryScanned(strDirectory);
+      }
+
+      if (!m_bStop)
+        m_fingerprintDatabase.SetFingerprints("music", strDirectory, current);
+    }
 
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
@@ -511,25 +565,8 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     }
   }
 
-  // now scan the subfolders
-  for (int i = 0; i < items.Size(); ++i)
-  {
-    CFileItemPtr pItem = items[i];
-
-    if (m_bStop)
-      break;
-    // if we have a directory item (non-playlist) we then recurse into that folder
-    if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
-    {
-      std::string strPath=pItem->GetPath();
-      if (!DoScan(strPath))
-      {
-        m_bStop = true;
-      }
-    }
-  }
-
-  return !m_bStop;
+  // the walker goes on with the subfolders
+  return true;
 }
 
 INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items, CFileItemList& scannedItems)
@@ -18,6 +18,7 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include "FingerprintDatabase.h"
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
@@ -191,6 +192,13 @@ protected:
 
   bool DoScan(const std::string& strDirectory) override;
 
+  /*! \brief Scan a single folder of the tree walked by DoScan()
+   \param strDirectory the folder
+   \param items its listing, sorted by label
+   \return false if the subfolders should be skipped
+   */
+  bool ScanDirectory(const std::string& strDirectory, CFileItemList& items);
+
   virtual void Run() override;
   int CountFiles(const CFileItemList& items, bool recursive);
   int CountFilesRecursively(const std::string& strPath);
@@ -215,6 +223,8 @@ protected:
   bool m_needsCleanup;
   int m_scanType; // 0 - load from files, 1 - albums, 2 - artists
   CMusicDatabase m_musicDatabase;
+  CFingerprintDatabase m_fingerprintDatabase;
+  SFingerprintStats m_fingerprintStats;
 
   std::map<CAlbum, CAlbum> m_albumCache;
   std::map<CArtistCredit, CArtist> m_artistCache;
@@ -75,6 +75,10 @@ typedef struct {
   uint64_t writePosition;
 } HttpFileDownloadContext;
 
+typedef struct {
+  std::shared_ptr<IHTTPRequestHandler> handler;
+} HttpStreamDownloadContext;
+
 CWebServer::CWebServer()
   : m_port(0),
     m_daemon_ip6(nullptr),
@@ -498,6 +502,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateMemoryDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, responseDetails.status, request.method, response);
       break;
@@ -882,6 +890,52 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+
+#if (MHD_VERSION >= 0x00090B01)
+  if (request.method != HEAD)
+  {
+    // the handler produces the response while it is being sent, with one
+    // thread per connection this doesn't hold up any other request
+    std::unique_ptr<HttpStreamDownloadContext> context(new HttpStreamDownloadContext());
+    context->handler = handler;
+
+    response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 32 * 1024,
+                                                 &CWebServer::StreamReaderCallback,
+                                                 context.get(),
+                                                 &CWebServer::StreamReaderFreeCallback);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP stream response for %s", m_port, request.pathUrl.c_str());
+      return MHD_NO;
+    }
+
+    context.release(); // ownership was passed to mhd
+    return MHD_YES;
+  }
+#endif
+
+  // collect the whole response up front
+  std::string data;
+  char buffer[32 * 1024];
+  size_t read;
+  while ((read = handler->ReadResponseData(buffer, sizeof(buffer))) > 0)
+    data.append(buffer, read);
+
+  if (request.method == HEAD)
+  {
+    handler->AddResponseHeader(MHD_HTTP_HEADER_CONTENT_LENGTH, std::to_string(data.size()));
+    return CreateMemoryDownloadResponse(request.connection, nullptr, 0, false, false, response);
+  }
+
+  return CreateMemoryDownloadResponse(request.connection, data.c_str(), data.size(), false, true, response);
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const
 {
   size_t payloadSize = 0;
@@ -1083,6 +1137,33 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
     CLog::Log(LOGDEBUG, "CWebServer [OUT] done");
 }
 
+#if (MHD_VERSION >= 0x00090B01)
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  if (context == nullptr || context->handler == nullptr)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  size_t read = context->handler->ReadResponseData(buf, max);
+  if (read == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  if (g_advancedSettings.CanLogComponent(LOGWEBSERVER))
+    CLog::Log(LOGDEBUG, "CWebServer [OUT] wrote %zu bytes from %" PRIu64, read, pos);
+
+  return read;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  HttpStreamDownloadContext *context = (HttpStreamDownloadContext *)cls;
+  delete context;
+
+  if (g_advancedSettings.CanLogComponent(LOGWEBSERVER))
+    CLog::Log(LOGDEBUG, "CWebServer [OUT] done");
+}
+#endif
+
 // local helper
 static void panicHandlerForMHD(void* unused, const char* file, unsigned int line, const char *reason)
 {
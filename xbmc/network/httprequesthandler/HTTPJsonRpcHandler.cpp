@@ -26,6 +26,7 @@
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
@@ -84,10 +85,21 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    // the response is serialised while it is being sent
+    m_responseStream.reset(new JSONRPC::CResponseStream(g_advancedSettings.m_jsonOutputCompact));
+    if (!JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client, *m_responseStream))
+      m_responseStream.reset();
+    else if (!jsonpCallback.empty())
+      m_responseStream->SetWrapper(jsonpCallback + "(", ");");
 
-    if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+    m_requestData.clear();
+
+    m_response.type = HTTPStreamDownload;
+    m_response.status = MHD_HTTP_OK;
+    m_response.contentType = "application/json";
+    m_response.totalLength = 0;
+
+    return MHD_YES;
   }
   else if (jsonpCallback.empty())
   {
@@ -130,6 +142,14 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+size_t CHTTPJsonRpcHandler::ReadResponseData(char *buffer, size_t size)
+{
+  if (m_responseStream == nullptr)
+    return 0;
+
+  return m_responseStream->Read(buffer, size);
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
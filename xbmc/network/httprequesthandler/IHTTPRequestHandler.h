@@ -65,7 +65,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length filled from ReadResponseData()
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -158,6 +160,14 @@ public:
    */
   virtual HttpResponseRanges GetResponseData() const { return HttpResponseRanges(); };
 
+  /*!
+   * \brief Copies the next part of the response into the given buffer.
+   *
+   * \details This is only used if the response type is HTTPStreamDownload.
+   * \return Number of bytes copied, 0 at the end of the response.
+   */
+  virtual size_t ReadResponseData(char *buffer, size_t size) { return 0; }
+
   /*!
   * \brief Returns the URL to which the request should be redirected.
   *
@@ -361,12 +361,24 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheSegments = 1;
+  m_cacheMemoryMapped = true;
+
+  m_directoryCacheMemSize = 1024 * 1024 * 16;
+  m_directoryCachePersistent = false;
+
+  m_libraryWatcherEnabled = false;
+  m_libraryWatcherDelay = 5000;
+  m_libraryWatcherFallbackInterval = 60;
 
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_jobManagerWorkStealing = false;
+  m_jobManagerMaxWorkers = 5;
+
   m_enableMultimediaKeys = false;
 
 #if defined(TARGET_DARWIN_IOS)
@@ -763,6 +775,16 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
   }
 
+  pElement = pRootElement->FirstChildElement("librarywatcher");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_libraryWatcherEnabled);
+    // milliseconds a folder has to be quiet before it is scanned
+    XMLUtils::GetUInt(pElement, "delay", m_libraryWatcherDelay, 0, 600000);
+    // minutes between scans of sources that could not be watched
+    XMLUtils::GetUInt(pElement, "fallbackinterval", m_libraryWatcherFallbackInterval, 1, 1440);
+  }
+
   pElement = pRootElement->FirstChildElement("videoscanner");
   if (pElement)
   {
@@ -798,6 +820,26 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    // ranges of a video kept cached at the same time, sharing memorysize
+    XMLUtils::GetUInt(pElement, "segments", m_cacheSegments, 1, 8);
+    // read uncached local videos through mmap
+    XMLUtils::GetBoolean(pElement, "mmap", m_cacheMemoryMapped);
+  }
+
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "memorysize", m_directoryCacheMemSize);
+    // keep listings of smb/nfs shares on disk, validated by directory mtime
+    XMLUtils::GetBoolean(pElement, "persistent", m_directoryCachePersistent);
+  }
+
+  pElement = pRootElement->FirstChildElement("jobmanager");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "workstealing", m_jobManagerWorkStealing);
+    // 0 sizes the pool by the number of cpu cores
+    XMLUtils::GetUInt(pElement, "maxworkers", m_jobManagerMaxWorkers, 0, 64);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
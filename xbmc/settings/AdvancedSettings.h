@@ -345,10 +345,22 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cacheSegments;
+    bool m_cacheMemoryMapped;
+
+    unsigned int m_directoryCacheMemSize;
+    bool m_directoryCachePersistent;
+
+    bool m_libraryWatcherEnabled;
+    unsigned int m_libraryWatcherDelay;
+    unsigned int m_libraryWatcherFallbackInterval;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    bool m_jobManagerWorkStealing;
+    unsigned int m_jobManagerMaxWorkers;
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
@@ -33,7 +33,9 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAESettings.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
+#include "filesystem/PersistentDirectoryCache.h"
 #include "games/GameSettings.h"
 #include "guilib/GraphicContext.h"
 #include "guilib/GUIAudioManager.h"
@@ -76,6 +78,7 @@
 #include "settings/lib/SettingsManager.h"
 #include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/RssManager.h"
 #include "utils/StringUtils.h"
@@ -960,6 +963,9 @@ void CSettings::InitializeISettingsHandlers()
   // register ISettingsHandler implementations
   // The order of these matters! Handlers are processed in the order they were registered.
   m_settingsManager->RegisterSettingsHandler(&g_advancedSettings);
+  m_settingsManager->RegisterSettingsHandler(&CJobManager::GetInstance());
+  m_settingsManager->RegisterSettingsHandler(&g_directoryCache);
+  m_settingsManager->RegisterSettingsHandler(&CPersistentDirectoryCache::GetInstance());
   m_settingsManager->RegisterSettingsHandler(&CMediaSourceSettings::GetInstance());
   m_settingsManager->RegisterSettingsHandler(&CPlayerCoreFactory::GetInstance());
   m_settingsManager->RegisterSettingsHandler(&CProfilesManager::GetInstance());
@@ -979,6 +985,9 @@ void CSettings::InitializeISettingsHandlers()
 void CSettings::UninitializeISettingsHandlers()
 {
   m_settingsManager->UnregisterSettingsHandler(&g_advancedSettings);
+  m_settingsManager->UnregisterSettingsHandler(&CJobManager::GetInstance());
+  m_settingsManager->UnregisterSettingsHandler(&g_directoryCache);
+  m_settingsManager->UnregisterSettingsHandler(&CPersistentDirectoryCache::GetInstance());
   m_settingsManager->UnregisterSettingsHandler(&CMediaSourceSettings::GetInstance());
   m_settingsManager->UnregisterSettingsHandler(&CPlayerCoreFactory::GetInstance());
   m_settingsManager->UnregisterSettingsHandler(&CProfilesManager::GetInstance());
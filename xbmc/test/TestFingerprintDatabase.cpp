@@ -0,0 +1,92 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "FingerprintDatabase.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+CFileItemPtr MakeFile(const std::string& path, int64_t size, time_t modified)
+{
+  CFileItemPtr item(new CFileItem(path, false));
+  item->m_dwSize = size;
+  if (modified)
+    item->m_dateTime = modified;
+  return item;
+}
+}
+
+TEST(TestFingerprintDatabase, Compare)
+{
+  CFileItemList items;
+  items.Add(MakeFile("smb://host/share/same.mkv", 100, 1000));
+  items.Add(MakeFile("smb://host/share/bigger.mkv", 200, 1000));
+  items.Add(MakeFile("smb://host/share/newer.mkv", 100, 2000));
+  items.Add(MakeFile("smb://host/share/added.mkv", 100, 1000));
+  items.Add(MakeFile("smb://host/share/nodate.mkv", 100, 0));
+  CFileItemPtr folder(new CFileItem("smb://host/share/sub/", true));
+  items.Add(folder);
+
+  FingerprintMap stored, current;
+  for (const char* file : { "same.mkv", "bigger.mkv", "newer.mkv", "nodate.mkv", "removed.mkv" })
+  {
+    SFingerprint& fingerprint = stored[std::string("smb://host/share/") + file];
+    fingerprint.size = 100;
+    fingerprint.modified = CFingerprintDatabase::GetFingerprint(*items[0]).modified;
+  }
+
+  std::set<std::string> unchanged;
+  SFingerprintStats stats = CFingerprintDatabase::Compare(stored, items, current, unchanged);
+
+  EXPECT_EQ(1U, stats.added);
+  EXPECT_EQ(3U, stats.modified);
+  EXPECT_EQ(1U, stats.removed);
+  EXPECT_EQ(1U, stats.unchanged);
+  EXPECT_TRUE(stats.HasChanges());
+
+  ASSERT_EQ(1U, unchanged.size());
+  EXPECT_EQ("smb://host/share/same.mkv", *unchanged.begin());
+  EXPECT_EQ(5U, current.size());
+  EXPECT_EQ(200, current["smb://host/share/bigger.mkv"].size);
+  EXPECT_EQ(0, current["smb://host/share/nodate.mkv"].modified);
+}
+
+TEST(TestFingerprintDatabase, NothingStored)
+{
+  CFileItemList items;
+  items.Add(MakeFile("nfs://host/export/a.flac", 100, 1000));
+  items.Add(MakeFile("nfs://host/export/b.flac", 100, 1000));
+
+  FingerprintMap current;
+  std::set<std::string> unchanged;
+  SFingerprintStats stats = CFingerprintDatabase::Compare(FingerprintMap(), items, current, unchanged);
+
+  EXPECT_EQ(2U, stats.added);
+  EXPECT_EQ(0U, stats.unchanged);
+  EXPECT_TRUE(unchanged.empty());
+
+  // comparing against what was just recorded finds nothing to do
+  FingerprintMap recorded = current;
+  stats = CFingerprintDatabase::Compare(recorded, items, current, unchanged);
+  EXPECT_FALSE(stats.HasChanges());
+  EXPECT_EQ(2U, stats.unchanged);
+}
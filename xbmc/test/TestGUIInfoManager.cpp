@@ -0,0 +1,78 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+TEST(TestGUIInfoManager, BoolDependencies)
+{
+  EXPECT_EQ(INFO_DEP_PLAYER, g_infoManager.Register("player.paused")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_PLAYER, g_infoManager.Register("musicplayer.hasnext")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_WINDOW, g_infoManager.Register("window.isactive(home)")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_WINDOW | INFO_DEP_LISTITEM, g_infoManager.Register("listitem.isfolder")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_LIBRARY, g_infoManager.Register("library.hascontent(movies)")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_SKIN, g_infoManager.Register("skin.hassetting(foo)")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_TIME, g_infoManager.Register("system.time(10:00,12:00)")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_NONE, g_infoManager.Register("system.platform.linux")->GetDependencies());
+  EXPECT_EQ(INFO_DEP_ALWAYS, g_infoManager.Register("string.isempty(window.property(foo))")->GetDependencies());
+}
+
+TEST(TestGUIInfoManager, ExpressionDependencies)
+{
+  // an expression depends on the sources of all its operands
+  InfoPtr info = g_infoManager.Register("player.paused + [window.isactive(home) | !skin.hassetting(foo)]");
+  EXPECT_EQ(INFO_DEP_PLAYER | INFO_DEP_WINDOW | INFO_DEP_SKIN, info->GetDependencies());
+
+  info = g_infoManager.Register("system.platform.linux | system.platform.windows");
+  EXPECT_EQ(INFO_DEP_NONE, info->GetDependencies());
+}
+
+TEST(TestGUIInfoManager, InvalidateChangedBools)
+{
+  InfoPtr info = g_infoManager.Register("skin.hassetting(testguiinfomanager)");
+  ASSERT_EQ(INFO_DEP_SKIN, info->GetDependencies());
+
+  // start from a frame that evaluated it
+  info->Get();
+  g_infoManager.InvalidateChangedBools(false);
+
+  // nothing was published, the value stays cached
+  info->Get();
+  g_infoManager.InvalidateChangedBools(false);
+  EXPECT_EQ(0U, g_infoManager.GetBoolEvaluations());
+
+  // a change of another source doesn't touch it either
+  g_infoManager.PublishChange(INFO_DEP_PLAYER | INFO_DEP_LIBRARY);
+  g_infoManager.InvalidateChangedBools(false);
+  info->Get();
+  g_infoManager.InvalidateChangedBools(false);
+  EXPECT_EQ(0U, g_infoManager.GetBoolEvaluations());
+
+  // a change of its source has it evaluated again, once per frame
+  g_infoManager.PublishChange(INFO_DEP_SKIN);
+  g_infoManager.InvalidateChangedBools(false);
+  info->Get();
+  info->Get();
+  g_infoManager.InvalidateChangedBools(false);
+  EXPECT_EQ(1U, g_infoManager.GetBoolEvaluations());
+}
@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/info/InfoExpression.h"
+#include "utils/StringUtils.h"
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+namespace
+{
+class CTestInfoBool : public InfoBool
+{
+public:
+  explicit CTestInfoBool(const std::string &condition) : InfoBool(condition, 0) {}
+  virtual void Update(const CGUIListItem *item) override { m_value = value; updates++; }
+
+  bool value = false;
+  int updates = 0;
+};
+}
+
+class TestInfoExpression : public testing::Test
+{
+protected:
+  InfoPtr Resolve(std::string operand)
+  {
+    // like CGUIInfoManager::Register()
+    StringUtils::Trim(operand);
+    std::shared_ptr<CTestInfoBool> &info = operands[operand];
+    if (!info)
+      info = std::make_shared<CTestInfoBool>(operand);
+    return info;
+  }
+
+  bool Evaluate(const std::string &expression, unsigned int values)
+  {
+    InfoExpression info(expression, 0, [this](const std::string &operand) { return Resolve(operand); });
+    for (const char *name : { "a", "b", "c", "d" })
+    {
+      std::shared_ptr<CTestInfoBool> operand = std::static_pointer_cast<CTestInfoBool>(Resolve(name));
+      operand->value = (values & 1) != 0;
+      operand->SetDirty();
+      values >>= 1;
+    }
+    return info.Get();
+  }
+
+  std::map<std::string, std::shared_ptr<CTestInfoBool>> operands;
+};
+
+TEST_F(TestInfoExpression, Evaluate)
+{
+  for (unsigned int values = 0; values < 16; values++)
+  {
+    const bool a = values & 1, b = values & 2, c = values & 4, d = values & 8;
+    EXPECT_EQ(a && b, Evaluate("a + b", values));
+    EXPECT_EQ(!(a || !b) && !c, Evaluate("![a | !b] + !c", values));
+    EXPECT_EQ((a || b) && (c || d), Evaluate("[a | b] + [c | d]", values));
+    EXPECT_EQ((a && (b || (c && !d))) || d, Evaluate("a + [b | [c + !d]] | d", values));
+    EXPECT_EQ(!((a || b) && !(c || d)), Evaluate("![[a | b] + ![c | d]]", values));
+  }
+}
+
+TEST_F(TestInfoExpression, SharedOperands)
+{
+  InfoExpression info("a + [b | !a] + [a | c]", 0, [this](const std::string &operand) { return Resolve(operand); });
+  EXPECT_EQ(3U, info.GetLeafCount());
+}
+
+TEST_F(TestInfoExpression, ShortCircuit)
+{
+  InfoExpression info("a + [b | c] + d", 0, [this](const std::string &operand) { return Resolve(operand); });
+  EXPECT_FALSE(info.Get());
+  // a is false, so nothing else needs to be evaluated
+  EXPECT_EQ(1, operands["a"]->updates);
+  EXPECT_EQ(0, operands["b"]->updates);
+  EXPECT_EQ(0, operands["c"]->updates);
+  EXPECT_EQ(0, operands["d"]->updates);
+}
+
+TEST_F(TestInfoExpression, ParseError)
+{
+  InfoExpression info("a + [b", 0, [this](const std::string &operand) { return Resolve(operand); });
+  operands["false"]->value = false;
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(1U, info.GetLeafCount());
+}
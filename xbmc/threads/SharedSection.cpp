@@ -0,0 +1,152 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SharedSection.h"
+
+// All flag and counter accesses are sequentially consistent: a reader
+// increments its counter and then reads m_writerActive, a writer sets
+// m_writerActive and then sums the counters, so at least one of them sees
+// the other. The same goes for m_writerWaiting and the decrement in
+// unlock_shared().
+
+unsigned int CSharedSection::NextReaderStripe()
+{
+  static std::atomic<unsigned int> next(0);
+  return next++ % READER_STRIPES;
+}
+
+int CSharedSection::CountReaders() const
+{
+  int readers = 0;
+  for (unsigned int i = 0; i < READER_STRIPES; ++i)
+    readers += m_readers[i].count.load();
+  return readers;
+}
+
+void CSharedSection::lock()
+{
+  if (IsOwner())
+  {
+    ++m_recursion;
+    return;
+  }
+
+  m_writeSection.lock();
+  CSingleLock waitLock(m_waitSection);
+  AcquireFromReaders(waitLock, true);
+}
+
+bool CSharedSection::try_lock()
+{
+  if (IsOwner())
+  {
+    ++m_recursion;
+    return true;
+  }
+
+  if (!m_writeSection.try_lock())
+    return false;
+
+  CSingleLock waitLock(m_waitSection);
+  if (AcquireFromReaders(waitLock, false))
+    return true;
+
+  waitLock.Leave();
+  m_writeSection.unlock();
+  return false;
+}
+
+bool CSharedSection::AcquireFromReaders(CSingleLock& waitLock, bool wait)
+{
+  while (true)
+  {
+    m_writerActive = true;
+    if (CountReaders() == 0)
+      break;
+
+    // readers are still inside. Step back so more of them can get in and
+    // wait for the last one to leave.
+    m_writerActive = false;
+    m_readersCv.notifyAll();
+    if (!wait)
+      return false;
+
+    m_writerWaiting = true;
+    if (CountReaders() != 0)
+      m_writerCv.wait(waitLock);
+    m_writerWaiting = false;
+  }
+
+  m_owner = std::this_thread::get_id();
+  m_recursion = 1;
+  return true;
+}
+
+void CSharedSection::unlock()
+{
+  if (--m_recursion > 0)
+    return;
+
+  m_owner = std::thread::id();
+  {
+    CSingleLock waitLock(m_waitSection);
+    m_writerActive = false;
+    m_readersCv.notifyAll();
+  }
+  m_writeSection.unlock();
+}
+
+bool CSharedSection::try_lock_shared()
+{
+  std::atomic<int>& readers = m_readers[ReaderStripe()].count;
+  readers.fetch_add(1);
+  if (!m_writerActive.load() || IsOwner())
+    return true;
+
+  readers.fetch_sub(1);
+  if (m_writerWaiting.load())
+    WakeWriter();
+  return false;
+}
+
+void CSharedSection::WaitForWriter(std::atomic<int>& readers)
+{
+  do
+  {
+    // back off so the writer doesn't wait for us, then wait until it's done
+    readers.fetch_sub(1);
+    if (m_writerWaiting.load())
+      WakeWriter();
+
+    {
+      CSingleLock waitLock(m_waitSection);
+      while (m_writerActive)
+        m_readersCv.wait(waitLock);
+    }
+
+    readers.fetch_add(1);
+  } while (m_writerActive.load());
+}
+
+void CSharedSection::WakeWriter()
+{
+  CSingleLock waitLock(m_waitSection);
+  m_writerCv.notifyAll();
+}
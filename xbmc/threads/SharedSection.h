@@ -20,31 +20,82 @@
  *
  */
 
+#include <atomic>
+#include <thread>
+
 #include "threads/Condition.h"
 #include "threads/SingleLock.h"
 #include "threads/Helpers.h"
 
 /**
  * A CSharedSection is a mutex that satisfies the Shared Lockable concept (see Lockables.h).
+ *
+ * Readers only touch one of several cache line sized counters, picked per thread, so
+ * concurrent readers don't bounce a shared mutex between cores. A writer announces itself
+ * and waits until all counters are zero. Like before readers are preferred: as long as
+ * shared locks are held new readers get in, and a waiting writer has to wait for a moment
+ * without readers.
+ *
+ * The exclusive lock is recursive, and the thread holding it may also take shared locks.
  */
-class CSharedSection
+class CSharedSection : public XbmcThreads::NonCopyable
 {
-  CCriticalSection sec;
-  XbmcThreads::ConditionVariable actualCv;
-  XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
+public:
+  inline CSharedSection() : m_writerActive(false), m_writerWaiting(false), m_owner(std::thread::id()), m_recursion(0) {}
 
-  unsigned int sharedCount;
+  void lock();
+  bool try_lock();
+  void unlock();
 
-public:
-  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+  inline void lock_shared()
+  {
+    std::atomic<int>& readers = m_readers[ReaderStripe()].count;
+    readers.fetch_add(1);
+    if (m_writerActive.load() && !IsOwner())
+      WaitForWriter(readers);
+  }
+  bool try_lock_shared();
+  inline void unlock_shared()
+  {
+    m_readers[ReaderStripe()].count.fetch_sub(1);
+    if (m_writerWaiting.load())
+      WakeWriter();
+  }
+
+private:
+  static const unsigned int READER_STRIPES = 8;
+
+  struct ReaderCount
+  {
+    ReaderCount() : count(0) {}
+    std::atomic<int> count;
+    char padding[64 - sizeof(std::atomic<int>)];
+  };
+
+  static unsigned int ReaderStripe()
+  {
+    static thread_local unsigned int stripe = NextReaderStripe();
+    return stripe;
+  }
+  static unsigned int NextReaderStripe();
+
+  inline bool IsOwner() const { return m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+  int CountReaders() const;
+  void WaitForWriter(std::atomic<int>& readers);
+  void WakeWriter();
+  bool AcquireFromReaders(CSingleLock& waitLock, bool wait);
+
+  ReaderCount m_readers[READER_STRIPES];
 
-  inline void lock() { CSingleLock l(sec); while (sharedCount) cond.wait(l); sec.lock(); }
-  inline bool try_lock() { return (sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false); }
-  inline void unlock() { sec.unlock(); }
+  CCriticalSection m_writeSection; ///< serializes writers
+  CCriticalSection m_waitSection;  ///< guards the writer state transitions below
+  XbmcThreads::ConditionVariable m_readersCv;
+  XbmcThreads::ConditionVariable m_writerCv;
 
-  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
-  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
-  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+  std::atomic<bool> m_writerActive;
+  std::atomic<bool> m_writerWaiting;
+  std::atomic<std::thread::id> m_owner;
+  unsigned int m_recursion; ///< only touched by the owner
 };
 
 class CSharedLock : public XbmcThreads::SharedLock<CSharedSection>
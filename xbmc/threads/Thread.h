@@ -78,6 +78,7 @@ public:
   bool WaitForThreadExit(unsigned int milliseconds);
   float GetRelativeUsage();  // returns the relative cpu usage of this thread since last call
   int64_t GetAbsoluteUsage();
+  const std::string& GetName() const { return m_ThreadName; }
   // -----------------------------------------------------------------------------------
 
   static bool IsCurrentThread(const ThreadIdentifier tid);
@@ -221,3 +221,53 @@ TEST(TestMultipleSharedSection, General)
   }
 }
 
+
+TEST(TestSharedSection, SharedLockWhileExclusive)
+{
+  CSharedSection sec;
+
+  CExclusiveLock l1(sec);
+  CExclusiveLock l2(sec); // recursive
+  CSharedLock l3(sec);    // the owner may read as well
+
+  l3.Leave();
+  l2.Leave();
+  EXPECT_TRUE(l1.IsOwner());
+}
+
+TEST(TestSharedSection, TryLock)
+{
+  CSharedSection sec;
+  std::atomic<long> mutex(0L);
+  CEvent event;
+
+  {
+    // a shared lock blocks writers but not other readers
+    locker<CSharedLock> l1(sec,&mutex,&event);
+    thread waitThread1(l1);
+    EXPECT_TRUE(waitForWaiters(event,1,10000));
+
+    EXPECT_FALSE(sec.try_lock());
+    EXPECT_TRUE(sec.try_lock_shared());
+    sec.unlock_shared();
+
+    event.Set();
+    EXPECT_TRUE(waitThread1.timed_join(MILLIS(10000)));
+  }
+
+  {
+    // an exclusive lock blocks everyone else
+    locker<CExclusiveLock> l2(sec,&mutex,&event);
+    thread waitThread2(l2);
+    EXPECT_TRUE(waitForWaiters(event,1,10000));
+
+    EXPECT_FALSE(sec.try_lock());
+    EXPECT_FALSE(sec.try_lock_shared());
+
+    event.Set();
+    EXPECT_TRUE(waitThread2.timed_join(MILLIS(10000)));
+  }
+
+  EXPECT_TRUE(sec.try_lock());
+  sec.unlock();
+}
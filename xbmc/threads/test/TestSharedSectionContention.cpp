@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SharedSection.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const int OPERATIONS_PER_THREAD = 200000;
+
+// The previous CSharedSection, every shared lock goes through one mutex
+class CMutexSharedSection
+{
+  CCriticalSection sec;
+  XbmcThreads::ConditionVariable actualCv;
+  XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
+
+  unsigned int sharedCount;
+
+public:
+  inline CMutexSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+
+  inline void lock() { CSingleLock l(sec); while (sharedCount) cond.wait(l); sec.lock(); }
+  inline void unlock() { sec.unlock(); }
+
+  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
+  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+};
+
+template<class S> class ReadGuard
+{
+  S& section;
+public:
+  inline explicit ReadGuard(S& s) : section(s) { section.lock_shared(); }
+  inline ~ReadGuard() { section.unlock_shared(); }
+};
+
+template<class S> class WriteGuard
+{
+  S& section;
+public:
+  inline explicit WriteGuard(S& s) : section(s) { section.lock(); }
+  inline ~WriteGuard() { section.unlock(); }
+};
+
+// Each thread reads a shared value, and every writeInterval-th operation
+// updates it. Returns operations per second over all threads.
+template<class Section>
+double RunContention(Section& section, int threads, int writeInterval)
+{
+  std::atomic<int> ready(0);
+  std::atomic<bool> go(false);
+  volatile int value = 0;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++)
+  {
+    workers.emplace_back([&]()
+    {
+      ++ready;
+      while (!go)
+        std::this_thread::yield();
+
+      int sum = 0;
+      for (int i = 1; i <= OPERATIONS_PER_THREAD; i++)
+      {
+        if (writeInterval && i % writeInterval == 0)
+        {
+          WriteGuard<Section> lock(section);
+          value = value + 1;
+        }
+        else
+        {
+          ReadGuard<Section> lock(section);
+          sum += value;
+        }
+      }
+      (void)sum;
+    });
+  }
+
+  while (ready < threads)
+    std::this_thread::yield();
+
+  auto start = std::chrono::steady_clock::now();
+  go = true;
+  for (auto& worker : workers)
+    worker.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  return threads * OPERATIONS_PER_THREAD / seconds;
+}
+}
+
+TEST(TestSharedSectionContention, ReadersAndWriters)
+{
+  // every write has to see all reads before it and vice versa
+  CSharedSection sec;
+  int value = 0;
+  std::atomic<int> readersInside(0);
+  std::atomic<bool> failed(false);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; t++)
+  {
+    workers.emplace_back([&, t]()
+    {
+      for (int i = 0; i < 20000; i++)
+      {
+        if ((i + t) % 16 == 0)
+        {
+          CExclusiveLock lock(sec);
+          if (readersInside != 0)
+            failed = true;
+          value++;
+        }
+        else
+        {
+          CSharedLock lock(sec);
+          ++readersInside;
+          volatile int v = value;
+          (void)v;
+          --readersInside;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(4 * 20000 / 16, value);
+}
+
+/* Not a functional test, run with --gtest_also_run_disabled_tests */
+TEST(TestSharedSectionContention, DISABLED_Benchmark)
+{
+  static const int threadCounts[] = { 1, 2, 4, 8 };
+  // 0 means read only
+  static const int writeIntervals[] = { 0, 1000, 100, 10 };
+
+  for (int writeInterval : writeIntervals)
+  {
+    for (int threads : threadCounts)
+    {
+      CSharedSection shared;
+      CMutexSharedSection mutexShared;
+      double sharedOps = RunContention(shared, threads, writeInterval);
+      double mutexOps = RunContention(mutexShared, threads, writeInterval);
+      // the numbers end up in the report written by --gtest_output=xml
+      const std::string prefix = StringUtils::Format("threads_%d_write_interval_%d", threads, writeInterval);
+      RecordProperty(prefix + "_striped_ops_per_second", static_cast<int>(sharedOps));
+      RecordProperty(prefix + "_single_mutex_ops_per_second", static_cast<int>(mutexOps));
+    }
+  }
+}
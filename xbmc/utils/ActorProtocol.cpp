@@ -19,9 +19,48 @@
  */
 
 #include "ActorProtocol.h"
+#include "utils/log.h"
 
 using namespace Actor;
 
+#define MSG_ARENA_NONE 0xFFFFFFFFu
+
+Message::Message()
+  : isSync(false)
+  , data(NULL)
+  , replyMessage(NULL)
+  , event(NULL)
+  , heapBuffer(NULL)
+  , heapBufferSize(0)
+  , arenaIndex(-1)
+  , nextFree(MSG_ARENA_NONE)
+{
+}
+
+Message::~Message()
+{
+  delete [] heapBuffer;
+}
+
+void Message::SetPayload(const void *payload, int size)
+{
+  if (size > MSG_INTERNAL_BUFFER_SIZE)
+  {
+    if (size > heapBufferSize)
+    {
+      delete [] heapBuffer;
+      heapBuffer = new uint8_t[size];
+      heapBufferSize = size;
+      origin->fallbackAllocations++;
+    }
+    data = heapBuffer;
+  }
+  else
+    data = buffer;
+  memcpy(data, payload, size);
+  payloadSize = size;
+}
+
 void Message::Release()
 {
   bool skip;
@@ -33,14 +72,6 @@ void Message::Release()
   if (skip)
     return;
 
-  // free data buffer
-  if (data != buffer)
-    delete [] data;
-
-  // delete event in case of sync message
-  if (event)
-    delete event;
-
   origin->ReturnMessage(this);
 }
 
@@ -63,13 +94,7 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
     msg->isOut = !isOut;
     replyMessage = msg;
     if (data)
-    {
-      if (size > MSG_INTERNAL_BUFFER_SIZE)
-        msg->data = new uint8_t[size];
-      else
-        msg->data = msg->buffer;
-      memcpy(msg->data, data, size);
-    }
+      msg->SetPayload(data, size);
   }
 
   origin->Unlock();
@@ -80,31 +105,80 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
   return true;
 }
 
+Protocol::Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
+  : portName(name)
+  , containerInEvent(inEvent)
+  , containerOutEvent(outEvent)
+  , inDefered(false)
+  , outDefered(false)
+  , messagesInFlight(0)
+  , fallbackAllocations(0)
+{
+  arena = new Message[MSG_ARENA_SIZE];
+  for (int i = 0; i < MSG_ARENA_SIZE; i++)
+  {
+    arena[i].arenaIndex = i;
+    arena[i].origin = this;
+    arena[i].nextFree = (i + 1 < MSG_ARENA_SIZE) ? i + 1 : MSG_ARENA_NONE;
+  }
+  freeHead = 0;
+}
+
 Protocol::~Protocol()
 {
-  Message *msg;
+  // drain the queues even if they are deferred, queued messages count as
+  // in flight as well
+  inDefered = outDefered = false;
   Purge();
-  while (!freeMessageQueue.empty())
+
+  // someone still holds a message of this port and is going to release it
+  // later. Freeing the arena now would turn that into a use after free, so
+  // rather leak it.
+  if (messagesInFlight > 0)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-    delete msg;
+    CLog::Log(LOGERROR, "Protocol::%s - %s destroyed with %d messages in flight",
+              __FUNCTION__, portName.c_str(), messagesInFlight.load());
+    return;
   }
+  delete [] arena;
 }
 
-Message *Protocol::GetMessage()
+Message *Protocol::PopFreeMessage()
 {
-  Message *msg;
+  uint64_t head = freeHead.load(std::memory_order_acquire);
+  for (;;)
+  {
+    uint32_t index = static_cast<uint32_t>(head);
+    if (index == MSG_ARENA_NONE)
+      return NULL;
+
+    uint32_t next = arena[index].nextFree.load(std::memory_order_relaxed);
+    uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+    if (freeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+      return &arena[index];
+  }
+}
 
-  CSingleLock lock(criticalSection);
+void Protocol::PushFreeMessage(Message *msg)
+{
+  uint64_t head = freeHead.load(std::memory_order_relaxed);
+  uint64_t newHead;
+  do
+  {
+    msg->nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    newHead = (((head >> 32) + 1) << 32) | static_cast<uint32_t>(msg->arenaIndex);
+  } while (!freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
 
-  if (!freeMessageQueue.empty())
+Message *Protocol::GetMessage()
+{
+  Message *msg = PopFreeMessage();
+  if (!msg)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-  }
-  else
+    // arena exhausted, this one is deleted again when returned
     msg = new Message();
+    fallbackAllocations++;
+  }
 
   msg->isSync = false;
   msg->isSyncFini = false;
@@ -115,14 +189,19 @@ Message *Protocol::GetMessage()
   msg->replyMessage = NULL;
   msg->origin = this;
 
+  messagesInFlight++;
+
   return msg;
 }
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
+  messagesInFlight--;
 
-  freeMessageQueue.push(msg);
+  if (msg->arenaIndex < 0)
+    delete msg;
+  else
+    PushFreeMessage(msg);
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -137,13 +216,7 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = true;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
   { CSingleLock lock(criticalSection);
     outMessages.push(msg);
@@ -165,13 +238,7 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
   msg->isOut = false;
 
   if (data)
-  {
-    if (size > MSG_INTERNAL_BUFFER_SIZE)
-      msg->data = new uint8_t[size];
-    else
-      msg->data = msg->buffer;
-    memcpy(msg->data, data, size);
-  }
+    msg->SetPayload(data, size);
 
   { CSingleLock lock(criticalSection);
     inMessages.push(msg);
@@ -187,7 +254,7 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  msg->event = &msg->syncEvent;
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
@@ -265,6 +332,8 @@ void Protocol::PurgeIn(int signal)
     inMessages.pop();
     if (msg->signal != signal)
       msgs.push(msg);
+    else
+      msg->Release();
   }
   while (!msgs.empty())
   {
@@ -287,6 +356,8 @@ void Protocol::PurgeOut(int signal)
     outMessages.pop();
     if (msg->signal != signal)
       msgs.push(msg);
+    else
+      msg->Release();
   }
   while (!msgs.empty())
   {
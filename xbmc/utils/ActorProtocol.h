@@ -21,10 +21,15 @@
 #pragma once
 
 #include "threads/Thread.h"
+#include <atomic>
 #include <queue>
+#include <stdint.h>
 #include "memory.h"
 
-#define MSG_INTERNAL_BUFFER_SIZE 32
+// payloads up to this size are stored inside the message
+#define MSG_INTERNAL_BUFFER_SIZE 64
+// number of messages preallocated by each protocol
+#define MSG_ARENA_SIZE 64
 
 namespace Actor
 {
@@ -51,14 +56,25 @@ public:
   bool Reply(int sig, void *data = NULL, int size = 0);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message();
+  ~Message();
+  void SetPayload(const void *payload, int size);
+
+  // larger payloads go here, the buffer is kept when the message is recycled
+  uint8_t *heapBuffer;
+  int heapBufferSize;
+  // signalled on reply of sync messages
+  CEvent syncEvent;
+  // position in the arena of the protocol or -1 if allocated on the heap
+  int arenaIndex;
+  std::atomic<uint32_t> nextFree;
 };
 
 class Protocol
 {
+  friend class Message;
 public:
-  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    : portName(name), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
+  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent);
   virtual ~Protocol();
   Message *GetMessage();
   void ReturnMessage(Message *msg);
@@ -74,15 +90,33 @@ public:
   void DeferOut(bool value) {outDefered = value;};
   void Lock() {criticalSection.lock();};
   void Unlock() {criticalSection.unlock();};
+  /*!
+   * \brief Number of messages taken by GetMessage and not released yet
+   */
+  int GetMessagesInFlight() const { return messagesInFlight; }
+  /*!
+   * \brief Number of heap allocations done because the arena was exhausted
+   * or a payload did not fit into the recycled buffers
+   */
+  uint64_t GetFallbackAllocations() const { return fallbackAllocations; }
   std::string portName;
 
 protected:
+  Message *PopFreeMessage();
+  void PushFreeMessage(Message *msg);
+
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
   std::queue<Message*> outMessages;
   std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
   bool inDefered, outDefered;
+
+  // preallocated messages, free ones are linked by index in a lock-free
+  // stack. The upper half of freeHead is a tag against ABA.
+  Message *arena;
+  std::atomic<uint64_t> freeHead;
+  std::atomic<int> messagesInFlight;
+  std::atomic<uint64_t> fallbackAllocations;
 };
 
 }
@@ -289,6 +289,9 @@ public:
   template<class INPUT,class OUTPUT>
   static bool convert(iconv_t type, int multiplier, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
 
+  template<class OUTPUT>
+  static bool fastUtf8ToUtf32(const std::string& strSource, OUTPUT& strDest);
+
   static CConverterType m_stdConversion[NumberOfStdConversionTypes];
   static CCriticalSection m_critSectionFriBiDi;
 };
@@ -475,6 +478,24 @@ bool CCharsetConverter::CInnerConverter::convert(iconv_t type, int multiplier, c
   return true;
 }
 
+/* Valid UTF-8 converts the same with and without iconv, so skip iconv and the
+   converter lock for it. Anything else is left to iconv which knows how to
+   skip or reject invalid sequences. */
+template<class OUTPUT>
+bool CCharsetConverter::CInnerConverter::fastUtf8ToUtf32(const std::string& strSource, OUTPUT& strDest)
+{
+  if (!CUtf8Utils::ConvertToUtf32(strSource, strDest))
+    return false;
+
+#if defined(TARGET_DARWIN)
+  // UTF-8-MAC composes decomposed characters, leave anything but ASCII to iconv
+  if (strDest.length() != strSource.length())
+    return false;
+#endif
+
+  return true;
+}
+
 bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(const std::u32string& stringSrc, std::u32string& stringDst, FriBidiCharType base /*= FRIBIDI_TYPE_LTR*/, const bool failOnBadString /*= false*/)
 {
   stringDst.clear();
@@ -483,6 +504,14 @@ bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(const std::u32strin
   if (srcLen == 0)
     return true;
 
+  // nothing before the Hebrew block is right-to-left or a bidi mark,
+  // fribidi wouldn't change such strings
+  if (std::all_of(stringSrc.begin(), stringSrc.end(), [](char32_t c) { return c < 0x0590; }))
+  {
+    stringDst = stringSrc;
+    return true;
+  }
+
   stringDst.reserve(srcLen);
   size_t lineStart = 0;
 
@@ -646,6 +675,9 @@ void CCharsetConverter::reinitCharsetsFromSettings(void)
 
 bool CCharsetConverter::utf8ToUtf32(const std::string& utf8StringSrc, std::u32string& utf32StringDst, bool failOnBadChar /*= true*/)
 {
+  if (CInnerConverter::fastUtf8ToUtf32(utf8StringSrc, utf32StringDst))
+    return true;
+
   return CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
 }
 
@@ -661,16 +693,19 @@ bool CCharsetConverter::utf8ToUtf32Visual(const std::string& utf8StringSrc, std:
   if (bVisualBiDiFlip)
   {
     std::u32string converted;
-    if (!CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, converted, failOnBadChar))
+    if (!utf8ToUtf32(utf8StringSrc, converted, failOnBadChar))
       return false;
 
     return CInnerConverter::logicalToVisualBiDi(converted, utf32StringDst, forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF, failOnBadChar);
   }
-  return CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32StringDst, failOnBadChar);
+  return utf8ToUtf32(utf8StringSrc, utf32StringDst, failOnBadChar);
 }
 
 bool CCharsetConverter::utf32ToUtf8(const std::u32string& utf32StringSrc, std::string& utf8StringDst, bool failOnBadChar /*= true*/)
 {
+  if (CUtf8Utils::ConvertFromUtf32(utf32StringSrc, utf8StringDst))
+    return true;
+
   return CInnerConverter::stdConvert(Utf32ToUtf8, utf32StringSrc, utf8StringDst, failOnBadChar);
 }
 
@@ -715,15 +750,19 @@ bool CCharsetConverter::utf8ToW(const std::string& utf8StringSrc, std::wstring&
   {
     wStringDst.clear();
     std::u32string utf32str;
-    if (!CInnerConverter::stdConvert(Utf8ToUtf32, utf8StringSrc, utf32str, failOnBadChar))
+    if (!utf8ToUtf32(utf8StringSrc, utf32str, failOnBadChar))
       return false;
 
     std::u32string utf32flipped;
     const bool bidiResult = CInnerConverter::logicalToVisualBiDi(utf32str, utf32flipped, forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF, failOnBadChar);
 
-    return CInnerConverter::stdConvert(Utf32ToW, utf32flipped, wStringDst, failOnBadChar) && bidiResult;
+    return utf32ToW(utf32flipped, wStringDst, failOnBadChar) && bidiResult;
   }
-  
+
+  // fails right away if wchar_t isn't 32 bit
+  if (CInnerConverter::fastUtf8ToUtf32(utf8StringSrc, wStringDst))
+    return true;
+
   return CInnerConverter::stdConvert(Utf8toW, utf8StringSrc, wStringDst, failOnBadChar);
 }
 
@@ -806,6 +845,9 @@ bool CCharsetConverter::unknownToUTF8(const std::string& stringSrc, std::string&
 
 bool CCharsetConverter::wToUTF8(const std::wstring& wStringSrc, std::string& utf8StringDst, bool failOnBadChar /*= false*/)
 {
+  if (CUtf8Utils::ConvertFromUtf32(wStringSrc, utf8StringDst))
+    return true;
+
   return CInnerConverter::stdConvert(WtoUtf8, wStringSrc, utf8StringDst, failOnBadChar);
 }
 
@@ -102,3 +102,113 @@ bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool
   output = stringBuffer.GetString();
   return true;
 }
+
+namespace
+{
+// rapidjson output stream appending to a std::string
+class CStringOutputStream
+{
+public:
+  typedef char Ch;
+
+  explicit CStringOutputStream(std::string &output) : m_output(output) { }
+
+  void Put(Ch c) { m_output.push_back(c); }
+  void Flush() { }
+
+private:
+  std::string &m_output;
+};
+}
+
+class CJSONStreamWriter::IWriter
+{
+public:
+  virtual ~IWriter() = default;
+
+  virtual bool StartObject() = 0;
+  virtual bool EndObject() = 0;
+  virtual bool StartArray() = 0;
+  virtual bool EndArray() = 0;
+  virtual bool Key(const std::string &key) = 0;
+  virtual bool Write(const CVariant &value) = 0;
+  virtual bool IsComplete() const = 0;
+};
+
+template<class TWriter>
+class CJSONStreamWriter::CWriter : public CJSONStreamWriter::IWriter
+{
+public:
+  explicit CWriter(std::string &output)
+    : m_stream(output),
+      m_writer(m_stream)
+  { }
+
+  TWriter& GetWriter() { return m_writer; }
+
+  bool StartObject() override { return m_writer.StartObject(); }
+  bool EndObject() override { return m_writer.EndObject(); }
+  bool StartArray() override { return m_writer.StartArray(); }
+  bool EndArray() override { return m_writer.EndArray(); }
+  bool Key(const std::string &key) override { return m_writer.Key(key.c_str(), key.size()); }
+  bool Write(const CVariant &value) override { return InternalWrite(m_writer, value); }
+  bool IsComplete() const override { return m_writer.IsComplete(); }
+
+private:
+  CStringOutputStream m_stream;
+  TWriter m_writer;
+};
+
+CJSONStreamWriter::CJSONStreamWriter(bool compact)
+{
+  if (compact)
+    m_writer.reset(new CWriter<rapidjson::Writer<CStringOutputStream> >(m_output));
+  else
+  {
+    CWriter<rapidjson::PrettyWriter<CStringOutputStream> > *writer = new CWriter<rapidjson::PrettyWriter<CStringOutputStream> >(m_output);
+    writer->GetWriter().SetIndent('\t', 1);
+    m_writer.reset(writer);
+  }
+}
+
+CJSONStreamWriter::~CJSONStreamWriter() = default;
+
+bool CJSONStreamWriter::StartObject()
+{
+  return m_writer->StartObject();
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return m_writer->EndObject();
+}
+
+bool CJSONStreamWriter::StartArray()
+{
+  return m_writer->StartArray();
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return m_writer->EndArray();
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+  return m_writer->Key(key);
+}
+
+bool CJSONStreamWriter::Write(const CVariant &value)
+{
+  return m_writer->Write(value);
+}
+
+void CJSONStreamWriter::WriteRaw(const std::string &text)
+{
+  m_output.append(text);
+}
+
+bool CJSONStreamWriter::IsComplete() const
+{
+  return m_writer->IsComplete();
+}
@@ -19,6 +19,7 @@
  *
  */
 
+#include <memory>
 #include <string>
 
 class CVariant;
@@ -30,3 +31,44 @@ public:
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
 };
+
+/*!
+ * \brief Incrementally serialises JSON
+ *
+ * Produces the same output as CJSONVariantWriter::Write() but the document
+ * can be written piece by piece so it never has to exist as one CVariant.
+ * Everything written is appended to GetOutput() which the caller can
+ * consume and clear at any time.
+ */
+class CJSONStreamWriter
+{
+public:
+  explicit CJSONStreamWriter(bool compact);
+  ~CJSONStreamWriter();
+
+  bool StartObject();
+  bool EndObject();
+  bool StartArray();
+  bool EndArray();
+  bool Key(const std::string &key);
+  bool Write(const CVariant &value);
+
+  /*!
+   * \brief Appends text verbatim, e.g. a JSONP callback around the document
+   */
+  void WriteRaw(const std::string &text);
+
+  bool IsComplete() const;
+
+  std::string& GetOutput() { return m_output; }
+
+private:
+  CJSONStreamWriter(const CJSONStreamWriter&) = delete;
+  CJSONStreamWriter& operator=(const CJSONStreamWriter&) = delete;
+
+  class IWriter;
+  template<class TWriter> class CWriter;
+
+  std::string m_output;
+  std::unique_ptr<IWriter> m_writer;
+};
@@ -22,8 +22,11 @@
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
+#include "utils/PerformanceTrace.h"
 #ifdef TARGET_POSIX
 #include "linux/XTimeUtils.h"
 #endif
@@ -37,9 +40,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, int slot) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_slot = slot;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -66,6 +70,8 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      // names must outlive the trace, the type string belongs to the job
+      TRACE_SCOPE("jobs", "CJob::DoWork");
       success = job->DoWork();
     }
     catch (...)
@@ -184,6 +190,12 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_workStealing = false;
+  m_maxWorkers = 5;
+  m_slotCount = 0;
+  m_nextSlot = 0;
+  m_slotProcessing = 0;
+  m_thiefWoken = false;
 }
 
 void CJobManager::Restart()
@@ -210,9 +222,38 @@ void CJobManager::CancelJobs()
   // cancel any callbacks on jobs still processing
   for_each(m_processing.begin(), m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
 
+  // same for the worker queues
+  const unsigned int slots = SlotCount();
+  for (unsigned int i = 0; i < slots; ++i)
+  {
+    CWorkerSlot &slot = *m_slots[i];
+    CSingleLock slotLock(slot.m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority < CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      for_each(slot.m_queue[priority].begin(), slot.m_queue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
+      slot.m_queue[priority].clear();
+    }
+    slot.m_queued = 0;
+    for_each(slot.m_processing.begin(), slot.m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+  }
+
   // tell our workers to finish
-  while (m_workers.size())
+  while (true)
   {
+    bool slotWorkers = false;
+    for (unsigned int i = 0; i < slots; ++i)
+    {
+      CWorkerSlot &slot = *m_slots[i];
+      CSingleLock slotLock(slot.m_section);
+      if (slot.m_worker)
+      {
+        slotWorkers = true;
+        slot.m_wakeup.Set();
+      }
+    }
+    if (!slotWorkers && m_workers.empty())
+      break;
+
     lock.Leave();
     m_jobEvent.Set();
     Sleep(0); // yield after setting the event to give the workers some time to die
@@ -224,45 +265,187 @@ CJobManager::~CJobManager()
 {
 }
 
+void CJobManager::OnSettingsLoaded()
+{
+  SetMaxWorkers(g_advancedSettings.m_jobManagerMaxWorkers);
+  SetWorkStealing(g_advancedSettings.m_jobManagerWorkStealing);
+}
+
+void CJobManager::SetWorkStealing(bool enable)
+{
+  if (enable)
+    CreateSlots(m_maxWorkers);
+  m_workStealing = enable;
+}
+
+void CJobManager::SetMaxWorkers(unsigned int maxWorkers)
+{
+  if (maxWorkers == 0)
+    maxWorkers = std::max(4, g_cpuInfo.getCPUCount());
+  if (maxWorkers > MAX_WORKER_SLOTS)
+    maxWorkers = MAX_WORKER_SLOTS;
+
+  if (m_workStealing)
+    CreateSlots(maxWorkers);
+  m_maxWorkers = maxWorkers;
+}
+
+void CJobManager::CreateSlots(unsigned int count)
+{
+  CSingleLock lock(m_section);
+  unsigned int slots = SlotCount();
+  for (; slots < count && slots < MAX_WORKER_SLOTS; ++slots)
+    m_slots[slots].reset(new CWorkerSlot);
+  m_slotCount.store(slots, std::memory_order_release);
+}
+
+unsigned int CJobManager::NextJobId()
+{
+  // ensure 0 (invalid job) is never hit
+  unsigned int id = ++m_jobCounter;
+  while (id == 0)
+    id = ++m_jobCounter;
+  return id;
+}
+
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
+  if (m_workStealing && priority != CJob::PRIORITY_DEDICATED)
+    return AddJobToSlot(job, callback, priority);
+
   CSingleLock lock(m_section);
 
   if (!m_running)
     return 0;
 
-  // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
+  CWorkItem work(job, NextJobId(), priority, callback);
   m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
   return work.m_id;
 }
 
+unsigned int CJobManager::AddJobToSlot(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
+{
+  // held until the job is queued, so CancelJobs can't clear the queues in between
+  CSingleLock managerLock(m_section);
+  if (!m_running)
+    return 0;
+
+  const unsigned int slots = std::min<unsigned int>(m_maxWorkers, SlotCount());
+
+  // jobs queued from a job stay with that worker, others are spread round robin
+  unsigned int target;
+  const CJobWorker *current = dynamic_cast<CJobWorker*>(CThread::GetCurrentThread());
+  if (current && current->GetSlot() >= 0 && static_cast<unsigned int>(current->GetSlot()) < SlotCount())
+    target = current->GetSlot();
+  else
+    target = m_nextSlot++ % slots;
+
+  CWorkItem work(job, NextJobId(), priority, callback);
+  CWorkerSlot &slot = *m_slots[target];
+  bool wakeOwner = false;
+  {
+    CSingleLock lock(slot.m_section);
+    slot.m_queue[priority].push_back(work);
+    ++slot.m_queued;
+    if (!slot.m_worker)
+      slot.m_worker = new CJobWorker(this, target);
+    else
+      wakeOwner = slot.m_idle.exchange(false); // only the first job signals
+  }
+  managerLock.Leave();
+
+  if (wakeOwner)
+    slot.m_wakeup.Set();
+  else
+    WakeIdleWorker(target); // the owner is busy, let someone else steal it
+
+  return work.m_id;
+}
+
+void CJobManager::WakeIdleWorker(unsigned int except)
+{
+  // one woken thief at a time is enough, it keeps stealing until all queues
+  // are empty. Waking one per job just burns context switches.
+  if (m_thiefWoken.exchange(true))
+    return;
+
+  const unsigned int slots = SlotCount();
+  for (unsigned int i = 0; i < slots; ++i)
+  {
+    if (i != except && m_slots[i]->m_idle.exchange(false))
+    {
+      m_slots[i]->m_wakeup.Set();
+      return;
+    }
+  }
+  m_thiefWoken = false;
+}
+
+void CJobManager::WakeQueuedWorker()
+{
+  const unsigned int slots = SlotCount();
+  for (unsigned int i = 0; i < slots; ++i)
+  {
+    CWorkerSlot &slot = *m_slots[i];
+    if (slot.m_queued && slot.m_idle.exchange(false))
+    {
+      slot.m_wakeup.Set();
+      return;
+    }
+  }
+}
+
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
+  {
+    CSingleLock lock(m_section);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
+      if (i != m_jobQueue[priority].end())
+      {
+        delete i->m_job;
+        m_jobQueue[priority].erase(i);
+        return;
+      }
+    }
+    // or if we're processing it
+    Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
+    if (it != m_processing.end())
+    {
+      it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+      return;
+    }
+  }
+
+  const unsigned int slots = SlotCount();
+  for (unsigned int s = 0; s < slots; ++s)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CWorkerSlot &slot = *m_slots[s];
+    CSingleLock lock(slot.m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority < CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue::iterator i = find(slot.m_queue[priority].begin(), slot.m_queue[priority].end(), jobID);
+      if (i != slot.m_queue[priority].end())
+      {
+        delete i->m_job;
+        slot.m_queue[priority].erase(i);
+        --slot.m_queued;
+        return;
+      }
+    }
+    Processing::iterator it = find(slot.m_processing.begin(), slot.m_processing.end(), jobID);
+    if (it != slot.m_processing.end())
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      it->m_callback = NULL;
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -308,6 +491,76 @@ CJob *CJobManager::PopJob()
   return NULL;
 }
 
+CJob *CJobManager::TakeJob(unsigned int slot)
+{
+  const unsigned int slots = SlotCount();
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  {
+    // Check whether we're pausing pausable jobs
+    if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
+      continue;
+
+    const unsigned int maxWorkers = GetMaxWorkers(CJob::PRIORITY(priority));
+    if (!ReserveSlotProcessing(maxWorkers))
+      continue;
+
+    // our own queue first, then steal from the others
+    for (unsigned int i = 0; i < slots; ++i)
+    {
+      CJob *job = PopJobFromSlot(slot, (slot + i) % slots, CJob::PRIORITY(priority));
+      if (job)
+        return job;
+    }
+
+    // nothing to do in this lane. If our reservation filled the lane,
+    // someone may have been turned away meanwhile and gone to sleep.
+    if (m_slotProcessing-- == maxWorkers)
+      WakeQueuedWorker();
+  }
+  return NULL;
+}
+
+bool CJobManager::ReserveSlotProcessing(unsigned int maxWorkers)
+{
+  // check and increment in one step, so workers racing for the last free
+  // place in a lane can't both take it
+  unsigned int processing = m_slotProcessing.load();
+  do
+  {
+    if (processing >= maxWorkers)
+      return false;
+  } while (!m_slotProcessing.compare_exchange_weak(processing, processing + 1));
+  return true;
+}
+
+CJob *CJobManager::PopJobFromSlot(unsigned int slot, unsigned int victim, CJob::PRIORITY priority)
+{
+  CWorkerSlot &own = *m_slots[slot];
+  CWorkerSlot &other = *m_slots[victim];
+  if (other.m_queued == 0)
+    return NULL;
+
+  // lock in slot order so two workers stealing from each other can't deadlock
+  CSingleLock lock1(slot <= victim ? own.m_section : other.m_section);
+  CSingleLock lock2(slot <= victim ? other.m_section : own.m_section);
+
+  JobQueue &queue = other.m_queue[priority];
+  if (queue.empty())
+    return NULL;
+
+  // the owner works through its queue in order, thieves take the newest job
+  CWorkItem job = slot == victim ? queue.front() : queue.back();
+  if (slot == victim)
+    queue.pop_front();
+  else
+    queue.pop_back();
+  --other.m_queued;
+
+  own.m_processing.push_back(job);
+  job.m_job->m_callback = this;
+  return job.m_job;
+}
+
 void CJobManager::PauseJobs()
 {
   CSingleLock lock(m_section);
@@ -332,6 +585,18 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
     if (priority == it->m_priority)
       return true;
   }
+
+  const unsigned int slots = SlotCount();
+  for (unsigned int s = 0; s < slots; ++s)
+  {
+    const CWorkerSlot &slot = *m_slots[s];
+    CSingleLock slotLock(slot.m_section);
+    for (Processing::const_iterator it = slot.m_processing.begin(); it < slot.m_processing.end(); ++it)
+    {
+      if (priority == it->m_priority)
+        return true;
+    }
+  }
   return false;
 }
 
@@ -348,11 +613,26 @@ int CJobManager::IsProcessing(const std::string &type) const
     if (type == std::string(it->m_job->GetType()))
       jobsMatched++;
   }
+
+  const unsigned int slots = SlotCount();
+  for (unsigned int s = 0; s < slots; ++s)
+  {
+    const CWorkerSlot &slot = *m_slots[s];
+    CSingleLock slotLock(slot.m_section);
+    for (Processing::const_iterator it = slot.m_processing.begin(); it < slot.m_processing.end(); ++it)
+    {
+      if (type == std::string(it->m_job->GetType()))
+        jobsMatched++;
+    }
+  }
   return jobsMatched;
 }
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
+  if (worker->GetSlot() >= 0)
+    return GetNextJobFromSlot(worker);
+
   CSingleLock lock(m_section);
   while (m_running)
   {
@@ -377,26 +657,131 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   return NULL;
 }
 
-bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
+CJob *CJobManager::GetNextJobFromSlot(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CWorkerSlot &slot = *m_slots[worker->GetSlot()];
+  while (m_running)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    CJob *job = TakeJob(worker->GetSlot());
+    if (job)
+      return job;
+
+    // announce that we are going to sleep, then look again so a job queued
+    // in between isn't left behind
+    slot.m_idle = true;
+    job = TakeJob(worker->GetSlot());
+    if (job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+      slot.m_idle = false;
+      return job;
+    }
+
+    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
+    bool newJob = slot.m_wakeup.WaitMSec(30000);
+    slot.m_idle = false;
+    m_thiefWoken = false;
+    if (!newJob)
+    {
+      // retire under the slot lock, so AddJobToSlot either sees us gone and
+      // spawns a new worker, or has queued its job before we check
+      CSingleLock lock(slot.m_section);
+      if (slot.QueueEmpty())
+      {
+        slot.m_worker = NULL; // workers auto-delete
+        return NULL;
+      }
+    }
+  }
+
+  // have no jobs
+  RemoveWorker(worker);
+  return NULL;
+}
+
+bool CJobManager::CWorkerSlot::QueueEmpty() const
+{
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority < CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    if (!m_queue[priority].empty())
       return false;
+  }
+  return true;
+}
+
+bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
+{
+  CWorkItem item(NULL, 0, CJob::PRIORITY_LOW, NULL);
+  bool found = false;
+  {
+    CSingleLock lock(m_section);
+    // find the job in the processing queue, and check whether it's cancelled (no callback)
+    Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
+    if (i != m_processing.end())
+    {
+      item = *i;
+      found = true;
+    }
+  }
+
+  const unsigned int slots = SlotCount();
+  for (unsigned int s = 0; !found && s < slots; ++s)
+  {
+    const CWorkerSlot &slot = *m_slots[s];
+    CSingleLock lock(slot.m_section);
+    Processing::const_iterator i = find(slot.m_processing.begin(), slot.m_processing.end(), job);
+    if (i != slot.m_processing.end())
+    {
+      item = *i;
+      found = true;
     }
   }
+
+  // call without holding any lock
+  if (found && item.m_callback)
+  {
+    item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+    return false;
+  }
   return true; // couldn't find the job, or it's been cancelled
 }
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
+  const CJobWorker *worker = dynamic_cast<CJobWorker*>(CThread::GetCurrentThread());
+  if (worker && worker->GetSlot() >= 0)
+  {
+    CWorkerSlot &slot = *m_slots[worker->GetSlot()];
+    CSingleLock lock(slot.m_section);
+    // remove the job from the processing queue
+    Processing::iterator i = find(slot.m_processing.begin(), slot.m_processing.end(), job);
+    if (i != slot.m_processing.end())
+    {
+      // tell any listeners we're done with the job, then delete it
+      CWorkItem item(*i);
+      lock.Leave();
+      try
+      {
+        if (item.m_callback)
+          item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+      }
+      lock.Enter();
+      Processing::iterator j = find(slot.m_processing.begin(), slot.m_processing.end(), job);
+      if (j != slot.m_processing.end())
+        slot.m_processing.erase(j);
+      --m_slotProcessing;
+      lock.Leave();
+      item.FreeJob();
+
+      // an owner may have gone to sleep on a full priority lane
+      WakeQueuedWorker();
+    }
+    return;
+  }
+
   CSingleLock lock(m_section);
   // remove the job from the processing queue
   Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
@@ -425,6 +810,15 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
+  if (worker->GetSlot() >= 0)
+  {
+    CWorkerSlot &slot = *m_slots[worker->GetSlot()];
+    CSingleLock lock(slot.m_section);
+    if (slot.m_worker == worker)
+      slot.m_worker = NULL; // workers auto-delete
+    return;
+  }
+
   CSingleLock lock(m_section);
   // remove our worker
   Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
@@ -432,10 +826,11 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
   if (priority == CJob::PRIORITY_DEDICATED)
     return 10000; // A large number..
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  const unsigned int fewer = CJob::PRIORITY_HIGH - priority;
+  const unsigned int max_workers = m_workStealing ? m_maxWorkers.load() : SHARED_QUEUE_MAX_WORKERS;
+  return max_workers > fewer ? max_workers - fewer : 1;
 }
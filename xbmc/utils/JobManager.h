@@ -19,9 +19,12 @@
  *
  */
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <string>
+#include "settings/lib/ISettingsHandler.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
@@ -31,12 +34,18 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  CJobWorker(CJobManager *manager);
+  /*!
+   \param manager the job manager to take jobs from
+   \param slot index of the queue this worker owns in work-stealing mode, -1 for the shared queue
+   */
+  CJobWorker(CJobManager *manager, int slot = -1);
   virtual ~CJobWorker();
 
   void Process();
+  int GetSlot() const { return m_slot; }
 private:
   CJobManager  *m_jobManager;
+  int           m_slot;
 };
 
 /*!
@@ -172,7 +181,7 @@ private:
 
  \sa CJob and IJobCallback
  */
-class CJobManager
+class CJobManager : public ISettingsHandler
 {
   class CWorkItem
   {
@@ -297,6 +306,37 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Switch between the shared job queue and per-worker queues with work stealing.
+
+   In work-stealing mode every worker owns a queue per priority. New jobs go to the queue of
+   the calling worker (jobs queued by jobs) or are spread over the workers, and idle workers
+   steal from busy ones. Jobs already queued when switching are processed where they are.
+   PRIORITY_DEDICATED jobs always use the shared queue, as they need a worker of their own.
+   \param enable true to use per-worker queues, false for the shared queue (default)
+   \sa SetMaxWorkers()
+   */
+  void SetWorkStealing(bool enable);
+  bool IsWorkStealing() const { return m_workStealing; }
+
+  /*!
+   \brief Set the number of workers available to non-dedicated jobs in work-stealing mode.
+
+   Each priority below PRIORITY_HIGH gets one worker less, so higher priority jobs find a
+   free worker even while lower priority jobs keep the others busy. The shared queue keeps
+   its fixed number of workers.
+   \param maxWorkers number of workers, 0 to use the number of CPU cores (at least 4)
+   \sa SetWorkStealing()
+   */
+  void SetMaxWorkers(unsigned int maxWorkers);
+  unsigned int GetMaxWorkers() const { return m_maxWorkers; }
+
+  /*!
+   \brief Applies <jobmanager> of advancedsettings.xml
+   \sa SetWorkStealing(), SetMaxWorkers()
+   */
+  void OnSettingsLoaded() override;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -342,20 +382,64 @@ private:
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
-
-  unsigned int m_jobCounter;
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
+  unsigned int NextJobId();
 
   typedef std::deque<CWorkItem>    JobQueue;
   typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
+  /*!
+   \brief Queues and processing list of a single worker in work-stealing mode.
+   Slots are created on demand and live as long as the job manager, the worker
+   owning a slot comes and goes.
+   */
+  class CWorkerSlot
+  {
+  public:
+    CWorkerSlot() : m_worker(NULL), m_queued(0), m_idle(false) {}
+
+    bool QueueEmpty() const;
+
+    CCriticalSection  m_section;
+    JobQueue          m_queue[CJob::PRIORITY_DEDICATED];
+    Processing        m_processing;
+    CJobWorker       *m_worker;
+    std::atomic<unsigned int> m_queued; ///< jobs in m_queue, read without the lock to skip empty slots
+    std::atomic<bool> m_idle;
+    CEvent            m_wakeup;
+  };
+
+  unsigned int AddJobToSlot(CJob *job, IJobCallback *callback, CJob::PRIORITY priority);
+  CJob *GetNextJobFromSlot(const CJobWorker *worker);
+  CJob *TakeJob(unsigned int slot);
+  CJob *PopJobFromSlot(unsigned int slot, unsigned int victim, CJob::PRIORITY priority);
+  bool ReserveSlotProcessing(unsigned int maxWorkers);
+  void WakeIdleWorker(unsigned int except);
+  void WakeQueuedWorker();
+  void CreateSlots(unsigned int count);
+  unsigned int SlotCount() const { return m_slotCount.load(std::memory_order_acquire); }
+
+  std::atomic<unsigned int> m_jobCounter;
+
   JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
+  std::atomic<bool> m_pauseJobs;
   Processing m_processing;
   Workers    m_workers;
 
   CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
+
+  std::atomic<bool>         m_workStealing;
+  std::atomic<unsigned int> m_maxWorkers; ///< work-stealing mode only
+
+  static const unsigned int SHARED_QUEUE_MAX_WORKERS = 5;
+
+  static const unsigned int MAX_WORKER_SLOTS = 64;
+  std::unique_ptr<CWorkerSlot> m_slots[MAX_WORKER_SLOTS];
+  std::atomic<unsigned int> m_slotCount;
+  std::atomic<unsigned int> m_nextSlot;
+  std::atomic<unsigned int> m_slotProcessing;
+  std::atomic<bool> m_thiefWoken;
 };
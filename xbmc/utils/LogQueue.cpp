@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LogQueue.h"
+
+// Bounded MPMC queue after Dmitry Vyukov: every cell carries a sequence
+// number telling producers and consumers whose turn it is, so the only
+// shared writes are the two position counters.
+
+CLogQueue::CLogQueue(size_t capacity, size_t lineReserve)
+{
+  size_t size = 2;
+  while (size < capacity)
+    size <<= 1;
+
+  m_cells.reset(new Cell[size]);
+  m_mask = size - 1;
+  for (size_t i = 0; i < size; ++i)
+  {
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    m_cells[i].entry.line.reserve(lineReserve);
+  }
+  m_enqueuePos.store(0, std::memory_order_relaxed);
+  m_dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+CLogQueue::~CLogQueue() = default;
+
+bool CLogQueue::TryPush(Entry& entry)
+{
+  Cell* cell;
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    cell = &m_cells[pos & m_mask];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0)
+    {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return false; // full
+    else
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+  }
+
+  Entry& slot = cell->entry;
+  slot.level = entry.level;
+  slot.threadId = entry.threadId;
+  slot.hour = entry.hour;
+  slot.minute = entry.minute;
+  slot.second = entry.second;
+  slot.millisecond = entry.millisecond;
+  slot.line.swap(entry.line);
+
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool CLogQueue::TryPop(Entry& entry)
+{
+  Cell* cell;
+  size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    cell = &m_cells[pos & m_mask];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0)
+    {
+      if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return false; // empty
+    else
+      pos = m_dequeuePos.load(std::memory_order_relaxed);
+  }
+
+  const Entry& slot = cell->entry;
+  entry.level = slot.level;
+  entry.threadId = slot.threadId;
+  entry.hour = slot.hour;
+  entry.minute = slot.minute;
+  entry.second = slot.second;
+  entry.millisecond = slot.millisecond;
+  entry.line.clear();
+  entry.line.swap(cell->entry.line);
+
+  cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+  return true;
+}
+
+bool CLogQueue::IsEmpty() const
+{
+  return m_enqueuePos.load(std::memory_order_acquire) == m_dequeuePos.load(std::memory_order_acquire);
+}
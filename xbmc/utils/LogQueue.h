@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Bounded lock-free multi-producer queue of log lines
+ *
+ * Producers hand over their line by swapping strings with a preallocated
+ * slot, so once every slot has grown to a typical line length neither
+ * pushing nor popping allocates. Push never blocks; it fails when the queue
+ * is full and the caller decides whether to retry or drop the line.
+ */
+class CLogQueue
+{
+public:
+  struct Entry
+  {
+    int level = 0;
+    uint64_t threadId = 0;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    int millisecond = 0;
+    std::string line;
+  };
+
+  /*!
+   * \param capacity number of slots, rounded up to the next power of two
+   * \param lineReserve number of bytes reserved up front for every slot
+   */
+  explicit CLogQueue(size_t capacity, size_t lineReserve = 256);
+  ~CLogQueue();
+
+  /*!
+   * \brief Move a line into the queue
+   * On success \p entry.line receives the (empty) buffer of the slot and
+   * can be reused by the caller for the next line.
+   * \return false if the queue is full, \p entry is left untouched then
+   */
+  bool TryPush(Entry& entry);
+
+  /*!
+   * \brief Take the oldest line out of the queue
+   * The previous content of \p entry.line is discarded, its buffer is handed
+   * back to the slot.
+   * \return false if the queue is empty
+   */
+  bool TryPop(Entry& entry);
+
+  bool IsEmpty() const;
+  size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+  CLogQueue(const CLogQueue&) = delete;
+  CLogQueue& operator=(const CLogQueue&) = delete;
+
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    Entry entry;
+  };
+
+  std::unique_ptr<Cell[]> m_cells;
+  size_t m_mask;
+
+  // keep producer and consumer positions on separate cache lines
+  char m_pad0[64];
+  std::atomic<size_t> m_enqueuePos;
+  char m_pad1[64];
+  std::atomic<size_t> m_dequeuePos;
+  char m_pad2[64];
+};
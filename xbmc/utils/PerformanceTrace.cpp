@@ -0,0 +1,227 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PerformanceTrace.h"
+
+#include <algorithm>
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/Variant.h"
+
+// keep the buffers of this many finished threads, job workers come and go
+#define MAX_RETIRED_BUFFERS 16
+
+/*!
+ * \brief Owned by a thread_local, marks the buffer retired when its thread exits
+ */
+class CPerformanceTrace::CThreadBufferHolder
+{
+public:
+  ~CThreadBufferHolder()
+  {
+    if (m_buffer)
+      m_buffer->m_retired = true;
+  }
+
+  std::shared_ptr<CThreadBuffer> m_buffer;
+};
+
+CPerformanceTrace::CThreadBuffer::CThreadBuffer()
+  : m_written(0)
+  , m_cleared(0)
+  , m_retired(false)
+  , m_threadId(0)
+{
+}
+
+CPerformanceTrace& CPerformanceTrace::GetInstance()
+{
+  static CPerformanceTrace instance;
+  return instance;
+}
+
+CPerformanceTrace::CPerformanceTrace()
+  : m_enabled(false)
+  , m_frequency(CurrentHostFrequency())
+{
+}
+
+void CPerformanceTrace::Start()
+{
+  CLog::Log(LOGNOTICE, "CPerformanceTrace: tracing started");
+  m_enabled = true;
+}
+
+void CPerformanceTrace::Stop()
+{
+  m_enabled = false;
+  CLog::Log(LOGNOTICE, "CPerformanceTrace: tracing stopped");
+}
+
+CPerformanceTrace::CThreadBuffer* CPerformanceTrace::GetThreadBuffer()
+{
+  static thread_local CThreadBufferHolder holder;
+  if (holder.m_buffer)
+    return holder.m_buffer.get();
+
+  std::shared_ptr<CThreadBuffer> buffer(new CThreadBuffer);
+  buffer->m_threadId = static_cast<uint64_t>(CThread::GetCurrentThreadId());
+  CThread* thread = CThread::GetCurrentThread();
+  if (thread)
+    buffer->m_threadName = thread->GetName();
+
+  CSingleLock lock(m_section);
+  // forget the oldest finished threads
+  size_t retired = std::count_if(m_buffers.begin(), m_buffers.end(),
+                                 [](const std::shared_ptr<CThreadBuffer>& b) { return b->m_retired.load(); });
+  for (auto it = m_buffers.begin(); retired >= MAX_RETIRED_BUFFERS && it != m_buffers.end();)
+  {
+    if ((*it)->m_retired)
+    {
+      it = m_buffers.erase(it);
+      retired--;
+    }
+    else
+      ++it;
+  }
+  m_buffers.push_back(buffer);
+  holder.m_buffer = buffer;
+  return buffer.get();
+}
+
+void CPerformanceTrace::AddEvent(const char* category, const char* name, int64_t start, int64_t end)
+{
+  CThreadBuffer* buffer = GetThreadBuffer();
+  // only this thread writes, readers check m_written before and after copying
+  const uint64_t written = buffer->m_written.load(std::memory_order_relaxed);
+  Event& event = buffer->m_events[written % EVENTS_PER_THREAD];
+  event.category = category;
+  event.name = name;
+  event.start = start;
+  event.end = end;
+  buffer->m_written.store(written + 1, std::memory_order_release);
+}
+
+void CPerformanceTrace::Clear()
+{
+  CSingleLock lock(m_section);
+  for (auto it = m_buffers.begin(); it != m_buffers.end();)
+  {
+    if ((*it)->m_retired)
+      it = m_buffers.erase(it);
+    else
+      ++it;
+  }
+  // the owning threads keep writing, so just move the start of what is dumped
+  for (auto& buffer : m_buffers)
+    buffer->m_cleared = buffer->m_written.load(std::memory_order_acquire);
+}
+
+std::string CPerformanceTrace::GetTraceJSON()
+{
+  std::vector<std::shared_ptr<CThreadBuffer> > buffers;
+  {
+    CSingleLock lock(m_section);
+    buffers = m_buffers;
+  }
+
+  // timestamps and durations are microseconds
+  const double scale = 1000000.0 / m_frequency;
+
+  // names come from anywhere in the code base, the writer escapes them
+  CJSONStreamWriter writer(true);
+  auto member = [&writer](const char* key, const CVariant& value)
+  {
+    writer.Key(key);
+    writer.Write(value);
+  };
+
+  writer.StartObject();
+  member("displayTimeUnit", "ms");
+  writer.Key("traceEvents");
+  writer.StartArray();
+
+  std::vector<Event> events;
+  for (const auto& buffer : buffers)
+  {
+    const uint64_t end = buffer->m_written.load(std::memory_order_acquire);
+    uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+    begin = std::max(begin, buffer->m_cleared.load());
+
+    events.clear();
+    for (uint64_t i = begin; i < end; ++i)
+      events.push_back(buffer->m_events[i % EVENTS_PER_THREAD]);
+
+    // the thread may have wrapped around while we copied, drop what it overwrote
+    const uint64_t written = buffer->m_written.load(std::memory_order_acquire);
+    size_t overwritten = 0;
+    if (written > EVENTS_PER_THREAD && written - EVENTS_PER_THREAD > begin)
+      overwritten = static_cast<size_t>(std::min<uint64_t>(written - EVENTS_PER_THREAD - begin, events.size()));
+
+    writer.StartObject();
+    member("name", "thread_name");
+    member("ph", "M");
+    member("pid", 1);
+    member("tid", buffer->m_threadId);
+    writer.Key("args");
+    writer.StartObject();
+    member("name", buffer->m_threadName.empty() ? "unknown" : buffer->m_threadName);
+    writer.EndObject();
+    writer.EndObject();
+
+    for (size_t i = overwritten; i < events.size(); ++i)
+    {
+      const Event& event = events[i];
+      writer.StartObject();
+      member("name", event.name);
+      member("cat", event.category);
+      member("ph", "X");
+      member("pid", 1);
+      member("tid", buffer->m_threadId);
+      member("ts", event.start * scale);
+      member("dur", (event.end - event.start) * scale);
+      writer.EndObject();
+    }
+  }
+
+  writer.EndArray();
+  writer.EndObject();
+  return std::move(writer.GetOutput());
+}
+
+bool CPerformanceTrace::Dump(const std::string& path)
+{
+  const std::string file = path.empty() ? "special://temp/kodi-trace.json" : path;
+  const std::string json = GetTraceJSON();
+
+  XFILE::CFile out;
+  if (!out.OpenForWrite(file, true) ||
+      out.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CPerformanceTrace: failed to write %s", file.c_str());
+    return false;
+  }
+  CLog::Log(LOGNOTICE, "CPerformanceTrace: wrote %s", file.c_str());
+  return true;
+}
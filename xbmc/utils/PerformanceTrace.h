@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+#ifndef NO_PERFORMANCE_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(category, name) CTraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRACE_FUNCTION(category) TRACE_SCOPE(category, __FUNCTION__)
+#else
+#define TRACE_SCOPE(category, name)
+#define TRACE_FUNCTION(category)
+#endif
+
+/*!
+ * \brief Records timed scopes of hot code paths and writes them as Chrome trace events
+ *
+ * Every thread records into a ring buffer of its own, so a scope costs two
+ * clock reads and a few stores while tracing and a single load otherwise.
+ * The buffers of finished threads are kept for dumping, but only the 16 most
+ * recent ones, and Clear() drops them. Open the written file in
+ * chrome://tracing or ui.perfetto.dev.
+ *
+ * Names and categories are not copied and must be string literals.
+ */
+class CPerformanceTrace
+{
+public:
+  static CPerformanceTrace& GetInstance();
+
+  void Start();
+  void Stop();
+  bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Write all events recorded so far to a trace event JSON file
+   * \param path file to write, defaults to special://temp/kodi-trace.json
+   * \return true if the file was written
+   */
+  bool Dump(const std::string& path = "");
+
+  /*!
+   * \brief Serialize the recorded events into trace event JSON
+   */
+  std::string GetTraceJSON();
+
+  /*!
+   * \brief Drop all recorded events
+   */
+  void Clear();
+
+  /*!
+   * \brief Record a finished scope, used by CTraceScope
+   * \param start,end timestamps from CurrentHostCounter()
+   */
+  void AddEvent(const char* category, const char* name, int64_t start, int64_t end);
+
+  static const unsigned int EVENTS_PER_THREAD = 16384;
+
+private:
+  CPerformanceTrace();
+  CPerformanceTrace(const CPerformanceTrace&) = delete;
+  CPerformanceTrace& operator=(const CPerformanceTrace&) = delete;
+
+  struct Event
+  {
+    const char* category;
+    const char* name;
+    int64_t start;
+    int64_t end;
+  };
+
+  class CThreadBuffer
+  {
+  public:
+    CThreadBuffer();
+
+    Event m_events[EVENTS_PER_THREAD];
+    std::atomic<uint64_t> m_written; ///< events ever written, the ring position is m_written % EVENTS_PER_THREAD
+    std::atomic<uint64_t> m_cleared; ///< value of m_written at the last Clear()
+    std::atomic<bool> m_retired;     ///< the thread is gone
+    uint64_t m_threadId;
+    std::string m_threadName;
+  };
+
+  class CThreadBufferHolder;
+
+  CThreadBuffer* GetThreadBuffer();
+
+  std::atomic<bool> m_enabled;
+  CCriticalSection m_section;
+  std::vector<std::shared_ptr<CThreadBuffer> > m_buffers;
+  int64_t m_frequency;
+};
+
+/*!
+ * \brief Records the time between construction and destruction while tracing is enabled
+ */
+class CTraceScope
+{
+public:
+  inline CTraceScope(const char* category, const char* name)
+    : m_category(category)
+    , m_name(name)
+    , m_start(CPerformanceTrace::GetInstance().IsEnabled() ? CurrentHostCounter() : 0)
+  {
+  }
+
+  inline ~CTraceScope()
+  {
+    if (m_start)
+      CPerformanceTrace::GetInstance().AddEvent(m_category, m_name, m_start, CurrentHostCounter());
+  }
+
+private:
+  const char* m_category;
+  const char* m_name;
+  int64_t m_start;
+};
@@ -28,6 +28,8 @@
 #include "utils/Variant.h"
 
 #include <algorithm>
+#include <locale>
+#include <thread>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
@@ -416,130 +418,304 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+namespace
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+// sorting only splits the work up once every thread gets at least this many items
+const size_t PARALLEL_SORT_MIN_CHUNK = 8192;
+
+// Everything the comparison looks at, pulled out of the items once so that
+// sorting neither copies strings nor does any lookups in the item maps.
+struct SortKey
+{
+  size_t label;         // offset into CSortKeys::m_labels
+  SortSpecial special;
+  int folder;           // -1 without FieldFolder
+};
+
+/*!
+ \brief Precomputed collation keys of all items to sort
+
+ The labels are stored back to back, lower cased the way
+ StringUtils::AlphaNumericCompare() does it. Every character is paired with
+ its rank in the collation order of the system locale, so comparing two
+ labels needs neither the locale nor any virtual calls.
+ */
+class CSortKeys
+{
+public:
+  CSortKeys(size_t count, bool handleFolder, bool descending)
+    : m_handleFolder(handleFolder),
+      m_descending(descending)
   {
-    result = false;
-    return true;
+    m_keys.reserve(count);
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+  void Add(const SortItem &item, const std::wstring &label)
   {
-    result = true;
-    return true;
+    SortKey key;
+    key.label = m_labels.size();
+    // null terminated like the c_str() AlphaNumericCompare() used to get
+    for (const wchar_t *chr = label.c_str(); *chr != 0; ++chr)
+      m_labels.push_back(*chr >= L'A' && *chr <= L'Z' ? *chr + (L'a' - L'A') : *chr);
+    m_labels.push_back(L'\0');
+
+    key.special = SortSpecialNone;
+    SortItem::const_iterator it = item.find(FieldSortSpecial);
+    if (it != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+      key.special = (SortSpecial)it->second.asInteger();
+
+    key.folder = -1;
+    if ((it = item.find(FieldFolder)) != item.end())
+      key.folder = it->second.asBoolean() ? 1 : 0;
+
+    m_keys.push_back(key);
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  /*!
+   \brief Rank every character once all labels are added
+   \param locale the locale whose collation AlphaNumericCompare() would use
+   */
+  void Collate(const std::locale &locale)
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    const std::collate<wchar_t> &coll = std::use_facet<std::collate<wchar_t> >(locale);
+
+    std::vector<wchar_t> chars(m_labels.begin(), m_labels.end());
+    std::sort(chars.begin(), chars.end());
+    chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+    std::vector<wchar_t> collated(chars);
+    std::stable_sort(collated.begin(), collated.end(), [&coll](wchar_t left, wchar_t right)
     {
-      result = true;
-      return true;
+      return coll.compare(&left, &left + 1, &right, &right + 1) < 0;
+    });
+
+    // characters the locale considers equal share a rank
+    std::vector<uint32_t> ranks(chars.size());
+    uint32_t rank = 0;
+    for (size_t i = 0; i < collated.size(); ++i)
+    {
+      if (i > 0 && coll.compare(&collated[i - 1], &collated[i - 1] + 1, &collated[i], &collated[i] + 1) != 0)
+        rank++;
+      ranks[std::lower_bound(chars.begin(), chars.end(), collated[i]) - chars.begin()] = rank;
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
-  }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
-  {
-    result = false;
-    return true;
+
+    m_ranks.resize(m_labels.size());
+    for (size_t i = 0; i < m_labels.size(); ++i)
+      m_ranks[i] = ranks[std::lower_bound(chars.begin(), chars.end(), m_labels[i]) - chars.begin()];
   }
 
-  if (handleFolder)
+  // same order as the former SorterAscending/SorterDescending and their IgnoreFolders variants
+  bool operator()(uint32_t left, uint32_t right) const
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    const SortKey &keyLeft = m_keys[left];
+    const SortKey &keyRight = m_keys[right];
+
+    // one has a special sort
+    if (keyLeft.special != keyRight.special)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      // left should be sorted on top
+      // or right should be sorted on bottom
+      // => left is sorted above right
+      return keyLeft.special == SortSpecialOnTop || keyRight.special == SortSpecialOnBottom;
     }
-  }
+    // both have either sort on top or sort on bottom -> leave as-is
+    if (keyLeft.special != SortSpecialNone)
+      return false;
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+    if (m_handleFolder && keyLeft.folder >= 0 && keyRight.folder >= 0 && keyLeft.folder != keyRight.folder)
+      return keyLeft.folder == 1;
 
-  return false;
-}
+    const int64_t result = Compare(keyLeft.label, keyRight.label);
+    return m_descending ? result > 0 : result < 0;
+  }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+private:
+  static bool IsDigit(wchar_t chr)
+  {
+    return chr >= L'0' && chr <= L'9';
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  // StringUtils::AlphaNumericCompare() on the precomputed keys
+  int64_t Compare(size_t left, size_t right) const
+  {
+    const wchar_t *labels = m_labels.c_str();
+    while (labels[left] != 0 && labels[right] != 0)
+    {
+      // check if we have a numerical value
+      if (IsDigit(labels[left]) && IsDigit(labels[right]))
+      {
+        // compare only up to 15 digits
+        int64_t numLeft = 0;
+        const size_t endLeft = left + 15;
+        for (; IsDigit(labels[left]) && left < endLeft; left++)
+          numLeft = numLeft * 10 + labels[left] - L'0';
+        int64_t numRight = 0;
+        const size_t endRight = right + 15;
+        for (; IsDigit(labels[right]) && right < endRight; right++)
+          numRight = numRight * 10 + labels[right] - L'0';
+
+        if (numLeft != numRight)
+          return numLeft - numRight;
+        continue;
+      }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+      if (m_ranks[left] != m_ranks[right])
+        return m_ranks[left] < m_ranks[right] ? -1 : 1;
+      left++;
+      right++;
+    }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    if (labels[right] != 0)
+      return -1;
+    if (labels[left] != 0)
+      return 1;
+    return 0;
+  }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
+  std::vector<SortKey> m_keys;
+  std::wstring m_labels;
+  std::vector<uint32_t> m_ranks;
+  bool m_handleFolder;
+  bool m_descending;
+};
+
+// stable sort of the chunks in parallel, followed by parallel rounds of
+// merging neighbouring chunks, same result as std::stable_sort
+template<class COMPARE>
+void ParallelStableSort(std::vector<uint32_t> &indices, COMPARE compare)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  const size_t count = indices.size();
+  const size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+  size_t chunks = 1;
+  while (chunks * 2 <= threads && count / (chunks * 2) >= PARALLEL_SORT_MIN_CHUNK)
+    chunks *= 2;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  if (chunks == 1)
+  {
+    std::stable_sort(indices.begin(), indices.end(), compare);
+    return;
+  }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  auto bound = [&indices, count, chunks](size_t chunk)
+  {
+    return indices.begin() + count * chunk / chunks;
+  };
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  std::vector<std::thread> workers;
+  for (size_t chunk = 1; chunk < chunks; ++chunk)
+  {
+    workers.emplace_back([&bound, &compare, chunk]()
+    {
+      std::stable_sort(bound(chunk), bound(chunk + 1), compare);
+    });
+  }
+  std::stable_sort(bound(0), bound(1), compare);
+  for (auto &worker : workers)
+    worker.join();
+
+  for (size_t width = 1; width < chunks; width *= 2)
+  {
+    workers.clear();
+    for (size_t chunk = 2 * width; chunk < chunks; chunk += 2 * width)
+    {
+      workers.emplace_back([&bound, &compare, chunk, width]()
+      {
+        std::inplace_merge(bound(chunk), bound(chunk + width), bound(chunk + 2 * width), compare);
+      });
+    }
+    std::inplace_merge(bound(0), bound(width), bound(2 * width), compare);
+    for (auto &worker : workers)
+      worker.join();
+  }
 }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
+inline SortItem& GetSortItem(DatabaseResult &item)
 {
-  return SorterAscending(*left, *right);
+  return item;
 }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
+inline SortItem& GetSortItem(SortItemPtr &item)
 {
-  return SorterDescending(*left, *right);
+  return *item;
 }
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
+// number of items at the top of the sorted list that survive the limits
+size_t GetSortedCount(size_t count, int limitEnd, int limitStart)
 {
-  return SorterIgnoreFoldersAscending(*left, *right);
+  // mirrors the way SortUtils::Sort() applies the limits afterwards
+  size_t start = 0;
+  if (limitStart > 0 && (size_t)limitStart < count)
+  {
+    start = limitStart;
+    limitEnd -= limitStart;
+  }
+  if (limitEnd > 0 && (size_t)limitEnd < count - start)
+    return start + limitEnd;
+
+  return count;
 }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
+template<class ITEMS>
+void SortByKeys(SortUtils::SortPreparator preparator, const Fields &sortingFields, SortOrder sortOrder, SortAttribute attributes, ITEMS &items, size_t sortedCount)
 {
-  return SorterIgnoreFoldersDescending(*left, *right);
+  CSortKeys keys(items.size(), (attributes & SortAttributeIgnoreFolders) == 0, sortOrder == SortOrderDescending);
+
+  // Prepare the string used for sorting and store it under FieldSort
+  for (typename ITEMS::iterator it = items.begin(); it != items.end(); ++it)
+  {
+    SortItem &item = GetSortItem(*it);
+
+    // add all fields to the item that are required for sorting if they are currently missing
+    for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+    {
+      if (item.find(*field) == item.end())
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+    }
+
+    // an existing sort label takes precedence
+    SortItem::const_iterator sort = item.find(FieldSort);
+    if (sort != item.end())
+    {
+      keys.Add(item, sort->second.asWideString());
+      continue;
+    }
+
+    std::wstring sortLabel;
+    g_charsetConverter.utf8ToW(preparator(attributes, item), sortLabel, false);
+    keys.Add(item, sortLabel);
+    item.insert(std::pair<Field, CVariant>(FieldSort, CVariant(std::move(sortLabel))));
+  }
+  keys.Collate(g_langInfo.GetSystemLocale());
+
+  // the sort algorithms copy the comparison around, keep that cheap
+  auto compare = [&keys](uint32_t left, uint32_t right) { return keys(left, right); };
+
+  std::vector<uint32_t> indices(items.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = static_cast<uint32_t>(i);
+
+  if (sortedCount < items.size() / 2)
+  {
+    // only the top of the list is kept, ties are broken by position to stay stable
+    std::partial_sort(indices.begin(), indices.begin() + sortedCount, indices.end(),
+      [&compare](uint32_t left, uint32_t right)
+      {
+        if (compare(left, right))
+          return true;
+        if (compare(right, left))
+          return false;
+        return left < right;
+      });
+  }
+  else
+    ParallelStableSort(indices, compare);
+
+  ITEMS sorted;
+  sorted.reserve(items.size());
+  for (std::vector<uint32_t>::const_iterator index = indices.begin(); index != indices.end(); ++index)
+    sorted.push_back(std::move(items[*index]));
+  items.swap(sorted);
+}
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -696,27 +872,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
+      SortByKeys(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, GetSortedCount(items.size(), limitEnd, limitStart));
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -735,27 +891,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
+      SortByKeys(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items, GetSortedCount(items.size(), limitEnd, limitStart));
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -807,22 +943,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
@@ -20,6 +20,323 @@
 
 #include "Utf8Utils.h"
 
+#include <stdint.h>
+#include <wchar.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define UTF8_USE_SSE2 1
+// AVX2 isn't enabled at build time by default, pick it at runtime instead
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UTF8_USE_AVX2 1
+#endif
+#endif
+
+namespace
+{
+#ifdef UTF8_USE_AVX2
+bool HasAvx2()
+{
+  static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+  return avx2;
+}
+
+__attribute__((target("avx2")))
+size_t AsciiBlocksAvx2(const unsigned char* src, size_t len)
+{
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32)
+  {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + pos));
+    if (_mm256_movemask_epi8(block) != 0)
+      break;
+  }
+  return pos;
+}
+
+template<typename T>
+__attribute__((target("avx2")))
+size_t WidenAsciiAvx2(const unsigned char* src, size_t len, T* dst)
+{
+  size_t pos = 0;
+  for (; pos + 32 <= len; pos += 32)
+  {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + pos));
+    if (_mm256_movemask_epi8(block) != 0)
+      break;
+
+    for (size_t i = 0; i < 32; i += 8)
+    {
+      const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + pos + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pos + i), _mm256_cvtepu8_epi32(bytes));
+    }
+  }
+  return pos;
+}
+#endif
+
+#ifdef UTF8_USE_SSE2
+size_t AsciiBlocksSse2(const unsigned char* src, size_t len)
+{
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16)
+  {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+  }
+  return pos;
+}
+
+template<typename T>
+size_t WidenAsciiSse2(const unsigned char* src, size_t len, T* dst)
+{
+  const __m128i zero = _mm_setzero_si128();
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16)
+  {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+    if (_mm_movemask_epi8(block) != 0)
+      break;
+
+    const __m128i low = _mm_unpacklo_epi8(block, zero);
+    const __m128i high = _mm_unpackhi_epi8(block, zero);
+    __m128i* out = reinterpret_cast<__m128i*>(dst + pos);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+  }
+  return pos;
+}
+
+template<typename T>
+size_t NarrowAsciiSse2(const T* src, size_t len, unsigned char* dst)
+{
+  const __m128i nonAscii = _mm_set1_epi32(~0x7F);
+  const __m128i zero = _mm_setzero_si128();
+  size_t pos = 0;
+  for (; pos + 16 <= len; pos += 16)
+  {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + pos);
+    const __m128i a = _mm_loadu_si128(in);
+    const __m128i b = _mm_loadu_si128(in + 1);
+    const __m128i c = _mm_loadu_si128(in + 2);
+    const __m128i d = _mm_loadu_si128(in + 3);
+    const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonAscii), zero)) != 0xFFFF)
+      break;
+
+    const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos), bytes);
+  }
+  return pos;
+}
+#endif
+
+// length of the whole blocks of ASCII at the start of src
+size_t AsciiBlocks(const unsigned char* src, size_t len)
+{
+#if defined(UTF8_USE_AVX2)
+  if (HasAvx2())
+    return AsciiBlocksAvx2(src, len);
+#endif
+#if defined(UTF8_USE_SSE2)
+  return AsciiBlocksSse2(src, len);
+#else
+  return 0;
+#endif
+}
+
+// length of the ASCII run at the start of src
+inline size_t AsciiLength(const unsigned char* src, size_t len)
+{
+  // runs between multi-byte characters are mostly short, only go for
+  // vectors once the run turns out to be longer
+  size_t pos = 0;
+  for (; pos < len && pos < 16; pos++)
+  {
+    if (src[pos] >= 0x80)
+      return pos;
+  }
+
+  pos += AsciiBlocks(src + pos, len - pos);
+  while (pos < len && src[pos] < 0x80)
+    pos++;
+  return pos;
+}
+
+// widens the ASCII run at the start of src, returns its length
+template<typename T>
+size_t WidenAscii(const unsigned char* src, size_t len, T* dst)
+{
+  size_t pos = 0;
+  for (; pos < len && pos < 16; pos++)
+  {
+    if (src[pos] >= 0x80)
+      return pos;
+    dst[pos] = src[pos];
+  }
+
+#if defined(UTF8_USE_AVX2)
+  if (HasAvx2())
+    pos += WidenAsciiAvx2(src + pos, len - pos, dst + pos);
+  else
+#endif
+#if defined(UTF8_USE_SSE2)
+    pos += WidenAsciiSse2(src + pos, len - pos, dst + pos);
+#endif
+  for (; pos < len && src[pos] < 0x80; pos++)
+    dst[pos] = src[pos];
+  return pos;
+}
+
+// narrows the ASCII run at the start of src, returns its length
+template<typename T>
+size_t NarrowAscii(const T* src, size_t len, unsigned char* dst)
+{
+  size_t pos = 0;
+  for (; pos < len && pos < 16; pos++)
+  {
+    if (static_cast<uint32_t>(src[pos]) >= 0x80)
+      return pos;
+    dst[pos] = static_cast<unsigned char>(src[pos]);
+  }
+
+#if defined(UTF8_USE_SSE2)
+  pos += NarrowAsciiSse2(src + pos, len - pos, dst + pos);
+#endif
+  for (; pos < len && static_cast<uint32_t>(src[pos]) < 0x80; pos++)
+    dst[pos] = static_cast<unsigned char>(src[pos]);
+  return pos;
+}
+
+inline bool IsContinuation(unsigned char chr)
+{
+  return (chr & 0xC0) == 0x80;
+}
+
+template<typename STR>
+bool Utf8ToUtf32(const std::string& str, STR& utf32)
+{
+  typedef typename STR::value_type T;
+  static_assert(sizeof(T) == 4, "UTF-32 needs 32 bit characters");
+
+  const unsigned char* const src = reinterpret_cast<const unsigned char*>(str.data());
+  const size_t len = str.length();
+
+  // never more characters than bytes
+  utf32.resize(len);
+  T* const dst = &utf32[0];
+
+  size_t pos = 0;
+  size_t out = 0;
+  while (pos < len)
+  {
+    const unsigned char chr = src[pos];
+    if (chr < 0x80)
+    {
+      const size_t run = WidenAscii(src + pos, len - pos, dst + out);
+      pos += run;
+      out += run;
+      continue;
+    }
+
+    // same ranges as SizeOfUtf8Char(), http://www.unicode.org/versions/Unicode6.2.0/ch03.pdf#G27506
+    uint32_t codepoint;
+    if (chr >= 0xC2 && chr <= 0xDF)
+    {
+      if (pos + 1 >= len || !IsContinuation(src[pos + 1]))
+        return false;
+      codepoint = ((chr & 0x1F) << 6) | (src[pos + 1] & 0x3F);
+      pos += 2;
+    }
+    else if (chr >= 0xE0 && chr <= 0xEF)
+    {
+      if (pos + 2 >= len || !IsContinuation(src[pos + 1]) || !IsContinuation(src[pos + 2]))
+        return false;
+      if ((chr == 0xE0 && src[pos + 1] < 0xA0) ||  // overlong
+          (chr == 0xED && src[pos + 1] > 0x9F))    // surrogates
+        return false;
+      codepoint = ((chr & 0x0F) << 12) | ((src[pos + 1] & 0x3F) << 6) | (src[pos + 2] & 0x3F);
+      pos += 3;
+    }
+    else if (chr >= 0xF0 && chr <= 0xF4)
+    {
+      if (pos + 3 >= len || !IsContinuation(src[pos + 1]) || !IsContinuation(src[pos + 2]) || !IsContinuation(src[pos + 3]))
+        return false;
+      if ((chr == 0xF0 && src[pos + 1] < 0x90) ||  // overlong
+          (chr == 0xF4 && src[pos + 1] > 0x8F))    // beyond U+10FFFF
+        return false;
+      codepoint = ((chr & 0x07) << 18) | ((src[pos + 1] & 0x3F) << 12) | ((src[pos + 2] & 0x3F) << 6) | (src[pos + 3] & 0x3F);
+      pos += 4;
+    }
+    else
+      return false;
+
+    dst[out++] = static_cast<T>(codepoint);
+  }
+
+  utf32.resize(out);
+  return true;
+}
+
+template<typename STR>
+bool Utf32ToUtf8(const STR& utf32, std::string& str)
+{
+  static_assert(sizeof(typename STR::value_type) == 4, "UTF-32 needs 32 bit characters");
+
+  const size_t len = utf32.length();
+
+  // four bytes at most per character
+  str.resize(len * 4);
+  unsigned char* const dst = reinterpret_cast<unsigned char*>(&str[0]);
+
+  size_t pos = 0;
+  size_t out = 0;
+  while (pos < len)
+  {
+    const uint32_t codepoint = static_cast<uint32_t>(utf32[pos]);
+    if (codepoint < 0x80)
+    {
+      const size_t run = NarrowAscii(utf32.data() + pos, len - pos, dst + out);
+      pos += run;
+      out += run;
+      continue;
+    }
+
+    if (codepoint < 0x800)
+    {
+      dst[out++] = static_cast<unsigned char>(0xC0 | (codepoint >> 6));
+      dst[out++] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+      if (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+        return false;
+      dst[out++] = static_cast<unsigned char>(0xE0 | (codepoint >> 12));
+      dst[out++] = static_cast<unsigned char>(0x80 | ((codepoint >> 6) & 0x3F));
+      dst[out++] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint <= 0x10FFFF)
+    {
+      dst[out++] = static_cast<unsigned char>(0xF0 | (codepoint >> 18));
+      dst[out++] = static_cast<unsigned char>(0x80 | ((codepoint >> 12) & 0x3F));
+      dst[out++] = static_cast<unsigned char>(0x80 | ((codepoint >> 6) & 0x3F));
+      dst[out++] = static_cast<unsigned char>(0x80 | (codepoint & 0x3F));
+    }
+    else
+      return false;
+
+    pos++;
+  }
+
+  str.resize(out);
+  return true;
+}
+}
+
 
 CUtf8Utils::utf8CheckResult CUtf8Utils::checkStrForUtf8(const std::string& str)
 {
@@ -30,6 +347,13 @@ CUtf8Utils::utf8CheckResult CUtf8Utils::checkStrForUtf8(const std::string& str)
 
   while (pos < len)
   {
+    // skip over ASCII in blocks
+    if (static_cast<unsigned char>(strC[pos]) < 0x80)
+    {
+      pos += AsciiLength(reinterpret_cast<const unsigned char*>(strC + pos), len - pos);
+      continue;
+    }
+
     const size_t chrLen = SizeOfUtf8Char(strC + pos);
     if (chrLen == 0)
       return hiAscii; // non valid UTF-8 sequence
@@ -47,6 +371,34 @@ CUtf8Utils::utf8CheckResult CUtf8Utils::checkStrForUtf8(const std::string& str)
 
 
 
+bool CUtf8Utils::ConvertToUtf32(const std::string& str, std::u32string& utf32)
+{
+  return Utf8ToUtf32(str, utf32);
+}
+
+bool CUtf8Utils::ConvertToUtf32(const std::string& str, std::wstring& utf32)
+{
+#if WCHAR_MAX > 0xFFFF
+  return Utf8ToUtf32(str, utf32);
+#else
+  return false;
+#endif
+}
+
+bool CUtf8Utils::ConvertFromUtf32(const std::u32string& utf32, std::string& str)
+{
+  return Utf32ToUtf8(utf32, str);
+}
+
+bool CUtf8Utils::ConvertFromUtf32(const std::wstring& utf32, std::string& str)
+{
+#if WCHAR_MAX > 0xFFFF
+  return Utf32ToUtf8(utf32, str);
+#else
+  return false;
+#endif
+}
+
 size_t CUtf8Utils::FindValidUtf8Char(const std::string& str, const size_t startPos /*= 0*/)
 {
   const char* strC = str.c_str();
@@ -102,59 +454,46 @@ inline size_t CUtf8Utils::SizeOfUtf8Char(const char* const str)
   const unsigned char chr = strU[0];
 
   /* this is an implementation of http://www.unicode.org/versions/Unicode6.2.0/ch03.pdf#G27506 */
+  /* dispatch on the lead byte first so the function stays small enough to be inlined into the loops */
+  /* as str is null terminated, every byte is checked only after all bytes before it were continuation bytes */
 
   /* U+0000 - U+007F in UTF-8 */
   if (chr <= 0x7F)
     return 1;
 
-  /* U+0080 - U+07FF in UTF-8 */                    /* binary representation and range */
-  if (chr >= 0xC2 && chr <= 0xDF                    /* C2=1100 0010 - DF=1101 1111 */
-      // as str is null terminated, 
-      && ((strU[1] & 0xC0) == 0x80))  /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 2;  // valid UTF-8 2 bytes sequence
-
-  /* U+0800 - U+0FFF in UTF-8 */
-  if (chr == 0xE0                                   /* E0=1110 0000 */
-      && (strU[1] & 0xE0) == 0xA0     /* E0=1110 0000, A0=1010 0000 - BF=1011 1111 */
-      && (strU[2] & 0xC0) == 0x80)    /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 3; // valid UTF-8 3 bytes sequence
-
-  /* U+1000 - U+CFFF in UTF-8 */
-  /* skip U+D000 - U+DFFF (handled later) */
-  /* U+E000 - U+FFFF in UTF-8 */
-  if (((chr >= 0xE1 && chr <= 0xEC)                 /* E1=1110 0001 - EC=1110 1100 */
-        || chr == 0xEE || chr == 0xEF)              /* EE=1110 1110 - EF=1110 1111 */
-        && (strU[1] & 0xC0) == 0x80   /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-        && (strU[2] & 0xC0) == 0x80)  /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 3; // valid UTF-8 3 bytes sequence
-
-  /* U+D000 - U+D7FF in UTF-8 */
-  /* note: range U+D800 - U+DFFF is reserved and invalid */
-  if (chr == 0xED                                   /* ED=1110 1101 */
-      && (strU[1] & 0xE0) == 0x80     /* E0=1110 0000, 80=1000 0000 - 9F=1001 1111 */
-      && (strU[2] & 0xC0) == 0x80)    /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 3; // valid UTF-8 3 bytes sequence
-
-  /* U+10000 - U+3FFFF in UTF-8 */
-  if (chr == 0xF0                                   /* F0=1111 0000 */
-      && (strU[1] & 0xE0) == 0x80     /* E0=1110 0000, 80=1000 0000 - 9F=1001 1111 */
-      && strU[2] >= 0x90 && strU[2] <= 0xBF         /* 90=1001 0000 - BF=1011 1111 */
-      && (strU[3] & 0xC0) == 0x80)    /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 4; // valid UTF-8 4 bytes sequence
-
-  /* U+40000 - U+FFFFF in UTF-8 */
-  if (chr >= 0xF1 && chr <= 0xF3                    /* F1=1111 0001 - F3=1111 0011 */
-      && (strU[1] & 0xC0) == 0x80     /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-      && (strU[2] & 0xC0) == 0x80     /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-      && (strU[3] & 0xC0) == 0x80)    /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 4; // valid UTF-8 4 bytes sequence
-
-  /* U+100000 - U+10FFFF in UTF-8 */
-  if (chr == 0xF4                                   /* F4=1111 0100 */
-      && (strU[1] & 0xF0) == 0x80     /* F0=1111 0000, 80=1000 0000 - 8F=1000 1111 */
-      && (strU[2] & 0xC0) == 0x80     /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-      && (strU[3] & 0xC0) == 0x80)    /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
-    return 4; // valid UTF-8 4 bytes sequence
-
-  return 0; // invalid UTF-8 char sequence
+  /* 80 - C1 are continuation bytes or overlong sequences */
+  if (chr < 0xC2)
+    return 0;
+
+  /* U+0080 - U+07FF in UTF-8 */                    /* C2=1100 0010 - DF=1101 1111 */
+  if (chr <= 0xDF)
+    return ((strU[1] & 0xC0) == 0x80) ? 2 : 0;       /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
+
+  if (chr <= 0xEF)
+  {
+    bool valid;
+    if (chr == 0xE0)       /* U+0800 - U+0FFF in UTF-8 */
+      valid = (strU[1] & 0xE0) == 0xA0;              /* E0=1110 0000, A0=1010 0000 - BF=1011 1111 */
+    else if (chr == 0xED)  /* U+D000 - U+D7FF in UTF-8, U+D800 - U+DFFF is reserved and invalid */
+      valid = (strU[1] & 0xE0) == 0x80;              /* E0=1110 0000, 80=1000 0000 - 9F=1001 1111 */
+    else                   /* U+1000 - U+CFFF and U+E000 - U+FFFF in UTF-8 */
+      valid = (strU[1] & 0xC0) == 0x80;              /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
+
+    return (valid && (strU[2] & 0xC0) == 0x80) ? 3 : 0; // valid UTF-8 3 bytes sequence
+  }
+
+  bool valid;
+  if (chr == 0xF0)         /* U+10000 - U+3FFFF in UTF-8 */
+    valid = (strU[1] & 0xE0) == 0x80                 /* E0=1110 0000, 80=1000 0000 - 9F=1001 1111 */
+            && strU[2] >= 0x90 && strU[2] <= 0xBF;   /* 90=1001 0000 - BF=1011 1111 */
+  else if (chr <= 0xF3)    /* U+40000 - U+FFFFF in UTF-8 */
+    valid = (strU[1] & 0xC0) == 0x80                 /* C0=1100 0000, 80=1000 0000 - BF=1011 1111 */
+            && (strU[2] & 0xC0) == 0x80;
+  else if (chr == 0xF4)    /* U+100000 - U+10FFFF in UTF-8 */
+    valid = (strU[1] & 0xF0) == 0x80                 /* F0=1111 0000, 80=1000 0000 - 8F=1000 1111 */
+            && (strU[2] & 0xC0) == 0x80;
+  else
+    return 0; // invalid UTF-8 char sequence
+
+  return (valid && (strU[3] & 0xC0) == 0x80) ? 4 : 0; // valid UTF-8 4 bytes sequence
 }
@@ -50,6 +50,26 @@ public:
   static size_t RFindValidUtf8Char(const std::string& str, const size_t startPos);
   
   static size_t SizeOfUtf8Char(const std::string& str, const size_t charStart = 0);
+
+  /**
+   * Convert UTF-8 to UTF-32 without going through iconv
+   * Runs of ASCII characters are widened with SSE2/AVX2 where available.
+   * @param str string to convert
+   * @param utf32 receives the converted string, wchar_t must be 32 bit for the std::wstring overload
+   * @return false if str isn't valid UTF-8, utf32 is undefined in that case
+   */
+  static bool ConvertToUtf32(const std::string& str, std::u32string& utf32);
+  static bool ConvertToUtf32(const std::string& str, std::wstring& utf32);
+
+  /**
+   * Convert UTF-32 to UTF-8 without going through iconv
+   * @param utf32 string to convert, wchar_t must be 32 bit for the std::wstring overload
+   * @param str receives the converted string
+   * @return false if utf32 contains surrogates or values beyond U+10FFFF, str is undefined in that case
+   */
+  static bool ConvertFromUtf32(const std::u32string& utf32, std::string& str);
+  static bool ConvertFromUtf32(const std::wstring& utf32, std::string& str);
+
 private:
   static size_t SizeOfUtf8Char(const char* const str);
 };
@@ -20,6 +20,7 @@
 
 #include "Variant.h"
 
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
@@ -134,6 +135,42 @@ CVariant::CVariant()
 {
 }
 
+namespace
+{
+// object members are sorted by key, see CVariant::VariantMap
+template<typename Map>
+auto LowerBound(Map& map, const std::string& key) -> decltype(map.begin())
+{
+  return std::lower_bound(map.begin(), map.end(), key,
+                          [](const typename Map::value_type& member, const std::string& key)
+                          {
+                            return member.first < key;
+                          });
+}
+
+template<typename Map>
+auto Find(Map& map, const std::string& key) -> decltype(map.begin())
+{
+  // most objects only have a handful of members, comparing the lengths
+  // first rules out nearly all of them without touching the characters
+  if (map.size() <= 16)
+  {
+    auto it = map.begin();
+    for (; it != map.end(); ++it)
+    {
+      if (it->first.size() == key.size() && it->first == key)
+        break;
+    }
+    return it;
+  }
+
+  auto it = LowerBound(map, key);
+  if (it != map.end() && it->first != key)
+    return map.end();
+  return it;
+}
+}
+
 CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 
 CVariant::CVariant(VariantType type)
@@ -273,10 +310,12 @@ CVariant::CVariant(const std::vector<std::string> &strArray)
 
 CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
+  // std::map is already sorted by key
   m_type = VariantTypeObject;
   m_data.map = new VariantMap;
+  m_data.map->reserve(strMap.size());
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    m_data.map->emplace_back(it->first, CVariant(it->second));
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
@@ -291,7 +330,7 @@ CVariant::CVariant(const CVariant &variant)
   *this = variant;
 }
 
-CVariant::CVariant(CVariant&& rhs)
+CVariant::CVariant(CVariant&& rhs) noexcept
 {
   //Set this so that operator= don't try and run cleanup
   //when we're not initialized.
@@ -565,7 +604,16 @@ CVariant &CVariant::operator[](const std::string &key)
   }
 
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
+  {
+    VariantMap::iterator it = Find(*m_data.map, key);
+    if (it == m_data.map->end())
+    {
+      if (m_data.map->capacity() == 0)
+        m_data.map->reserve(8);
+      it = m_data.map->emplace(LowerBound(*m_data.map, key), key, CVariant());
+    }
+    return it->second;
+  }
   else
     return ConstNullVariant;
 }
@@ -573,7 +621,7 @@ CVariant &CVariant::operator[](const std::string &key)
 const CVariant &CVariant::operator[](const std::string &key) const
 {
   VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
+  if (m_type == VariantTypeObject && (it = Find(*m_data.map, key)) != m_data.map->end())
     return it->second;
   else
     return ConstNullVariant;
@@ -637,7 +685,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   return *this;
 }
 
-CVariant& CVariant::operator=(CVariant&& rhs)
+CVariant& CVariant::operator=(CVariant&& rhs) noexcept
 {
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
@@ -863,7 +911,11 @@ void CVariant::erase(const std::string &key)
     m_data.map = new VariantMap;
   }
   else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
+  {
+    VariantMap::iterator it = Find(*m_data.map, key);
+    if (it != m_data.map->end())
+      m_data.map->erase(it);
+  }
 }
 
 void CVariant::erase(unsigned int position)
@@ -881,7 +933,7 @@ void CVariant::erase(unsigned int position)
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+    return Find(*m_data.map, key) != m_data.map->end();
 
   return false;
 }
@@ -21,6 +21,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <utility>
 #include <stdint.h>
 #include <wchar.h>
 
@@ -69,7 +70,7 @@ public:
   CVariant(const std::map<std::string, std::string> &strMap);
   CVariant(const std::map<std::string, CVariant> &variantMap);
   CVariant(const CVariant &variant);
-  CVariant(CVariant &&rhs);
+  CVariant(CVariant &&rhs) noexcept;
   ~CVariant();
 
 
@@ -101,7 +102,7 @@ public:
   const CVariant &operator[](unsigned int position) const;
 
   CVariant &operator=(const CVariant &rhs);
-  CVariant &operator=(CVariant &&rhs);
+  CVariant &operator=(CVariant &&rhs) noexcept;
   bool operator==(const CVariant &rhs) const;
   bool operator!=(const CVariant &rhs) const { return !(*this == rhs); }
 
@@ -116,7 +117,14 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+  /*!
+   * Objects are kept as a vector of key/value pairs sorted by key, which
+   * iterates in the same order as std::map did but needs a single
+   * allocation per object instead of one tree node per member.
+   * Like for arrays, adding a member invalidates references to the
+   * other members of the same object.
+   */
+  typedef std::vector<std::pair<std::string, CVariant> > VariantMap;
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -0,0 +1,172 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/CharsetConverter.h"
+#include "utils/Utf8Utils.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+// mostly ASCII like typical library paths and labels
+std::string AsciiText(size_t length)
+{
+  const std::string chunk = "/media/movies/Some Movie (1999)/Some.Movie.1999.1080p.mkv ";
+  std::string text;
+  while (text.size() < length)
+    text += chunk;
+  text.resize(length);
+  return text;
+}
+
+// german, cyrillic and CJK text without any ASCII runs worth mentioning
+std::string MixedText(size_t length)
+{
+  const std::string chunk = "Gr\xc3\xbc\xc3\x9f" "e \xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 "
+                            "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e ";
+  std::string text;
+  while (text.size() + chunk.size() <= length)
+    text += chunk;
+  return text;
+}
+
+// the kind of labels a library view renders: titles, artists, paths and plot lines
+std::vector<std::string> Labels()
+{
+  static const char* const labels[] = {
+    "The Shawshank Redemption", "Am\xc3\xa9lie", "Das Boot", "Crouching Tiger, Hidden Dragon",
+    "\xe5\x8d\x83\xe3\x81\xa8\xe5\x8d\x83\xe5\xb0\x8b\xe3\x81\xae\xe7\xa5\x9e\xe9\x9a\xa0\xe3\x81\x97",
+    "Bj\xc3\xb6rk", "Sigur R\xc3\xb3s", "Mot\xc3\xb6rhead", "AC/DC", "Beyonc\xc3\xa9",
+    "S01E01 - Pilot", "2001: A Space Odyssey (1968)", "1080p | DTS-HD MA 5.1 | English",
+    "smb://nas/media/Movies/The Matrix (1999)/The.Matrix.1999.1080p.BluRay.x264.mkv",
+    "\xd0\x91\xd1\x80\xd0\xb0\xd1\x82 2", "Le Fabuleux Destin d'Am\xc3\xa9lie Poulain",
+    "A young boy befriends a giant robot from outer space that a paranoid government agent wants to destroy.",
+  };
+
+  std::vector<std::string> result;
+  for (int i = 0; i < 64; i++)
+  {
+    for (const char* label : labels)
+      result.push_back(label);
+  }
+  return result;
+}
+}
+
+static void BM_CharsetConverter_Utf8ToW_Ascii(benchmark::State& state)
+{
+  const std::string text = AsciiText(static_cast<size_t>(state.range(0)));
+  std::wstring out;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToW(text, out, false);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CharsetConverter_Utf8ToW_Ascii)->Arg(64)->Arg(4096);
+
+static void BM_CharsetConverter_Utf8ToW_Mixed(benchmark::State& state)
+{
+  const std::string text = MixedText(static_cast<size_t>(state.range(0)));
+  std::wstring out;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToW(text, out, false);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CharsetConverter_Utf8ToW_Mixed)->Arg(64)->Arg(4096);
+
+static void BM_CharsetConverter_Utf8ToW_BiDi(benchmark::State& state)
+{
+  const std::string text = AsciiText(static_cast<size_t>(state.range(0)));
+  std::wstring out;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToW(text, out, true);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CharsetConverter_Utf8ToW_BiDi)->Arg(64)->Arg(4096);
+
+static void BM_CharsetConverter_Utf8ToUtf32(benchmark::State& state)
+{
+  const std::string text = AsciiText(static_cast<size_t>(state.range(0)));
+  std::u32string out;
+  for (auto _ : state)
+  {
+    CCharsetConverter::utf8ToUtf32(text, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CharsetConverter_Utf8ToUtf32)->Arg(64)->Arg(4096);
+
+static void BM_CharsetConverter_WToUtf8(benchmark::State& state)
+{
+  std::wstring text;
+  CCharsetConverter::utf8ToW(MixedText(static_cast<size_t>(state.range(0))), text, false);
+  std::string out;
+  for (auto _ : state)
+  {
+    CCharsetConverter::wToUTF8(text, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CharsetConverter_WToUtf8)->Arg(64)->Arg(4096);
+
+static void BM_CharsetConverter_Labels(benchmark::State& state)
+{
+  const std::vector<std::string> labels = Labels();
+  const bool bidi = state.range(0) != 0;
+  std::wstring out;
+  size_t bytes = 0;
+  for (const auto& label : labels)
+    bytes += label.size();
+
+  for (auto _ : state)
+  {
+    for (const auto& label : labels)
+    {
+      CCharsetConverter::utf8ToW(label, out, bidi);
+      benchmark::DoNotOptimize(out.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * labels.size());
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_CharsetConverter_Labels)->Arg(0)->Arg(1);
+
+static void BM_Utf8Utils_CheckStrForUtf8(benchmark::State& state)
+{
+  const std::string text = state.range(1) ? MixedText(static_cast<size_t>(state.range(0)))
+                                          : AsciiText(static_cast<size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(CUtf8Utils::checkStrForUtf8(text));
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Utf8Utils_CheckStrForUtf8)->Args({64, 0})->Args({4096, 0})->Args({4096, 1});
@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+// a VideoLibrary.GetMovies style result with the given number of movies
+CVariant CreateResult(int count)
+{
+  CVariant result(CVariant::VariantTypeObject);
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = count;
+  result["limits"]["total"] = count;
+  result["movies"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < count; i++)
+  {
+    CVariant movie(CVariant::VariantTypeObject);
+    movie["movieid"] = i;
+    movie["label"] = "Some Movie " + std::to_string(i);
+    movie["year"] = 1990 + i % 28;
+    movie["rating"] = 7.5;
+    movie["file"] = "/media/movies/Some Movie " + std::to_string(i) + ".mkv";
+    movie["plot"] = "A plot with \"quotes\", unicode \xc3\xa9\xc3\xa8 and a line\nbreak.";
+    movie["genre"] = CVariant(CVariant::VariantTypeArray);
+    movie["genre"].push_back("Action");
+    movie["genre"].push_back("Drama");
+    result["movies"].push_back(movie);
+  }
+  return result;
+}
+}
+
+static void BM_JSON_WriteCompact(benchmark::State& state)
+{
+  const CVariant result = CreateResult(static_cast<int>(state.range(0)));
+  std::string output;
+  for (auto _ : state)
+  {
+    CJSONVariantWriter::Write(result, output, true);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetBytesProcessed(state.iterations() * output.size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JSON_WriteCompact)->Arg(10)->Arg(1000)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+static void BM_JSON_WritePretty(benchmark::State& state)
+{
+  const CVariant result = CreateResult(static_cast<int>(state.range(0)));
+  std::string output;
+  for (auto _ : state)
+  {
+    CJSONVariantWriter::Write(result, output, false);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetBytesProcessed(state.iterations() * output.size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JSON_WritePretty)->Arg(10)->Arg(1000);
+
+static void BM_JSON_Parse(benchmark::State& state)
+{
+  std::string json;
+  CJSONVariantWriter::Write(CreateResult(static_cast<int>(state.range(0))), json, true);
+  for (auto _ : state)
+  {
+    CVariant value;
+    CJSONVariantParser::Parse(json, value);
+    benchmark::DoNotOptimize(value.size());
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JSON_Parse)->Arg(10)->Arg(1000)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+static void BM_JSON_ParseRequest(benchmark::State& state)
+{
+  const std::string request = "{\"jsonrpc\": \"2.0\", \"method\": \"VideoLibrary.GetMovies\", "
+                              "\"params\": {\"properties\": [\"title\", \"year\", \"rating\", \"file\"], "
+                              "\"limits\": {\"start\": 0, \"end\": 50}, "
+                              "\"sort\": {\"method\": \"label\", \"order\": \"ascending\"}}, \"id\": 1}";
+  for (auto _ : state)
+  {
+    CVariant value;
+    CJSONVariantParser::Parse(request, value);
+    benchmark::DoNotOptimize(value.size());
+  }
+}
+BENCHMARK(BM_JSON_ParseRequest);
@@ -0,0 +1,64 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/RingBuffer.h"
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+static void BM_RingBuffer_WriteRead(benchmark::State& state)
+{
+  const unsigned int chunk = static_cast<unsigned int>(state.range(0));
+  CRingBuffer buffer;
+  buffer.Create(1024 * 1024);
+  std::vector<char> in(chunk, 'x');
+  std::vector<char> out(chunk);
+
+  for (auto _ : state)
+  {
+    buffer.WriteData(in.data(), chunk);
+    buffer.ReadData(out.data(), chunk);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * chunk);
+}
+BENCHMARK(BM_RingBuffer_WriteRead)->Arg(64)->Arg(4096)->Arg(64 * 1024);
+
+// keep the buffer about half full so reads and writes wrap around the end
+static void BM_RingBuffer_Wrapping(benchmark::State& state)
+{
+  const unsigned int chunk = static_cast<unsigned int>(state.range(0));
+  CRingBuffer buffer;
+  buffer.Create(chunk * 7 + 1);
+  std::vector<char> in(chunk, 'x');
+  std::vector<char> out(chunk);
+  for (int i = 0; i < 3; i++)
+    buffer.WriteData(in.data(), chunk);
+
+  for (auto _ : state)
+  {
+    buffer.WriteData(in.data(), chunk);
+    buffer.ReadData(out.data(), chunk);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * chunk);
+}
+BENCHMARK(BM_RingBuffer_Wrapping)->Arg(64)->Arg(4096)->Arg(64 * 1024);
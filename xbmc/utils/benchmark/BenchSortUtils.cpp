@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/CharsetConverter.h"
+#include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+// songs the way the music library hands them to SortUtils
+DatabaseResults CreateSongs(int count)
+{
+  static const char* const artists[] = {
+    "The Beatles", "Bj\xc3\xb6rk", "Mot\xc3\xb6rhead", "AC/DC", "Beyonc\xc3\xa9", "Sigur R\xc3\xb3s",
+    "Pink Floyd", "Radiohead", "The Rolling Stones", "Daft Punk", "Nirvana", "Portishead"
+  };
+  const int artistCount = sizeof(artists) / sizeof(artists[0]);
+
+  DatabaseResults songs;
+  songs.reserve(count);
+  // a fixed permutation, so every run sorts the same input
+  for (int i = 0; i < count; i++)
+  {
+    const int id = (i * 7919) % count;
+    DatabaseResult song;
+    song[FieldId] = id;
+    song[FieldArtist] = artists[id % artistCount];
+    song[FieldAlbum] = StringUtils::Format("Album %d", id / 12 % 1000);
+    song[FieldTrackNumber] = id % 12 + 1;
+    song[FieldLabel] = StringUtils::Format("Track %d", id);
+    song[FieldSortSpecial] = CVariant::ConstNullVariant;
+    song[FieldFolder] = false;
+    songs.push_back(song);
+  }
+  return songs;
+}
+
+// what SortUtils::Sort did before it precomputed the sort keys: every
+// comparison looks up the fields in both item maps and copies both labels
+bool CompareStoredLabels(const DatabaseResult& left, const DatabaseResult& right)
+{
+  DatabaseResult::const_iterator itLeft = left.find(FieldSortSpecial);
+  DatabaseResult::const_iterator itRight = right.find(FieldSortSpecial);
+  if (itLeft->second.asInteger() != itRight->second.asInteger())
+    return itLeft->second.asInteger() < itRight->second.asInteger();
+
+  itLeft = left.find(FieldFolder);
+  itRight = right.find(FieldFolder);
+  if (itLeft->second.asBoolean() != itRight->second.asBoolean())
+    return itLeft->second.asBoolean();
+
+  const std::wstring labelLeft = left.find(FieldSort)->second.asWideString();
+  const std::wstring labelRight = right.find(FieldSort)->second.asWideString();
+  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+}
+}
+
+static void BM_SortUtils_SortStoredLabels(benchmark::State& state)
+{
+  const DatabaseResults songs = CreateSongs(state.range(0));
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    DatabaseResults items(songs);
+    state.ResumeTiming();
+
+    for (auto& item : items)
+    {
+      std::wstring sortLabel;
+      g_charsetConverter.utf8ToW(item[FieldLabel].asString(), sortLabel, false);
+      item[FieldSort] = CVariant(sortLabel);
+    }
+    std::stable_sort(items.begin(), items.end(), CompareStoredLabels);
+    benchmark::DoNotOptimize(items.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortUtils_SortStoredLabels)->Arg(1000)->Arg(30000)->Unit(benchmark::kMillisecond);
+
+static void BM_SortUtils_Sort(benchmark::State& state)
+{
+  const DatabaseResults songs = CreateSongs(state.range(0));
+  const int limitEnd = state.range(1) > 0 ? state.range(1) : -1;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    DatabaseResults items(songs);
+    state.ResumeTiming();
+
+    SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items, limitEnd);
+    benchmark::DoNotOptimize(items.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+// the second argument is the limit of a paged JSON-RPC request, 0 for no limit
+BENCHMARK(BM_SortUtils_Sort)->Args({1000, 0})->Args({30000, 0})->Args({30000, 50})->Unit(benchmark::kMillisecond);
+
+static void BM_SortUtils_SortByArtist(benchmark::State& state)
+{
+  const DatabaseResults songs = CreateSongs(state.range(0));
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    DatabaseResults items(songs);
+    state.ResumeTiming();
+
+    SortUtils::Sort(SortByArtist, SortOrderAscending, SortAttributeIgnoreArticle, items);
+    benchmark::DoNotOptimize(items.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortUtils_SortByArtist)->Arg(30000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StringUtils.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+const std::string path = "/home/user/Videos/TV Shows/Some Show (2010)/Season 01/Some.Show.S01E01.720p.mkv";
+const std::string padded = "   \t Some label with surrounding whitespace \r\n  ";
+const std::string csv = "Action / Adventure / Comedy / Crime / Drama / Fantasy / Horror / Mystery / Sci-Fi";
+}
+
+static void BM_StringUtils_ToLower(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    std::string str(path);
+    StringUtils::ToLower(str);
+    benchmark::DoNotOptimize(str.data());
+  }
+  state.SetBytesProcessed(state.iterations() * path.size());
+}
+BENCHMARK(BM_StringUtils_ToLower);
+
+static void BM_StringUtils_EqualsNoCase(benchmark::State& state)
+{
+  std::string upper(path);
+  StringUtils::ToUpper(upper);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(StringUtils::EqualsNoCase(path, upper));
+  state.SetBytesProcessed(state.iterations() * path.size());
+}
+BENCHMARK(BM_StringUtils_EqualsNoCase);
+
+static void BM_StringUtils_Trim(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    std::string str(padded);
+    benchmark::DoNotOptimize(StringUtils::Trim(str).data());
+  }
+}
+BENCHMARK(BM_StringUtils_Trim);
+
+static void BM_StringUtils_Replace(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    std::string str(path);
+    benchmark::DoNotOptimize(StringUtils::Replace(str, "/", "\\\\"));
+  }
+  state.SetBytesProcessed(state.iterations() * path.size());
+}
+BENCHMARK(BM_StringUtils_Replace);
+
+static void BM_StringUtils_Split(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    std::vector<std::string> parts = StringUtils::Split(csv, " / ");
+    benchmark::DoNotOptimize(parts.data());
+  }
+  state.SetBytesProcessed(state.iterations() * csv.size());
+}
+BENCHMARK(BM_StringUtils_Split);
+
+static void BM_StringUtils_Join(benchmark::State& state)
+{
+  const std::vector<std::string> parts = StringUtils::Split(csv, " / ");
+  for (auto _ : state)
+    benchmark::DoNotOptimize(StringUtils::Join(parts, " / "));
+}
+BENCHMARK(BM_StringUtils_Join);
+
+static void BM_StringUtils_Format(benchmark::State& state)
+{
+  int i = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(StringUtils::Format("%s - S%02dE%02d (%i)", "Some Show", 1, i % 24, i));
+    i++;
+  }
+}
+BENCHMARK(BM_StringUtils_Format);
+
+static void BM_StringUtils_AlphaNumericCompare(benchmark::State& state)
+{
+  const std::wstring left = L"Some Show S01E09 Part 2";
+  const std::wstring right = L"Some Show S01E10 Part 1";
+  for (auto _ : state)
+    benchmark::DoNotOptimize(StringUtils::AlphaNumericCompare(left.c_str(), right.c_str()));
+}
+BENCHMARK(BM_StringUtils_AlphaNumericCompare);
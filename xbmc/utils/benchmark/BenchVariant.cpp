@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Variant.h"
+#include "video/VideoInfoTag.h"
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+namespace
+{
+// roughly what VideoLibrary.GetMovies returns for a single movie
+CVariant CreateMovie(int id)
+{
+  CVariant movie(CVariant::VariantTypeObject);
+  movie["movieid"] = id;
+  movie["label"] = "Some Movie " + std::to_string(id);
+  movie["title"] = "Some Movie " + std::to_string(id);
+  movie["year"] = 1990 + id % 28;
+  movie["rating"] = 7.5;
+  movie["playcount"] = 0;
+  movie["runtime"] = 7200;
+  movie["file"] = "/media/movies/Some Movie " + std::to_string(id) + ".mkv";
+  movie["plot"] = "A fairly long plot outline that is there to make the string allocation show up.";
+  movie["genre"] = CVariant(CVariant::VariantTypeArray);
+  movie["genre"].push_back("Action");
+  movie["genre"].push_back("Drama");
+  movie["art"] = CVariant(CVariant::VariantTypeObject);
+  movie["art"]["poster"] = "image://poster.jpg/";
+  movie["art"]["fanart"] = "image://fanart.jpg/";
+  return movie;
+}
+}
+
+static void BM_Variant_CreateObject(benchmark::State& state)
+{
+  int id = 0;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(CreateMovie(id++));
+}
+BENCHMARK(BM_Variant_CreateObject);
+
+static void BM_Variant_CreateArray(benchmark::State& state)
+{
+  for (auto _ : state)
+  {
+    CVariant movies(CVariant::VariantTypeArray);
+    for (int i = 0; i < state.range(0); i++)
+      movies.push_back(CreateMovie(i));
+    benchmark::DoNotOptimize(movies.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+// 20000 movies is a large but realistic VideoLibrary.GetMovies response
+BENCHMARK(BM_Variant_CreateArray)->Arg(100)->Arg(1000)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Variant_LookupArray(benchmark::State& state)
+{
+  CVariant movies(CVariant::VariantTypeArray);
+  for (int i = 0; i < state.range(0); i++)
+    movies.push_back(CreateMovie(i));
+
+  for (auto _ : state)
+  {
+    int64_t sum = 0;
+    for (CVariant::const_iterator_array it = movies.begin_array(); it != movies.end_array(); ++it)
+    {
+      sum += (*it)["year"].asInteger();
+      sum += (*it)["art"]["poster"].asString().size();
+      sum += it->isMember("streamdetails");
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Variant_LookupArray)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Variant_CopyArray(benchmark::State& state)
+{
+  CVariant movies(CVariant::VariantTypeArray);
+  for (int i = 0; i < state.range(0); i++)
+    movies.push_back(CreateMovie(i));
+
+  for (auto _ : state)
+  {
+    CVariant copy(movies);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Variant_CopyArray)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Variant_Copy(benchmark::State& state)
+{
+  const CVariant movie = CreateMovie(1);
+  for (auto _ : state)
+  {
+    CVariant copy(movie);
+    benchmark::DoNotOptimize(copy.size());
+  }
+}
+BENCHMARK(BM_Variant_Copy);
+
+static void BM_Variant_Lookup(benchmark::State& state)
+{
+  const CVariant movie = CreateMovie(1);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(movie["title"].asString().size());
+    benchmark::DoNotOptimize(movie["year"].asInteger());
+    benchmark::DoNotOptimize(movie.isMember("streamdetails"));
+  }
+}
+BENCHMARK(BM_Variant_Lookup);
+
+static void BM_Variant_SerializeVideoInfoTag(benchmark::State& state)
+{
+  CVideoInfoTag tag;
+  tag.SetTitle("Some Movie");
+  tag.SetYear(1999);
+  tag.SetRating(7.5f);
+  tag.SetPlot("A fairly long plot outline that is there to make the string allocation show up.");
+  tag.m_strFileNameAndPath = "/media/movies/Some Movie.mkv";
+
+  for (auto _ : state)
+  {
+    CVariant value;
+    tag.Serialize(value);
+    benchmark::DoNotOptimize(value.size());
+  }
+}
+BENCHMARK(BM_Variant_SerializeVideoInfoTag);
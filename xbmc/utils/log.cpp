@@ -22,9 +22,13 @@
 #include "system.h"
 #include "threads/SingleLock.h"
 #include "threads/Thread.h"
+#include "utils/LogQueue.h"
 #include "utils/StringUtils.h"
 #include "CompileInfo.h"
 
+#include <algorithm>
+#include <stdio.h>
+
 static const char* const levelNames[] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
 
@@ -32,9 +36,130 @@ static const char* const levelNames[] =
 static const char* const logLevelNames[] =
 { "LOG_LEVEL_NONE" /*-1*/, "LOG_LEVEL_NORMAL" /*0*/, "LOG_LEVEL_DEBUG" /*1*/, "LOG_LEVEL_DEBUG_FREEMEM" /*2*/ };
 
+// number of lines the writer thread can fall behind
+static const size_t LOG_QUEUE_SIZE = 4096;
+// the writer collects lines until it has that many bytes or the queue is empty
+static const size_t LOG_BATCH_SIZE = 64 * 1024;
+// how long the idle writer sleeps before it checks the queue again
+static const int LOG_WRITER_IDLE_MS = 100;
+
 // s_globals is used as static global with CLog global variables
 #define s_globals XBMC_GLOBAL_USE(CLog).m_globalInstance
 
+/*!
+ * Single consumer of the log queue. Producers only touch the lock-free
+ * queue, all formatting of the line prefix, repeat detection and file I/O
+ * happens here, so a batch of lines ends up in one write and one flush.
+ */
+class CLog::CLogWriter : public CThread
+{
+public:
+  CLogWriter() :
+    CThread("LogWriter"),
+    m_queue(LOG_QUEUE_SIZE),
+    m_idle(false),
+    m_reportedDrops(0)
+  {
+    m_batch.reserve(LOG_BATCH_SIZE + 4096);
+  }
+
+  bool Push(CLogQueue::Entry& entry)
+  {
+    if (!m_queue.TryPush(entry))
+      return false;
+
+    // only pay for the event if the writer actually went to sleep
+    if (m_idle.load(std::memory_order_acquire))
+      m_wakeup.Set();
+    return true;
+  }
+
+  /*!
+   * \brief Write out everything that is queued from the calling thread
+   *
+   * Used for lines that raced with StopWriter(), the writer thread may be
+   * gone already by the time they made it into the queue.
+   */
+  void Drain()
+  {
+    while (Flush())
+      ;
+  }
+
+protected:
+  void Process() override
+  {
+    while (!m_bStop)
+    {
+      if (Flush())
+        continue;
+
+      m_idle.store(true, std::memory_order_release);
+      if (m_queue.IsEmpty())
+        AbortableWait(m_wakeup, LOG_WRITER_IDLE_MS);
+      m_idle.store(false, std::memory_order_release);
+    }
+
+    // write out whatever was queued before we were asked to stop
+    Drain();
+  }
+
+private:
+  bool Flush()
+  {
+    CSingleLock lock(s_globals.critSec);
+    m_batch.clear();
+
+    while (m_batch.size() < LOG_BATCH_SIZE && m_queue.TryPop(m_entry))
+      LogLine(m_entry.level, m_entry.threadId, m_entry.hour, m_entry.minute, m_entry.second,
+              m_entry.millisecond, m_entry.line, m_batch);
+
+    const uint64_t dropped = s_globals.m_droppedLines.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDrops)
+    {
+      int hour, minute, second;
+      double millisecond;
+      s_globals.m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
+      LogLine(LOGWARNING, (uint64_t)CThread::GetCurrentThreadId(), hour, minute, second,
+              static_cast<int>(millisecond),
+              StringUtils::Format("Log buffer full, %" PRIu64" lines dropped", dropped - m_reportedDrops),
+              m_batch);
+      m_reportedDrops = dropped;
+    }
+
+    if (m_batch.empty())
+      return false;
+
+    s_globals.m_platform.WriteStringToLog(m_batch);
+    return true;
+  }
+
+  CLogQueue m_queue;
+  CEvent m_wakeup;
+  std::atomic<bool> m_idle;
+  uint64_t m_reportedDrops;
+  CLogQueue::Entry m_entry;
+  std::string m_batch;
+};
+
+CLog::CLogGlobals::CLogGlobals(void) :
+  m_repeatCount(0),
+  m_repeatLogLevel(-1),
+  m_logLevel(LOG_LEVEL_DEBUG),
+  m_extraLogLevels(0),
+  m_asyncWriting(true),
+  m_dropOnOverflow(false),
+  m_droppedLines(0),
+  m_activeWriter(nullptr)
+{}
+
+CLog::CLogGlobals::~CLogGlobals()
+{
+  m_activeWriter = nullptr;
+  if (m_writer)
+    m_writer->StopThread(true);
+}
+
 CLog::CLog()
 {}
 
@@ -43,18 +168,33 @@ CLog::~CLog()
 
 void CLog::Close()
 {
+  StopWriter();
+
   CSingleLock waitLock(s_globals.critSec);
   s_globals.m_platform.CloseLogFile();
   s_globals.m_repeatLine.clear();
 }
 
+void CLog::StopWriter()
+{
+  // producers that already picked up the writer may still push after this,
+  // they notice that the writer is no longer active and drain the queue
+  // themselves (see LogString)
+  CLogWriter* writer = s_globals.m_activeWriter.exchange(nullptr);
+  if (writer)
+  {
+    writer->StopThread(true);
+    writer->Drain();
+  }
+}
+
 void CLog::Log(int loglevel, const char *format, ...)
 {
   if (IsLogLevelLogged(loglevel))
   {
     va_list va;
     va_start(va, format);
-    LogString(loglevel, StringUtils::FormatV(format, va));
+    LogString(loglevel, nullptr, format, va);
     va_end(va);
   }
 }
@@ -63,44 +203,126 @@ void CLog::LogFunction(int loglevel, const char* functionName, const char* forma
 {
   if (IsLogLevelLogged(loglevel))
   {
-    std::string fNameStr;
-    if (functionName && functionName[0])
-      fNameStr.assign(functionName).append(": ");
     va_list va;
     va_start(va, format);
-    LogString(loglevel, fNameStr + StringUtils::FormatV(format, va));
+    LogString(loglevel, functionName, format, va);
     va_end(va);
   }
 }
 
-void CLog::LogString(int logLevel, const std::string& logString)
+// Formats into a buffer owned by the calling thread. Its capacity survives
+// between calls (and is traded with the queue slots), so the hot path does
+// not allocate once the buffers have grown to the usual line length.
+static void FormatLine(std::string& buffer, const char* functionName, const char* format, va_list args)
 {
-  CSingleLock waitLock(s_globals.critSec);
-  std::string strData(logString);
-  StringUtils::TrimRight(strData);
-  if (!strData.empty())
+  buffer.clear();
+  if (functionName && functionName[0])
+    buffer.append(functionName).append(": ");
+  if (!format || !format[0])
+    return;
+
+  const size_t offset = buffer.size();
+  size_t size = std::max<size_t>(buffer.capacity(), offset + 256);
+  while (true)
   {
-    if (s_globals.m_repeatLogLevel == logLevel && s_globals.m_repeatLine == strData)
+    buffer.resize(size);
+
+    va_list argCopy;
+    va_copy(argCopy, args);
+    const int actual = vsnprintf(&buffer[offset], size - offset, format, argCopy);
+    va_end(argCopy);
+
+    if (actual > -1 && offset + actual < size)
     {
-      s_globals.m_repeatCount++;
+      buffer.resize(offset + actual);
       return;
     }
-    else if (s_globals.m_repeatCount)
+
+    if (actual > -1)
+      size = offset + actual + 1;
+    else
+      size *= 2; // pre-C99 vsnprintf on windows
+  }
+}
+
+void CLog::LogString(int logLevel, const char* functionName, const char* format, va_list args)
+{
+  static thread_local CLogQueue::Entry entry;
+
+  FormatLine(entry.line, functionName, format, args);
+  StringUtils::TrimRight(entry.line);
+  if (entry.line.empty())
+    return;
+
+  entry.level = logLevel;
+  entry.threadId = (uint64_t)CThread::GetCurrentThreadId();
+  double millisecond;
+  s_globals.m_platform.GetCurrentLocalTime(entry.hour, entry.minute, entry.second, millisecond);
+  entry.millisecond = static_cast<int>(millisecond);
+
+  CLogWriter* writer = s_globals.m_activeWriter.load(std::memory_order_acquire);
+  if (writer)
+  {
+    bool queued;
+    while (!(queued = writer->Push(entry)))
     {
-      std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
-                                                s_globals.m_repeatCount);
-      PrintDebugString(strData2);
-      WriteLogString(s_globals.m_repeatLogLevel, strData2);
-      s_globals.m_repeatCount = 0;
+      // the writer must never wait for itself
+      if (s_globals.m_dropOnOverflow.load(std::memory_order_relaxed) || writer->IsCurrentThread())
+      {
+        ++s_globals.m_droppedLines;
+        return;
+      }
+      // nobody is going to make room once the writer has been stopped
+      if (s_globals.m_activeWriter.load(std::memory_order_acquire) != writer)
+        break;
+      XbmcThreads::ThreadSleep(1);
     }
 
-    s_globals.m_repeatLine = strData;
-    s_globals.m_repeatLogLevel = logLevel;
+    if (s_globals.m_activeWriter.load(std::memory_order_acquire) == writer)
+      return;
+
+    // the writer was stopped meanwhile, write out what is left in its queue
+    // so the line is neither lost nor written ahead of earlier ones
+    writer->Drain();
+    if (queued)
+      return;
+  }
 
-    PrintDebugString(strData);
+  // no writer thread, write synchronously
+  CSingleLock waitLock(s_globals.critSec);
+  std::string output;
+  LogLine(entry.level, entry.threadId, entry.hour, entry.minute, entry.second, entry.millisecond,
+          entry.line, output);
+  if (!output.empty())
+    s_globals.m_platform.WriteStringToLog(output);
+}
 
-    WriteLogString(logLevel, strData);
+// Appends the line to the output unless it repeats the previous one.
+// Must be called with the critical section held.
+void CLog::LogLine(int logLevel, uint64_t threadId, int hour, int minute, int second, int millisecond,
+                   const std::string& logString, std::string& output)
+{
+  if (s_globals.m_repeatLogLevel == logLevel && s_globals.m_repeatLine == logString)
+  {
+    s_globals.m_repeatCount++;
+    return;
   }
+  else if (s_globals.m_repeatCount)
+  {
+    std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
+                                              s_globals.m_repeatCount);
+    PrintDebugString(strData2);
+    AppendLogString(s_globals.m_repeatLogLevel, threadId, hour, minute, second, millisecond,
+                    strData2, output);
+    s_globals.m_repeatCount = 0;
+  }
+
+  s_globals.m_repeatLine = logString;
+  s_globals.m_repeatLogLevel = logLevel;
+
+  PrintDebugString(logString);
+
+  AppendLogString(logLevel, threadId, hour, minute, second, millisecond, logString, output);
 }
 
 bool CLog::Init(const std::string& path)
@@ -112,7 +334,18 @@ bool CLog::Init(const std::string& path)
 
   std::string appName = CCompileInfo::GetAppName();
   StringUtils::ToLower(appName);
-  return s_globals.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log");
+  if (!s_globals.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log"))
+    return false;
+
+  if (s_globals.m_asyncWriting && !s_globals.m_activeWriter.load())
+  {
+    if (!s_globals.m_writer)
+      s_globals.m_writer.reset(new CLogWriter());
+    s_globals.m_writer->Create();
+    s_globals.m_activeWriter = s_globals.m_writer.get();
+  }
+
+  return true;
 }
 
 void CLog::MemDump(char *pData, int length)
@@ -169,6 +402,22 @@ void CLog::SetExtraLogLevels(int level)
   s_globals.m_extraLogLevels = level;
 }
 
+void CLog::SetAsyncWriting(bool async)
+{
+  CSingleLock waitLock(s_globals.critSec);
+  s_globals.m_asyncWriting = async;
+}
+
+void CLog::SetDropOnOverflow(bool drop)
+{
+  s_globals.m_dropOnOverflow = drop;
+}
+
+uint64_t CLog::GetDroppedLineCount()
+{
+  return s_globals.m_droppedLines;
+}
+
 bool CLog::IsLogLevelLogged(int loglevel)
 {
   const int extras = (loglevel & ~LOGMASK);
@@ -192,25 +441,28 @@ void CLog::PrintDebugString(const std::string& line)
 #endif // defined(_DEBUG) || defined(PROFILE)
 }
 
-bool CLog::WriteLogString(int logLevel, const std::string& logString)
+void CLog::AppendLogString(int logLevel, uint64_t threadId, int hour, int minute, int second, int millisecond,
+                           const std::string& logString, std::string& output)
 {
   static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
 
-  std::string strData(logString);
-  /* fixup newline alignment, number of spaces should equal prefix length */
-  StringUtils::Replace(strData, "\n", "\n                                            ");
+  char prefix[64];
+  snprintf(prefix, sizeof(prefix), prefixFormat, hour, minute, second, millisecond, threadId,
+           levelNames[logLevel & LOGMASK]);
 
-  int hour, minute, second;
-  double millisecond;
-  s_globals.m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
-
-  strData = StringUtils::Format(prefixFormat,
-                                  hour,
-                                  minute,
-                                  second,
-                                  static_cast<int>(millisecond),
-                                  (uint64_t)CThread::GetCurrentThreadId(),
-                                  levelNames[logLevel]) + strData;
+  // lines of a batch are separated, the platform adds the final newline
+  if (!output.empty())
+    output += '\n';
+  output += prefix;
 
-  return s_globals.m_platform.WriteStringToLog(strData);
+  /* fixup newline alignment, number of spaces should equal prefix length */
+  size_t start = 0;
+  size_t pos;
+  while ((pos = logString.find('\n', start)) != std::string::npos)
+  {
+    output.append(logString, start, pos - start);
+    output += "\n                                            ";
+    start = pos + 1;
+  }
+  output.append(logString, start, std::string::npos);
 }
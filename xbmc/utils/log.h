@@ -20,6 +20,10 @@
  *
  */
 
+#include <atomic>
+#include <cstdarg>
+#include <memory>
+#include <stdint.h>
 #include <string>
 
 #if defined(TARGET_POSIX)
@@ -53,23 +57,45 @@ public:
   static void SetExtraLogLevels(int level);
   static bool IsLogLevelLogged(int loglevel);
 
+  /*!
+   * \brief Hand lines to a background writer thread instead of writing them
+   * from the calling thread. Takes effect with the next Init(), default is on.
+   */
+  static void SetAsyncWriting(bool async);
+  /*!
+   * \brief Drop lines (and count them) instead of waiting for the writer
+   * thread when its buffer is full, default is off.
+   */
+  static void SetDropOnOverflow(bool drop);
+  static uint64_t GetDroppedLineCount();
+
 protected:
+  class CLogWriter;
   class CLogGlobals
   {
   public:
-    CLogGlobals(void) : m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_extraLogLevels(0) {}
-    ~CLogGlobals() {}
+    CLogGlobals(void);
+    ~CLogGlobals();
     PlatformInterfaceForCLog m_platform;
     int         m_repeatCount;
     int         m_repeatLogLevel;
     std::string m_repeatLine;
     int         m_logLevel;
     int         m_extraLogLevels;
+    bool        m_asyncWriting;
+    std::atomic<bool> m_dropOnOverflow;
+    std::atomic<uint64_t> m_droppedLines;
+    std::atomic<CLogWriter*> m_activeWriter;
+    std::unique_ptr<CLogWriter> m_writer;
     CCriticalSection critSec;
   };
   class CLogGlobals m_globalInstance; // used as static global variable
-  static void LogString(int logLevel, const std::string& logString);
-  static bool WriteLogString(int logLevel, const std::string& logString);
+  static void LogString(int logLevel, const char* functionName, const char* format, va_list args);
+  static void LogLine(int logLevel, uint64_t threadId, int hour, int minute, int second, int millisecond,
+                      const std::string& logString, std::string& output);
+  static void AppendLogString(int logLevel, uint64_t threadId, int hour, int minute, int second, int millisecond,
+                              const std::string& logString, std::string& output);
+  static void StopWriter();
 };
 
 
@@ -0,0 +1,112 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ActorProtocol.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace Actor;
+
+class TestActorProtocol : public testing::Test
+{
+protected:
+  TestActorProtocol() : port("test", &inEvent, &outEvent) {}
+
+  CEvent inEvent;
+  CEvent outEvent;
+  Protocol port;
+};
+
+TEST_F(TestActorProtocol, SmallPayload)
+{
+  int value = 42;
+  EXPECT_TRUE(port.SendOutMessage(1, &value, sizeof(value)));
+  EXPECT_EQ(1, port.GetMessagesInFlight());
+
+  Message *msg = nullptr;
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(1, msg->signal);
+  EXPECT_TRUE(msg->isOut);
+  EXPECT_EQ(static_cast<int>(sizeof(value)), msg->payloadSize);
+  EXPECT_EQ(42, *reinterpret_cast<int*>(msg->data));
+  msg->Release();
+
+  EXPECT_EQ(0, port.GetMessagesInFlight());
+  EXPECT_EQ(0U, port.GetFallbackAllocations());
+}
+
+TEST_F(TestActorProtocol, LargePayloadBufferIsReused)
+{
+  std::vector<uint8_t> payload(MSG_INTERNAL_BUFFER_SIZE * 4, 0xAB);
+
+  // the arena hands out the most recently returned message again, so the
+  // payload buffer allocated for the first send is reused by the second
+  for (int i = 0; i < 2; i++)
+  {
+    EXPECT_TRUE(port.SendInMessage(2, payload.data(), payload.size()));
+    Message *msg = nullptr;
+    ASSERT_TRUE(port.ReceiveInMessage(&msg));
+    EXPECT_FALSE(msg->isOut);
+    EXPECT_EQ(static_cast<int>(payload.size()), msg->payloadSize);
+    EXPECT_EQ(0xAB, msg->data[payload.size() - 1]);
+    msg->Release();
+  }
+
+  EXPECT_EQ(1U, port.GetFallbackAllocations());
+}
+
+TEST_F(TestActorProtocol, ArenaExhausted)
+{
+  for (int i = 0; i < MSG_ARENA_SIZE + 2; i++)
+    EXPECT_TRUE(port.SendOutMessage(i));
+
+  EXPECT_EQ(MSG_ARENA_SIZE + 2, port.GetMessagesInFlight());
+  EXPECT_EQ(2U, port.GetFallbackAllocations());
+
+  Message *msg = nullptr;
+  int signal = 0;
+  while (port.ReceiveOutMessage(&msg))
+  {
+    EXPECT_EQ(signal++, msg->signal);
+    msg->Release();
+  }
+  EXPECT_EQ(MSG_ARENA_SIZE + 2, signal);
+  EXPECT_EQ(0, port.GetMessagesInFlight());
+}
+
+TEST_F(TestActorProtocol, PurgeReturnsMessages)
+{
+  for (int i = 0; i < 6; i++)
+    EXPECT_TRUE(port.SendOutMessage(i % 2));
+  EXPECT_EQ(6, port.GetMessagesInFlight());
+
+  port.PurgeOut(0);
+  EXPECT_EQ(3, port.GetMessagesInFlight());
+
+  Message *msg = nullptr;
+  while (port.ReceiveOutMessage(&msg))
+  {
+    EXPECT_EQ(1, msg->signal);
+    msg->Release();
+  }
+  EXPECT_EQ(0, port.GetMessagesInFlight());
+}
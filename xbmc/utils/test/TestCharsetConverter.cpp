@@ -130,6 +130,29 @@ TEST_F(TestCharsetConverter, utf8ToW)
   EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf8ToW_long)
+{
+  // long enough for the vectorised ASCII runs, with multi-byte characters in between
+  refstra1 = u8"Some.Movie.1999.1080p.BluRay.x264 - Gr\u00fc\u00dfe aus K\u00f6ln \u65e5\u672c\u8a9e \U0001f600 end";
+  refstrw1 = L"Some.Movie.1999.1080p.BluRay.x264 - Gr\u00fc\u00dfe aus K\u00f6ln \u65e5\u672c\u8a9e \U0001f600 end";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false, false, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+
+  varstra1.clear();
+  g_charsetConverter.wToUTF8(varstrw1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToUtf32_invalid)
+{
+  // invalid sequences are still skipped like before
+  std::u32string utf32;
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32("abc\xff" "def", utf32, false));
+  EXPECT_TRUE(utf32 == U"abcdef");
+
+  EXPECT_FALSE(g_charsetConverter.utf8ToUtf32("abc\xff" "def", utf32, true));
+}
 
 //TEST_F(TestCharsetConverter, utf16LEtoW)
 //{
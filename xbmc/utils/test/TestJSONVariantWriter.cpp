@@ -161,3 +161,33 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, StreamWriterMatchesWrite)
+{
+  CVariant element(CVariant::VariantTypeObject);
+  element["foo"] = "bar";
+
+  CVariant variant(CVariant::VariantTypeObject);
+  variant["items"].push_back(element);
+  variant["items"].push_back(element);
+  variant["total"] = 2;
+
+  for (bool compact : { false, true })
+  {
+    std::string str;
+    ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, compact));
+
+    CJSONStreamWriter writer(compact);
+    ASSERT_TRUE(writer.StartObject());
+    ASSERT_TRUE(writer.Key("items"));
+    ASSERT_TRUE(writer.StartArray());
+    ASSERT_TRUE(writer.Write(element));
+    ASSERT_TRUE(writer.Write(element));
+    ASSERT_TRUE(writer.EndArray());
+    ASSERT_TRUE(writer.Key("total"));
+    ASSERT_TRUE(writer.Write(CVariant(2)));
+    ASSERT_TRUE(writer.EndObject());
+    ASSERT_TRUE(writer.IsComplete());
+    ASSERT_STREQ(str.c_str(), writer.GetOutput().c_str());
+  }
+}
@@ -21,10 +21,55 @@
 #include "ServiceBroker.h"
 #include "utils/JobManager.h"
 #include "settings/Settings.h"
+#include "utils/StringUtils.h"
 #include "utils/SystemInfo.h"
 
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+namespace
+{
+// counts how many of its kind run at once, and blocks until released
+class GatedJob : public CJob
+{
+public:
+  struct Gate
+  {
+    Gate() : running(0), maxRunning(0), done(0), open(false) {}
+    std::atomic<int> running;
+    std::atomic<int> maxRunning;
+    std::atomic<int> done;
+    std::atomic<bool> open;
+  };
+
+  GatedJob(Gate &gate) : m_gate(gate) {}
+
+  const char *GetType() const override { return "GatedJob"; }
+
+  bool DoWork() override
+  {
+    const int running = ++m_gate.running;
+    int maxRunning = m_gate.maxRunning;
+    while (running > maxRunning && !m_gate.maxRunning.compare_exchange_weak(maxRunning, running))
+      ;
+    while (!m_gate.open)
+      XbmcThreads::ThreadSleep(1);
+    --m_gate.running;
+    ++m_gate.done;
+    return true;
+  }
+
+private:
+  Gate &m_gate;
+};
+}
+
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
 class TestJobManager : public testing::Test
 {
@@ -51,10 +96,15 @@ protected:
   ~TestJobManager()
   {
     /* Always cancel jobs test completion */
+    gate.open = true;
     CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().SetWorkStealing(false);
+    CJobManager::GetInstance().SetMaxWorkers(5);
     CJobManager::GetInstance().Restart();
     CServiceBroker::GetSettings().Unload();
   }
+
+  GatedJob::Gate gate; ///< opened before the jobs are cancelled, even if a test fails
 };
 
 TEST_F(TestJobManager, AddJob)
@@ -179,3 +229,231 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, WorkStealingPauseLowPriorityJob)
+{
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_LOW_PAUSABLE, package));
+
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+  EXPECT_EQ(1, CJobManager::GetInstance().IsProcessing("BroadcastingJob"));
+  CJobManager::GetInstance().PauseJobs();
+  EXPECT_FALSE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW_PAUSABLE));
+
+  job->FinishAndStopBlocking();
+}
+
+namespace
+{
+class FlagJob : public CJob
+{
+public:
+  FlagJob(std::atomic<bool> &ran, std::atomic<bool> *deleted = NULL)
+    : m_ran(ran), m_deleted(deleted) {}
+  ~FlagJob() override
+  {
+    if (m_deleted)
+      *m_deleted = true;
+  }
+
+  const char *GetType() const override { return "FlagJob"; }
+
+  bool DoWork() override
+  {
+    m_ran = true;
+    return true;
+  }
+
+private:
+  std::atomic<bool> &m_ran;
+  std::atomic<bool> *m_deleted;
+};
+
+// queues a job on its own worker and waits for another worker to steal it
+class ParentJob : public CJob
+{
+public:
+  ParentJob(std::atomic<bool> &stolen, std::atomic<bool> &done)
+    : m_stolen(stolen), m_done(done) {}
+
+  const char *GetType() const override { return "ParentJob"; }
+
+  bool DoWork() override
+  {
+    std::atomic<bool> childRan(false);
+    CJobManager::GetInstance().AddJob(new FlagJob(childRan), NULL, CJob::PRIORITY_HIGH);
+    const unsigned int start = XbmcThreads::SystemClockMillis();
+    while (!childRan && XbmcThreads::SystemClockMillis() - start < 10000)
+      XbmcThreads::ThreadSleep(1);
+    m_stolen = childRan.load();
+    m_done = true;
+    return true;
+  }
+
+private:
+  std::atomic<bool> &m_stolen;
+  std::atomic<bool> &m_done;
+};
+
+template<typename Predicate>
+bool WaitFor(Predicate predicate)
+{
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  while (!predicate())
+  {
+    if (XbmcThreads::SystemClockMillis() - start > 10000)
+      return false;
+    XbmcThreads::ThreadSleep(1);
+  }
+  return true;
+}
+}
+
+TEST_F(TestJobManager, WorkStealingMaxWorkers)
+{
+  CJobManager::GetInstance().SetMaxWorkers(2);
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  for (int i = 0; i < 4; i++)
+    CJobManager::GetInstance().AddJob(new GatedJob(gate), NULL, CJob::PRIORITY_HIGH);
+
+  // two start, the others wait for them even with idle workers of former tests around
+  ASSERT_TRUE(WaitFor([this]() { return gate.running == 2; }));
+  XbmcThreads::ThreadSleep(50);
+  EXPECT_EQ(2, CJobManager::GetInstance().IsProcessing("GatedJob"));
+
+  gate.open = true;
+  ASSERT_TRUE(WaitFor([this]() { return gate.done == 4; }));
+  EXPECT_EQ(2, gate.maxRunning);
+}
+
+TEST_F(TestJobManager, SharedQueueIgnoresMaxWorkers)
+{
+  // the cap only applies to work-stealing mode, the shared queue keeps its 5 workers
+  CJobManager::GetInstance().SetMaxWorkers(2);
+  EXPECT_EQ(2U, CJobManager::GetInstance().GetMaxWorkers());
+
+  // one at a time, so every job finds a worker started or woken for it
+  for (int i = 0; i < 5; i++)
+  {
+    CJobManager::GetInstance().AddJob(new GatedJob(gate), NULL, CJob::PRIORITY_HIGH);
+    ASSERT_TRUE(WaitFor([this, i]() { return gate.running == i + 1; }));
+  }
+  CJobManager::GetInstance().AddJob(new GatedJob(gate), NULL, CJob::PRIORITY_HIGH);
+  XbmcThreads::ThreadSleep(50);
+  EXPECT_EQ(5, gate.running);
+
+  gate.open = true;
+  ASSERT_TRUE(WaitFor([this]() { return gate.done == 6; }));
+  EXPECT_EQ(5, gate.maxRunning);
+}
+
+TEST_F(TestJobManager, WorkStealingSteal)
+{
+  CJobManager::GetInstance().SetMaxWorkers(2);
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  // get a worker going on both slots, they idle afterwards
+  std::atomic<bool> first(false), second(false);
+  CJobManager::GetInstance().AddJob(new FlagJob(first), NULL, CJob::PRIORITY_HIGH);
+  CJobManager::GetInstance().AddJob(new FlagJob(second), NULL, CJob::PRIORITY_HIGH);
+  ASSERT_TRUE(WaitFor([&first, &second]() { return first && second; }));
+
+  // a job queued by a job lands on the busy worker's own queue, only a thief
+  // can run it. PRIORITY_HIGH has both workers, lower priorities one less.
+  std::atomic<bool> stolen(false), done(false);
+  CJobManager::GetInstance().AddJob(new ParentJob(stolen, done), NULL, CJob::PRIORITY_HIGH);
+  ASSERT_TRUE(WaitFor([&done]() { return done.load(); }));
+  EXPECT_TRUE(stolen);
+}
+
+TEST_F(TestJobManager, WorkStealingCancelQueuedJob)
+{
+  CJobManager::GetInstance().SetMaxWorkers(1);
+  CJobManager::GetInstance().SetWorkStealing(true);
+
+  // with the only worker busy the next job stays queued
+  JobControlPackage package;
+  BroadcastingJob *job(WaitForJobToStartProcessing(CJob::PRIORITY_NORMAL, package));
+
+  std::atomic<bool> ran(false), deleted(false);
+  unsigned int id = CJobManager::GetInstance().AddJob(new FlagJob(ran, &deleted), NULL, CJob::PRIORITY_NORMAL);
+  ASSERT_NE(0U, id);
+  CJobManager::GetInstance().CancelJob(id);
+  EXPECT_TRUE(deleted);
+
+  // a job queued behind it runs, the cancelled one never does
+  job->FinishAndStopBlocking();
+  std::atomic<bool> next(false);
+  CJobManager::GetInstance().AddJob(new FlagJob(next), NULL, CJob::PRIORITY_NORMAL);
+  ASSERT_TRUE(WaitFor([&next]() { return next.load(); }));
+  EXPECT_FALSE(ran);
+}
+
+namespace
+{
+typedef std::chrono::steady_clock BenchClock;
+
+class LatencyJob : public CJob
+{
+public:
+  LatencyJob(std::atomic<int> &done, int64_t &latency)
+    : m_done(done), m_latency(latency), m_queued(BenchClock::now()) {}
+
+  const char *GetType() const override { return "LatencyJob"; }
+
+  bool DoWork() override
+  {
+    m_latency = std::chrono::duration_cast<std::chrono::microseconds>(BenchClock::now() - m_queued).count();
+    ++m_done;
+    return true;
+  }
+
+private:
+  std::atomic<int> &m_done;
+  int64_t &m_latency;
+  BenchClock::time_point m_queued;
+};
+
+void RunJobBenchmark(bool workStealing, unsigned int workers)
+{
+  static const int jobs = 100000;
+
+  CJobManager::GetInstance().SetMaxWorkers(workers);
+  CJobManager::GetInstance().SetWorkStealing(workStealing);
+
+  std::atomic<int> done(0);
+  std::vector<int64_t> latency(jobs, 0);
+
+  BenchClock::time_point start = BenchClock::now();
+  for (int i = 0; i < jobs; i++)
+    CJobManager::GetInstance().AddJob(new LatencyJob(done, latency[i]), NULL, CJob::PRIORITY_NORMAL);
+  while (done < jobs)
+    XbmcThreads::ThreadSleep(1);
+  double seconds = std::chrono::duration<double>(BenchClock::now() - start).count();
+
+  std::sort(latency.begin(), latency.end());
+  // the numbers end up in the report written by --gtest_output=xml
+  const std::string prefix = StringUtils::Format("%s_%u", workStealing ? "stealing" : "legacy", workers);
+  testing::Test::RecordProperty(prefix + "_jobs_per_second", static_cast<int>(jobs / seconds));
+  testing::Test::RecordProperty(prefix + "_latency_p50_us", static_cast<int>(latency[jobs / 2]));
+  testing::Test::RecordProperty(prefix + "_latency_p99_us", static_cast<int>(latency[jobs * 99 / 100]));
+
+  CJobManager::GetInstance().CancelJobs();
+  CJobManager::GetInstance().Restart();
+}
+}
+
+/* Not a functional test, run with --gtest_also_run_disabled_tests */
+TEST_F(TestJobManager, DISABLED_Benchmark)
+{
+  // the shared queue has a fixed number of workers
+  RunJobBenchmark(false, 5);
+  static const unsigned int workers[] = { 1, 4, 16 };
+  for (unsigned int count : workers)
+    RunJobBenchmark(true, count);
+}
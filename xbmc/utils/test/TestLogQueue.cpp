@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LogQueue.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestLogQueue, PushPop)
+{
+  CLogQueue queue(4);
+  CLogQueue::Entry entry;
+
+  EXPECT_EQ(4U, queue.GetCapacity());
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.TryPop(entry));
+
+  for (int i = 0; i < 4; i++)
+  {
+    entry.level = i;
+    entry.line = "line " + std::to_string(i);
+    EXPECT_TRUE(queue.TryPush(entry));
+    EXPECT_TRUE(entry.line.empty());
+  }
+
+  entry.line = "overflow";
+  EXPECT_FALSE(queue.TryPush(entry));
+  EXPECT_EQ("overflow", entry.line);
+  EXPECT_FALSE(queue.IsEmpty());
+
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.TryPop(entry));
+    EXPECT_EQ(i, entry.level);
+    EXPECT_EQ("line " + std::to_string(i), entry.line);
+  }
+  EXPECT_FALSE(queue.TryPop(entry));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TestLogQueue, MultipleProducers)
+{
+  static const int producers = 4;
+  static const int linesPerProducer = 20000;
+
+  CLogQueue queue(64);
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&queue, p]()
+    {
+      CLogQueue::Entry entry;
+      for (int i = 0; i < linesPerProducer; i++)
+      {
+        entry.level = p;
+        entry.line = std::to_string(i);
+        while (!queue.TryPush(entry))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // every producer's lines have to arrive complete and in order
+  std::vector<int> next(producers, 0);
+  CLogQueue::Entry entry;
+  int received = 0;
+  while (received < producers * linesPerProducer)
+  {
+    if (!queue.TryPop(entry))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_LE(0, entry.level);
+    ASSERT_GT(producers, entry.level);
+    EXPECT_EQ(std::to_string(next[entry.level]), entry.line);
+    next[entry.level]++;
+    received++;
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_TRUE(queue.IsEmpty());
+  for (int p = 0; p < producers; p++)
+    EXPECT_EQ(linesPerProducer, next[p]);
+}
@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2017 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/PerformanceTrace.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+class TestPerformanceTrace : public testing::Test
+{
+protected:
+  TestPerformanceTrace()
+  {
+    CPerformanceTrace::GetInstance().Clear();
+  }
+
+  ~TestPerformanceTrace()
+  {
+    CPerformanceTrace::GetInstance().Stop();
+    CPerformanceTrace::GetInstance().Clear();
+  }
+
+  static int CountEvents(const CVariant& trace, const std::string& name)
+  {
+    int count = 0;
+    for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+    {
+      if ((*it)["ph"].asString() == "X" && (*it)["name"].asString() == name)
+        count++;
+    }
+    return count;
+  }
+};
+
+TEST_F(TestPerformanceTrace, Disabled)
+{
+  {
+    TRACE_SCOPE("test", "disabled");
+  }
+
+  CVariant trace;
+  ASSERT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::GetInstance().GetTraceJSON(), trace));
+  EXPECT_EQ(0, CountEvents(trace, "disabled"));
+}
+
+TEST_F(TestPerformanceTrace, Scopes)
+{
+  CPerformanceTrace::GetInstance().Start();
+  {
+    TRACE_SCOPE("test", "outer");
+    TRACE_SCOPE("test", "inner");
+  }
+  std::thread other([]() { TRACE_SCOPE("test", "other"); });
+  other.join();
+  CPerformanceTrace::GetInstance().Stop();
+
+  CVariant trace;
+  ASSERT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::GetInstance().GetTraceJSON(), trace));
+  EXPECT_EQ(1, CountEvents(trace, "outer"));
+  EXPECT_EQ(1, CountEvents(trace, "inner"));
+  EXPECT_EQ(1, CountEvents(trace, "other"));
+
+  CPerformanceTrace::GetInstance().Clear();
+  ASSERT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::GetInstance().GetTraceJSON(), trace));
+  EXPECT_EQ(0, CountEvents(trace, "outer"));
+}
+
+TEST_F(TestPerformanceTrace, RingBufferWraps)
+{
+  CPerformanceTrace::GetInstance().Start();
+  for (unsigned int i = 0; i < CPerformanceTrace::EVENTS_PER_THREAD + 100; i++)
+  {
+    TRACE_SCOPE("test", "wrap");
+  }
+  CPerformanceTrace::GetInstance().Stop();
+
+  CVariant trace;
+  ASSERT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::GetInstance().GetTraceJSON(), trace));
+  EXPECT_EQ(static_cast<int>(CPerformanceTrace::EVENTS_PER_THREAD), CountEvents(trace, "wrap"));
+}
+
+TEST_F(TestPerformanceTrace, EscapesNames)
+{
+  static const std::string longName(1000, 'x');
+
+  CPerformanceTrace::GetInstance().Start();
+  {
+    TRACE_SCOPE("test \"quoted\"", "back\\slash\tand\nnewline");
+    TRACE_SCOPE("test", longName.c_str());
+  }
+  CPerformanceTrace::GetInstance().Stop();
+
+  CVariant trace;
+  ASSERT_TRUE(CJSONVariantParser::Parse(CPerformanceTrace::GetInstance().GetTraceJSON(), trace));
+  EXPECT_EQ(1, CountEvents(trace, "back\\slash\tand\nnewline"));
+  EXPECT_EQ(1, CountEvents(trace, longName));
+}
@@ -21,6 +21,8 @@
 #include "utils/SortUtils.h"
 #include "utils/Variant.h"
 
+#include <string>
+
 #include "gtest/gtest.h"
 
 TEST(TestSortUtils, Sort_SortBy)
@@ -115,6 +117,58 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", (*items.at(6))[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_Limits)
+{
+  DatabaseResults items;
+  for (int i = 0; i < 100; i++)
+  {
+    DatabaseResult item;
+    item[FieldLabel] = "Item " + std::to_string((i * 37) % 100);
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items, 15, 10);
+
+  ASSERT_EQ(5U, items.size());
+  EXPECT_STREQ("Item 89", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("Item 85", items.at(4)[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_Stable)
+{
+  // enough items to sort in parallel on machines with several cores
+  DatabaseResults items;
+  for (int i = 0; i < 50000; i++)
+  {
+    DatabaseResult item;
+    item[FieldId] = i;
+    item[FieldLabel] = "Item " + std::to_string(i % 1000);
+    item[FieldFolder] = i % 3 == 0;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  ASSERT_EQ(50000U, items.size());
+  for (size_t i = 1; i < items.size(); i++)
+  {
+    const DatabaseResult &previous = items[i - 1];
+    const DatabaseResult &current = items[i];
+    // folders first, then by label, items with the same label keep their order
+    if (previous.at(FieldFolder).asBoolean() != current.at(FieldFolder).asBoolean())
+    {
+      EXPECT_TRUE(previous.at(FieldFolder).asBoolean());
+      continue;
+    }
+    const int64_t previousId = previous.at(FieldId).asInteger();
+    const int64_t currentId = current.at(FieldId).asInteger();
+    if (previousId % 1000 == currentId % 1000)
+      ASSERT_LT(previousId, currentId);
+    else
+      ASSERT_LT(previousId % 1000, currentId % 1000);
+  }
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
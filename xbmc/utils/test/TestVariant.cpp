@@ -285,6 +285,30 @@ TEST(TestVariant, iterator_map)
   }
 }
 
+TEST(TestVariant, iterator_map_sorted)
+{
+  // members are iterated in key order whatever order they were added in,
+  // both below and above the size where lookups switch to a binary search
+  for (int count : { 5, 50 })
+  {
+    CVariant a;
+    for (int i = count - 1; i >= 0; i--)
+      a["key" + std::to_string(1000 + i * 7 % count)] = i;
+
+    EXPECT_EQ(static_cast<unsigned int>(count), a.size());
+    std::string previous;
+    for (CVariant::const_iterator_map it = a.begin_map(); it != a.end_map(); ++it)
+    {
+      EXPECT_LT(previous, it->first);
+      EXPECT_TRUE(a.isMember(it->first));
+      EXPECT_EQ(it->second.asInteger(), a[it->first].asInteger());
+      previous = it->first;
+    }
+    EXPECT_FALSE(a.isMember("key"));
+    EXPECT_FALSE(a.isMember("key9999"));
+  }
+}
+
 TEST(TestVariant, size)
 {
   std::vector<std::string> strarray;
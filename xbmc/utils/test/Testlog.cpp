@@ -18,7 +18,12 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
+
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "filesystem/File.h"
@@ -151,3 +156,78 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+// Run with --gtest_also_run_disabled_tests to compare the synchronous
+// writer with the background writer thread.
+static void LogBenchmark(const char* name, bool async, bool drop)
+{
+  static const int threads = 4;
+  static const int linesPerThread = 20000;
+
+  CLog::SetAsyncWriting(async);
+  CLog::SetDropOnOverflow(drop);
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/").c_str()));
+  const uint64_t droppedBefore = CLog::GetDroppedLineCount();
+
+  std::vector<std::vector<int64_t>> latencies(threads);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; t++)
+  {
+    workers.emplace_back([t, &latencies]()
+    {
+      std::vector<int64_t>& samples = latencies[t];
+      samples.reserve(linesPerThread);
+      for (int i = 0; i < linesPerThread; i++)
+      {
+        auto before = std::chrono::steady_clock::now();
+        CLog::Log(LOGDEBUG, "benchmark line %d from worker %d with some payload %s", i, t, "0123456789abcdef");
+        samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count());
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  auto logged = std::chrono::steady_clock::now();
+  CLog::Close();
+  auto closed = std::chrono::steady_clock::now();
+
+  std::vector<int64_t> all;
+  for (auto& samples : latencies)
+    all.insert(all.end(), samples.begin(), samples.end());
+  std::sort(all.begin(), all.end());
+
+  // the numbers end up in the report written by --gtest_output=xml
+  const std::string prefix(name);
+  const double seconds = std::chrono::duration<double>(logged - start).count();
+  testing::Test::RecordProperty(prefix + "_lines_per_second", static_cast<int>(all.size() / seconds));
+  testing::Test::RecordProperty(prefix + "_p50_ns", static_cast<int>(all[all.size() / 2]));
+  testing::Test::RecordProperty(prefix + "_p99_ns", static_cast<int>(all[all.size() * 99 / 100]));
+  testing::Test::RecordProperty(prefix + "_p999_ns", static_cast<int>(all[all.size() * 999 / 1000]));
+  testing::Test::RecordProperty(prefix + "_max_ns", static_cast<int>(all.back()));
+  testing::Test::RecordProperty(prefix + "_close_ms",
+                                static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(closed - logged).count()));
+  const uint64_t dropped = CLog::GetDroppedLineCount() - droppedBefore;
+  testing::Test::RecordProperty(prefix + "_dropped", static_cast<int>(dropped));
+  // braces, EXPECT_EQ expands to an if/else
+  if (!drop)
+  {
+    EXPECT_EQ(0U, dropped);
+  }
+
+  CLog::SetAsyncWriting(true);
+  CLog::SetDropOnOverflow(false);
+}
+
+TEST_F(Testlog, DISABLED_Benchmark)
+{
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  std::string logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+
+  LogBenchmark("sync", false, false);
+  LogBenchmark("async_blocking", true, false);
+  LogBenchmark("async_dropping", true, true);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
@@ -19,6 +19,7 @@
  *
  */
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <utility>
@@ -951,6 +952,15 @@ private:
    */
   int RunQuery(const std::string &sql);
 
+  /*! \brief Run a query on the main dataset as a forward only cursor
+   Each row is handed to addRow while it is read, so the result set is never
+   held in memory as a whole. The dataset is closed afterwards.
+   \param sql the sql query to run
+   \param addRow called for every returned row
+   \return the number of rows, -1 for an error.
+   */
+  int RunQueryCursor(const std::string &sql, const std::function<void(const dbiplus::sql_record* const)> &addRow);
+
   void AppendIdLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
   void AppendLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
 
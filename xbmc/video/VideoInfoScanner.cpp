@@ -30,6 +30,7 @@
 #include "events/MediaLibraryEvent.h"
 #include "FileItem.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/StackDirectory.h"
@@ -115,6 +116,8 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      m_fingerprintDatabase.Open();
+      m_fingerprintStats = SFingerprintStats();
 
       m_bCanInterrupt = true;
 
@@ -171,10 +174,13 @@ namespace VIDEO
       }
 
       g_infoManager.ResetLibraryBools();
+      m_fingerprintDatabase.Close();
       m_database.Close();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Files in changed folders: %u added, %u modified, %u removed, %u unchanged and skipped",
+                m_fingerprintStats.added, m_fingerprintStats.modified, m_fingerprintStats.removed, m_fingerprintStats.unchanged);
     }
     catch (...)
     {
@@ -242,6 +248,26 @@ namespace VIDEO
   }
 
   bool CVideoInfoScanner::DoScan(const std::string& strDirectory)
+  {
+    // list the tree with several connections while the folders are scanned
+    // one by one in the order a recursive walk would visit them. Whether to
+    // recurse depends on the scraper settings of each folder, so the
+    // subfolders are handed to the walker once their parent was scanned.
+    CDirectoryWalker walker(g_advancedSettings.m_videoExtensions);
+    walker.Start(strDirectory);
+
+    std::string directory;
+    CFileItemList items;
+    while (!m_bStop && walker.Next(directory, items))
+    {
+      std::vector<std::string> subDirectories;
+      ScanDirectory(directory, items, subDirectories);
+      walker.AddChildren(subDirectories);
+    }
+    return !m_bStop;
+  }
+
+  void CVideoInfoScanner::ScanDirectory(const std::string& strDirectory, const CFileItemList& listing, std::vector<std::string>& subDirectories)
   {
     if (m_handle)
     {
@@ -271,11 +297,11 @@ namespace VIDEO
                                                          : g_advancedSettings.m_moviesExcludeFromScanRegExps;
 
     if (IsExcluded(strDirectory, regexps))
-      return true;
+      return;
 
     bool ignoreFolder = !m_scanAll && settings.noupdate;
     if (content == CONTENT_NONE || ignoreFolder)
-      return true;
+      return;
 
     std::string hash, dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
@@ -295,8 +321,8 @@ namespace VIDEO
         hash = fastHash;
       }
       else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+      { // need the listing of the folder
+        items.Assign(listing);
         items.Stack();
 
         // check whether to re-use previously computed fast hash
@@ -334,7 +360,7 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+        items.Assign(listing);
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -355,7 +381,37 @@ namespace VIDEO
 
     if (!bSkip)
     {
-      if (RetrieveVideoInfo(items, settings.parent_name_root, content))
+      // only the files that changed since the last scan are looked at again
+      FingerprintMap current, fingerprints;
+      if (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS)
+      {
+        if (dbHash.empty())
+        {
+          std::set<std::string> unchanged;
+          m_fingerprintStats += CFingerprintDatabase::Compare(FingerprintMap(), items, current, unchanged);
+        }
+        else
+          RemoveUnchangedFiles(strDirectory, items, current, fingerprints);
+      }
+
+      bool found = RetrieveVideoInfo(items, settings.parent_name_root, content);
+      if (!m_bStop && !current.empty())
+      {
+        // remember the files that made it into the library, the others are tried again next time
+        for (const auto& it : current)
+        {
+          if (fingerprints.find(it.first) == fingerprints.end() &&
+              (content == CONTENT_MOVIES ? m_database.HasMovieInfo(it.first) : m_database.HasMusicVideoInfo(it.first)))
+            fingerprints.insert(it);
+        }
+        m_fingerprintDatabase.SetFingerprints("video", strDirectory, fingerprints);
+
+        // unchanged files are in the library already
+        if (!fingerprints.empty())
+          found = true;
+      }
+
+      if (found)
       {
         if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
         {
@@ -384,20 +440,34 @@ namespace VIDEO
     {
       CFileItemPtr pItem = items[i];
 
-      if (m_bStop)
-        break;
-
       // if we have a directory item (non-playlist) we then recurse into that folder
       // do not recurse for tv shows - we have already looked recursively for episodes
       if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+        subDirectories.push_back(pItem->GetPath());
+    }
+  }
+
+  void CVideoInfoScanner::RemoveUnchangedFiles(const std::string& strDirectory, CFileItemList& items, FingerprintMap& current, FingerprintMap& unchanged)
+  {
+    FingerprintMap stored;
+    m_fingerprintDatabase.GetFingerprints("video", strDirectory, stored);
+
+    std::set<std::string> unchangedPaths;
+    SFingerprintStats stats = CFingerprintDatabase::Compare(stored, items, current, unchangedPaths);
+    m_fingerprintStats += stats;
+    if (unchangedPaths.empty())
+      return;
+
+    CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping %u unchanged files in dir '%s' (%u added, %u modified, %u removed)",
+              stats.unchanged, CURL::GetRedacted(strDirectory).c_str(), stats.added, stats.modified, stats.removed);
+    for (int i = items.Size() - 1; i >= 0; --i)
+    {
+      if (unchangedPaths.find(items[i]->GetPath()) != unchangedPaths.end())
       {
-        if (!DoScan(pItem->GetPath()))
-        {
-          m_bStop = true;
-        }
+        unchanged[items[i]->GetPath()] = current[items[i]->GetPath()];
+        items.Remove(i);
       }
     }
-    return !m_bStop;
   }
 
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "FingerprintDatabase.h"
 #include "InfoScanner.h"
 #include "NfoFile.h"
 #include "VideoDatabase.h"
@@ -130,6 +131,13 @@ namespace VIDEO
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
 
+    /*! \brief Scan a single folder of the tree walked by DoScan()
+     \param strDirectory the folder
+     \param listing its listing
+     \param subDirectories [out] the subfolders to scan next
+     */
+    void ScanDirectory(const std::string& strDirectory, const CFileItemList& listing, std::vector<std::string>& subDirectories);
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -239,6 +247,14 @@ namespace VIDEO
 
     std::string GetnfoFile(CFileItem *item, bool bGrabAny=false) const;
 
+    /*! \brief Drop the files of a changed movie or music video folder that did not change since the last scan.
+     \param strDirectory the folder
+     \param items the listing of the folder, unchanged files are removed from it
+     \param current [out] fingerprints of all files in the listing
+     \param unchanged [out] fingerprints of the removed files
+     */
+    void RemoveUnchangedFiles(const std::string& strDirectory, CFileItemList& items, FingerprintMap& current, FingerprintMap& unchanged);
+
     bool m_showDialog;
     CGUIDialogProgressBarHandle* m_handle;
     int m_currentItem;
@@ -250,6 +266,8 @@ namespace VIDEO
     bool m_scanAll;
     std::string m_strStartDir;
     CVideoDatabase m_database;
+    CFingerprintDatabase m_fingerprintDatabase;
+    SFingerprintStats m_fingerprintStats;
     std::set<std::string> m_pathsToScan;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
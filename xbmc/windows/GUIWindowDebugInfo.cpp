@@ -155,6 +155,7 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       if (control)
         info += StringUtils::Format("Focused: %i (%s)", control->GetID(), CGUIControlFactory::TranslateControlType(control->GetControlType()).c_str());
     }
+    info += StringUtils::Format("\nConditions evaluated: %u", g_infoManager.GetBoolEvaluations());
   }
 
   float w, h;